@@ -14,27 +14,725 @@
  * sections of the MSLA applicable to Source Code.
  *
  ******************************************************************************/
+#include <string.h>
 #include "em_common.h"
 #include "app_assert.h"
 #include "sl_bluetooth.h"
+#include "sl_sleeptimer.h"
 #include "gatt_db.h"
 #include "app.h"
 
 #include "le_voltage_monitor.h"
+#include "le_voltage_report.h"
+#include "le_voltage_log.h"
+#include "le_voltage_capture.h"
+#include "le_voltage_beacon.h"
+#include "le_conn_policy.h"
+#include "le_adv_scheduler.h"
+#include "le_energy_stats.h"
+#include "le_change_filter.h"
+#include "le_tx_queue.h"
+#include "le_bonding.h"
+#include "le_ota.h"
+#include "le_deep_sleep.h"
+#include "le_periodic_adv.h"
+#include "le_relay.h"
+#include "le_retransmit.h"
+#include "le_time_sync.h"
+#include "le_trace.h"
+#include "le_soak.h"
+#include "le_memory_stats.h"
+
+// Beacons publish window averages, the alarm mode has no windows
+#if LE_VOLTAGE_BEACON_ENABLE && LE_VOLTAGE_MONITOR_ALARM_ENABLE
+#error "The beacon mode needs the periodic windows"
+#endif
+
+#if LE_DEEP_SLEEP_ENABLE && !LE_VOLTAGE_BEACON_ENABLE
+#error "The deep sleep mode reports through the beacon"
+#endif
+
+// The train publishes windows and is lost in EM4
+#if LE_PERIODIC_ADV_ENABLE && (LE_DEEP_SLEEP_ENABLE || LE_VOLTAGE_MONITOR_ALARM_ENABLE)
+#error "Periodic advertising needs the periodic windows, without deep sleep"
+#endif
+
+// The relay reports to connected gateways
+#if LE_RELAY_ENABLE && LE_VOLTAGE_BEACON_ENABLE
+#error "The relay needs the connectable mode"
+#endif
+
+// The windows follow a time source while sampling runs on
+#if LE_TIME_SYNC_ENABLE && (LE_DEEP_SLEEP_ENABLE || LE_VOLTAGE_MONITOR_ALARM_ENABLE)
+#error "The time synchronization needs the periodic windows, without deep sleep"
+#endif
+
+// Sealed beacons must not be repeated in the clear
+#if LE_PERIODIC_ADV_ENABLE && LE_VOLTAGE_BEACON_ENABLE && LE_VOLTAGE_BEACON_SEAL_ENABLE
+#error "The periodic advertising train is not sealed"
+#endif
+
+#if LE_DEEP_SLEEP_ENABLE
+// Backup RAM word holding the beacon sequence counter over EM4
+#define RETAINED_BEACON_SEQUENCE  0
+#endif
+
+// The log is downloaded over its own L2CAP channel
+#define LOG_CHANNEL  (LE_VOLTAGE_LOG_ENABLE && LE_VOLTAGE_LOG_CHANNEL_ENABLE)
 
 // The advertising set handle allocated from Bluetooth stack.
 static uint8_t advertising_set_handle = 0xff;
 
-static uint8_t connection_handle;
+// Connected client and its subscriptions
+typedef struct {
+  bool open;
+  uint8_t connection;
+  uint16_t mtu;
+#if LE_BONDING_ENABLE
+  bool bonded;              // Subscriptions are kept in the bonding data
+  bool restored;            // and have been restored on this connection
+#endif
+  bool notifying;           // Average Voltage notifications
+  bool extended_notifying;  // Extended Voltage Data notifications
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  bool alarm_indicating;    // Voltage Alarm indications
+  bool alarm_in_flight;     // An indication waits for its confirmation
+  bool alarm_pending;       // The state changed while one was in flight
+#endif
+#if LE_RELAY_ENABLE
+  bool relay_notifying;     // Neighbor Report notifications
+#endif
+} client_t;
+
+// One entry per connection, the windows are averaged once for all of them
+static client_t clients[SL_BT_CONFIG_MAX_CONNECTIONS];
+
+#if !LE_VOLTAGE_BEACON_ENABLE
+static uint8_t volt_buf[LE_VOLTAGE_REPORT_MAX_PAYLOAD] = {0};
+
+// The window the Extended Voltage Data is read from
+static le_voltage_monitor_summary_t last_summary;
+#endif
+
+/**************************************************************************//**
+ * Take a new connection into the client table.
+ *****************************************************************************/
+static void open_client(uint8_t connection)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(!clients[i].open) {
+      memset(&clients[i], 0, sizeof(clients[i]));
+      clients[i].open = true;
+      clients[i].connection = connection;
+      clients[i].mtu = LE_VOLTAGE_REPORT_DEFAULT_MTU;
+      return;
+    }
+  }
+}
 
-static uint8_t volt_buf[2] = {0};
+/**************************************************************************//**
+ * Find the client of a connection, NULL if it is not in the table.
+ *****************************************************************************/
+static client_t *find_client(uint8_t connection)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open && (clients[i].connection == connection)) {
+      return &clients[i];
+    }
+  }
+  return NULL;
+}
+
+/**************************************************************************//**
+ * Count the connected clients.
+ *****************************************************************************/
+static uint8_t count_clients(void)
+{
+  uint8_t count = 0;
+
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open) {
+      count++;
+    }
+  }
+  return count;
+}
+
+#if !LE_VOLTAGE_BEACON_ENABLE
+/**************************************************************************//**
+ * Check whether a client subscribed to the Average Voltage notifications.
+ *****************************************************************************/
+static bool any_notifying(void)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open && clients[i].notifying) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+#if !LE_VOLTAGE_LOG_ENABLE && !LE_VOLTAGE_MONITOR_ALARM_ENABLE
+/**************************************************************************//**
+ * Check whether a client subscribed to any window notification.
+ *****************************************************************************/
+static bool any_subscriber(void)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open
+       && (clients[i].notifying || clients[i].extended_notifying)) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+/**************************************************************************//**
+ * Size the batches for the smallest MTU of the Average Voltage subscribers.
+ *****************************************************************************/
+static void update_report_mtu(void)
+{
+  uint16_t mtu = 0;
+
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open && clients[i].notifying
+       && ((mtu == 0) || (clients[i].mtu < mtu))) {
+      mtu = clients[i].mtu;
+    }
+  }
+  le_voltage_report_set_mtu((mtu == 0) ? LE_VOLTAGE_REPORT_DEFAULT_MTU : mtu);
+}
+
+#if LE_ENERGY_STATS_ENABLE
+// Diagnostics value: the energy statistics, then the last and the largest
+// window reduction cycle count as big-endian uint32, then the IADC operating
+// point: warmup mode, CLK_ADC in kHz as big-endian uint16 and the charge per
+// trigger period in picocoulombs as big-endian uint32
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+#define DIAGNOSTICS_PROFILE_SIZE  8
+#else
+#define DIAGNOSTICS_PROFILE_SIZE  0
+#endif
+#define DIAGNOSTICS_SIZE  (LE_ENERGY_STATS_REPORT_SIZE + DIAGNOSTICS_PROFILE_SIZE + 7)
+
+/**************************************************************************//**
+ * Build the Diagnostics value.
+ *****************************************************************************/
+static size_t build_diagnostics(uint8_t *buf)
+{
+  size_t len = le_energy_stats_build(buf, LE_ENERGY_STATS_REPORT_SIZE);
+
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+  uint32_t cycles[2];
+
+  le_voltage_monitor_get_profile(&cycles[0], &cycles[1]);
+  for(uint32_t i = 0; i < 2; i++) {
+    buf[len++] = (cycles[i] >> 24) & 0x00FF;
+    buf[len++] = (cycles[i] >> 16) & 0x00FF;
+    buf[len++] = (cycles[i] >> 8) & 0x00FF;
+    buf[len++] = cycles[i] & 0x00FF;
+  }
+#endif
+
+  le_voltage_monitor_operating_point_t point;
+  uint16_t clk_adc_khz;
+
+  le_voltage_monitor_get_operating_point(&point);
+  clk_adc_khz = (uint16_t)(point.clk_adc_hz / 1000);
+  buf[len++] = point.warmup;
+  buf[len++] = (clk_adc_khz >> 8) & 0x00FF;
+  buf[len++] = clk_adc_khz & 0x00FF;
+  buf[len++] = (point.charge_pc >> 24) & 0x00FF;
+  buf[len++] = (point.charge_pc >> 16) & 0x00FF;
+  buf[len++] = (point.charge_pc >> 8) & 0x00FF;
+  buf[len++] = point.charge_pc & 0x00FF;
+  return len;
+}
+#endif
+
+// Values longer than an ATT_MTU of 23, read in parts by the client
+#define LONG_READS  (LE_ENERGY_STATS_ENABLE || LE_TRACE_ENABLE || LE_MEMORY_STATS_ENABLE \
+                    || LE_SOAK_ENABLE)
+
+#if LONG_READS
+typedef union {
+#if LE_ENERGY_STATS_ENABLE
+  uint8_t diagnostics[DIAGNOSTICS_SIZE];
+#endif
+#if LE_TRACE_ENABLE
+  uint8_t trace[LE_TRACE_VALUE_SIZE];
+#endif
+#if LE_MEMORY_STATS_ENABLE
+  uint8_t memory_budget[LE_MEMORY_STATS_VALUE_SIZE];
+#endif
+#if LE_SOAK_ENABLE
+  uint8_t soak[LE_SOAK_VALUE_SIZE];
+#endif
+} long_read_value_t;
+
+typedef size_t (*long_read_build_t)(uint8_t *buf);
+
+// Snapshot the parts of a long read are served from
+static uint8_t long_read_buf[sizeof(long_read_value_t)];
+static size_t long_read_len = 0;
+static uint8_t long_read_connection = 0xff;
+static uint16_t long_read_characteristic = 0;
+
+/**************************************************************************//**
+ * Respond to a part of a long read. The value is built for the first part,
+ * the later ones are taken from that snapshot so the client reassembles one
+ * consistent value.
+ *****************************************************************************/
+static sl_status_t send_long_read(uint8_t connection,
+                                  uint16_t characteristic,
+                                  uint16_t offset,
+                                  long_read_build_t build)
+{
+  // Rebuilt as well if another value was read in between
+  if((offset == 0)
+     || (connection != long_read_connection)
+     || (characteristic != long_read_characteristic)) {
+    long_read_len = build(long_read_buf);
+    long_read_connection = connection;
+    long_read_characteristic = characteristic;
+  }
+
+  if(offset > long_read_len) {
+    return sl_bt_gatt_server_send_user_read_response(connection,
+                                                     characteristic,
+                                                     (uint8_t)SL_STATUS_BT_ATT_INVALID_OFFSET,
+                                                     0,
+                                                     NULL,
+                                                     NULL);
+  }
+  return sl_bt_gatt_server_send_user_read_response(connection,
+                                                   characteristic,
+                                                   0,
+                                                   long_read_len - offset,
+                                                   &long_read_buf[offset],
+                                                   NULL);
+}
+#endif
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+/**************************************************************************//**
+ * Build the Voltage Alarm value: state and big-endian voltage.
+ *****************************************************************************/
+static void build_alarm_value(uint8_t *buf)
+{
+  uint16_t mv;
+
+  buf[0] = le_voltage_monitor_get_alarm(&mv);
+  buf[1] = (mv >> 8) & 0x00FF;
+  buf[2] = mv & 0x00FF;
+}
+
+/**************************************************************************//**
+ * Indicate the current alarm state to a client, one indication at a time.
+ *****************************************************************************/
+static void send_alarm_indication(client_t *client)
+{
+  sl_status_t sc;
+  uint8_t alarm_buf[3];
+
+  if(!client->alarm_indicating) {
+    return;
+  }
+  if(client->alarm_in_flight) {
+    // Sent once the client confirms the previous one
+    client->alarm_pending = true;
+    return;
+  }
+
+  build_alarm_value(alarm_buf);
+  sc = sl_bt_gatt_server_send_indication(client->connection,
+                                         gattdb_voltage_alarm,
+                                         sizeof(alarm_buf),
+                                         alarm_buf);
+  if(sc == SL_STATUS_OK) {
+    client->alarm_in_flight = true;
+    client->alarm_pending = false;
+#if LE_ENERGY_STATS_ENABLE
+    le_energy_stats_record_notification();
+#endif
+  }
+}
+#endif
+
+/**************************************************************************//**
+ * Start the next measurements, unless sampling is suspended for an OTA update.
+ *****************************************************************************/
+static void start_sampling(void)
+{
+  if(!le_ota_in_progress()) {
+    le_voltage_monitor_start_next();
+  }
+}
+
+/**************************************************************************//**
+ * Resume sampling after a suspension, if anything needs the windows.
+ *****************************************************************************/
+static void resume_sampling(void)
+{
+#if LE_VOLTAGE_BEACON_ENABLE || LE_VOLTAGE_LOG_ENABLE || LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  le_voltage_monitor_start_next();
+#else
+  if(any_subscriber()) {
+    le_voltage_monitor_start_next();
+  }
+#endif
+}
+
+/**************************************************************************//**
+ * Suspend sampling when an OTA update starts, and resume it when the update
+ * is aborted.
+ *****************************************************************************/
+static void follow_ota(bool was_in_progress)
+{
+  if(!was_in_progress && le_ota_in_progress()) {
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+    // The update takes the radio, a capture would not be uploaded
+    le_voltage_capture_abort();
+#endif
+    le_voltage_monitor_stop();
+  } else if(was_in_progress && !le_ota_in_progress()) {
+    resume_sampling();
+  }
+}
+
+/**************************************************************************//**
+ * Subscribe a client to the Average Voltage notifications, or unsubscribe it.
+ *****************************************************************************/
+static void set_notifying(client_t *client, bool enabled)
+{
+  if(enabled) {
+    // Start sampling data, the new subscriber gets the next window
+    client->notifying = true;
+#if LE_CHANGE_FILTER_ENABLE
+    le_change_filter_restart();
+#endif
+    start_sampling();
+  } else {
+    client->notifying = false;
+#if !LE_VOLTAGE_LOG_ENABLE && !LE_VOLTAGE_MONITOR_ALARM_ENABLE
+    // Sample until the last subscriber left
+    if(!any_subscriber()) {
+      le_voltage_monitor_stop();
+    }
+#endif
+  }
+  update_report_mtu();
+}
+
+#if !LE_VOLTAGE_BEACON_ENABLE
+/**************************************************************************//**
+ * Subscribe a client to the Extended Voltage Data notifications, or
+ * unsubscribe it. They are sampled like the averages.
+ *****************************************************************************/
+static void set_extended_notifying(client_t *client, bool enabled)
+{
+  client->extended_notifying = enabled;
+  if(enabled) {
+    start_sampling();
+  }
+#if !LE_VOLTAGE_LOG_ENABLE && !LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  else if(!any_subscriber()) {
+    le_voltage_monitor_stop();
+  }
+#endif
+}
+#endif
+
+#if LE_BONDING_ENABLE
+/**************************************************************************//**
+ * Restore the subscriptions a bonded client left in its bonding data, without
+ * waiting for it to write the CCCDs again.
+ *****************************************************************************/
+static void restore_subscriptions(client_t *client)
+{
+  uint16_t flags;
+
+  if(!client->bonded || client->restored) {
+    return;
+  }
+  client->restored = true;
+
+  if((sl_bt_gatt_server_read_client_configuration(client->connection,
+                                                  gattdb_avg_voltage_data,
+                                                  &flags) == SL_STATUS_OK)
+     && (flags != gatt_disable) && !client->notifying) {
+    set_notifying(client, true);
+  }
+#if !LE_VOLTAGE_BEACON_ENABLE
+  if((sl_bt_gatt_server_read_client_configuration(client->connection,
+                                                  gattdb_extended_voltage_data,
+                                                  &flags) == SL_STATUS_OK)
+     && (flags != gatt_disable) && !client->extended_notifying) {
+    set_extended_notifying(client, true);
+  }
+#endif
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  if((sl_bt_gatt_server_read_client_configuration(client->connection,
+                                                  gattdb_voltage_alarm,
+                                                  &flags) == SL_STATUS_OK)
+     && ((flags & gatt_indication) != 0) && !client->alarm_indicating) {
+    client->alarm_indicating = true;
+    send_alarm_indication(client);
+  }
+#endif
+}
+#endif
+
+#if !LE_VOLTAGE_BEACON_ENABLE
+/**************************************************************************//**
+ * Notify a window payload, through the transmit queue if enabled.
+ *****************************************************************************/
+static void send_notification(uint8_t connection,
+                              uint16_t characteristic,
+                              size_t len,
+                              const uint8_t *data)
+{
+#if LE_TX_QUEUE_ENABLE
+  sl_status_t sc = le_tx_queue_send(connection, characteristic, len, data);
+#else
+  sl_status_t sc = sl_bt_gatt_server_send_notification(connection,
+                                                       characteristic,
+                                                       len,
+                                                       data);
+#if LE_ENERGY_STATS_ENABLE
+  if(sc == SL_STATUS_OK) {
+    le_energy_stats_record_notification();
+  }
+#endif
+#endif
+#if LE_SOAK_ENABLE
+  le_soak_record_notification(sc == SL_STATUS_OK);
+#endif
+#if LE_TRACE_ENABLE
+  // End of the path of a window
+  if((sc == SL_STATUS_OK)
+     && ((characteristic == gattdb_avg_voltage_data)
+         || (characteristic == gattdb_extended_voltage_data))) {
+    le_trace_record(LE_TRACE_NOTIFIED);
+  }
+#endif
+  (void)sc;
+}
+
+/**************************************************************************//**
+ * Check for backpressure from the transmit queue.
+ *****************************************************************************/
+static bool congested(void)
+{
+#if LE_TX_QUEUE_ENABLE
+  return le_tx_queue_is_congested();
+#else
+  return false;
+#endif
+}
+
+#if LE_RELAY_ENABLE
+/**************************************************************************//**
+ * Notify the new neighbor readings, sized for the smallest MTU of the
+ * subscribers. Readings left over under backpressure go with the next ones.
+ *****************************************************************************/
+static void send_relay_reports(void)
+{
+  uint8_t relay_buf[LE_RELAY_REPORT_MAX_PAYLOAD];
+  uint16_t mtu = 0;
+
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(clients[i].open && clients[i].relay_notifying
+       && ((mtu == 0) || (clients[i].mtu < mtu))) {
+      mtu = clients[i].mtu;
+    }
+  }
+  if(mtu == 0) {
+    return;
+  }
+
+  while(!congested()) {
+    size_t size = ((size_t)(mtu - 3) < sizeof(relay_buf)) ? (size_t)(mtu - 3) : sizeof(relay_buf);
+    size_t len = le_relay_build(relay_buf, size);
+
+    if(len == 0) {
+      break;
+    }
+    for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+      if(clients[i].open && clients[i].relay_notifying) {
+        send_notification(clients[i].connection,
+                          gattdb_neighbor_report,
+                          len,
+                          relay_buf);
+      }
+    }
+  }
+}
+#endif
+
+/**************************************************************************//**
+ * Check whether the queued windows are to be notified now.
+ *****************************************************************************/
+static bool batch_ready(void)
+{
+  // Backpressure: hold the windows back until the transmit queue drained,
+  // they leave later in fuller batches
+  if(congested()) {
+    return false;
+  }
+#if LE_CHANGE_FILTER_ENABLE
+  // Changed windows are sent right away
+  return le_voltage_report_get_pending() > 0;
+#else
+  return le_voltage_report_ready();
+#endif
+}
+#endif
+
+/**************************************************************************//**
+ * Publish, notify or log a completed window.
+ *****************************************************************************/
+static void process_window(const le_voltage_monitor_summary_t *summary)
+{
+#if LE_TIME_SYNC_ENABLE
+  // Move the window in progress onto the time base first
+  le_time_sync_on_window(summary);
+#endif
+
+#if LE_ENERGY_STATS_ENABLE
+  le_energy_stats_record_window();
+#endif
+
+#if LE_PERIODIC_ADV_ENABLE
+  // Synchronized scanners get it in the next train event
+  (void)le_periodic_adv_update(summary);
+#endif
+
+#if LE_VOLTAGE_BEACON_ENABLE
+  // Publish it in the advertising data
+  (void)le_voltage_beacon_update(advertising_set_handle, summary);
+#if LE_DEEP_SLEEP_ENABLE
+  // One window per wake-up: keep the counter over EM4, power the acquisition
+  // down, and sleep once the report has been broadcast
+  le_deep_sleep_set_retained(RETAINED_BEACON_SEQUENCE,
+                             le_voltage_beacon_get_sequence());
+  le_voltage_monitor_stop();
+
+  sl_status_t sc = le_deep_sleep_broadcast(advertising_set_handle);
+  app_assert(sc == SL_STATUS_OK,
+              "[E: 0x%04x] Failed to broadcast the report\n",
+              (int)sc);
+#endif
+#else
+  // Notify the full statistics of every window. Skipped under backpressure,
+  // the clients can still read the latest one.
+  last_summary = *summary;
+#if LE_RETRANSMIT_ENABLE
+  // Kept whether sent or not, missed windows are requested by sequence number
+  le_retransmit_record(summary);
+#endif
+  if(!congested()) {
+    uint8_t extended_buf[LE_VOLTAGE_REPORT_EXTENDED_SIZE];
+    size_t len = le_voltage_report_build_extended(summary, extended_buf);
+
+    for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+      if(clients[i].open && clients[i].extended_notifying) {
+        send_notification(clients[i].connection,
+                          gattdb_extended_voltage_data,
+                          len,
+                          extended_buf);
+      }
+    }
+  }
+
+  if(any_notifying()) {
+#if LE_CHANGE_FILTER_ENABLE
+    // Queue changed windows only, drop the others
+    if(le_change_filter_check(summary->avg_mv)) {
+      (void)le_voltage_report_push(summary);
+    }
+#else
+    // Queue it, and notify connected user once a batch is complete
+    (void)le_voltage_report_push(summary);
+#endif
+    // Built once, sent to every subscriber
+    while(batch_ready()) {
+      le_voltage_report_clock_t clock = {
+        sl_sleeptimer_get_tick_count64(), sl_sleeptimer_get_timer_frequency()
+      };
+      size_t len = le_voltage_report_build(volt_buf, sizeof(volt_buf), &clock);
+      if(len == 0) {
+        break;
+      }
+      for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+        if(clients[i].open && clients[i].notifying) {
+          send_notification(clients[i].connection,
+                            gattdb_avg_voltage_data,
+                            len,
+                            volt_buf);
+        }
+      }
+    }
+  }
+#if LE_VOLTAGE_LOG_ENABLE
+  // Nobody is listening, store it
+  else {
+    le_voltage_log_push(summary);
+  }
+#endif
+#endif
+}
 
 /**************************************************************************//**
  * Application Init.
  *****************************************************************************/
 SL_WEAK void app_init(void)
 {
+#if LE_MEMORY_STATS_ENABLE
+  // Painting the stack while it is still shallow
+  le_memory_stats_init();
+#endif
+#if LE_TRACE_ENABLE
+  // Counting before the first window completes
+  le_trace_init();
+#endif
+#if LE_SOAK_ENABLE
+  le_soak_init();
+#endif
   le_voltage_monitor_init();
+  le_voltage_report_reset();
+#if LE_VOLTAGE_LOG_ENABLE
+  le_voltage_log_init();
+#endif
+#if LE_ENERGY_STATS_ENABLE
+  le_energy_stats_init();
+#endif
+#if LE_CHANGE_FILTER_ENABLE
+  le_change_filter_init();
+#endif
+#if LE_VOLTAGE_BEACON_ENABLE
+  // Key and frame counter reservation of sealed frames
+  sl_status_t beacon_sc = le_voltage_beacon_init();
+  app_assert(beacon_sc == SL_STATUS_OK,
+              "[E: 0x%04x] Failed to initialize beacon\n",
+              (int)beacon_sc);
+#endif
+#if LE_DEEP_SLEEP_ENABLE
+  // Continue the beacon sequence after an EM4 wake-up
+  if(le_deep_sleep_init()) {
+    le_voltage_beacon_set_sequence(
+      le_deep_sleep_get_retained(RETAINED_BEACON_SEQUENCE));
+  }
+
+  // A short burst per report
+  sl_status_t sc = le_voltage_monitor_set_config(LE_DEEP_SLEEP_SAMPLING_FREQ_HZ,
+                                                 LE_DEEP_SLEEP_NUM_OF_SAMPLES);
+  app_assert(sc == SL_STATUS_OK,
+              "[E: 0x%04x] Invalid burst configuration\n",
+              (int)sc);
+#endif
 }
 
 /**************************************************************************//**
@@ -47,6 +745,30 @@ SL_WEAK void app_process_action(void)
   // This is called infinitely.                                              //
   // Do not call blocking functions from here!                               //
   /////////////////////////////////////////////////////////////////////////////
+  uint16_t backlog = 0;
+
+#if LE_VOLTAGE_LOG_ENABLE
+  // Deferred log writes, one NVM3 operation per pass
+  le_voltage_log_process_action();
+  backlog += le_voltage_log_get_backlog();
+#endif
+#if LE_TX_QUEUE_ENABLE
+  backlog += le_tx_queue_get_pending();
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  backlog += le_voltage_capture_get_backlog();
+#endif
+#if LE_RETRANSMIT_ENABLE
+  backlog += le_retransmit_get_backlog();
+#endif
+  // An OTA update is a bulk transfer of its own
+  if(le_ota_in_progress()) {
+    backlog = UINT16_MAX;
+  }
+
+  // Short connection intervals while the log, a capture or missed windows
+  // are downloaded, notifications pile up or an image is received
+  le_conn_policy_set_queue_depth(backlog);
 }
 
 /**************************************************************************//**
@@ -92,63 +814,299 @@ void sl_bt_on_event(sl_bt_msg_t *evt)
                   "[E: 0x%04x] Failed to write attribute\n",
                   (int)sc);
 
+#if LE_BONDING_ENABLE
+      // Just Works bonding for fast reconnects
+      sc = le_bonding_init();
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to configure bonding\n",
+                  (int)sc);
+#endif
+
+      // Large ATT MTU and data length for batched notifications
+      sc = le_conn_policy_init();
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to set the MTU and data length\n",
+                  (int)sc);
+
       // Create an advertising set.
       sc = sl_bt_advertiser_create_set(&advertising_set_handle);
       app_assert(sc == SL_STATUS_OK,
                   "[E: 0x%04x] Failed to create advertising set\n",
                   (int)sc);
 
-      // Set advertising interval to 100ms.
-      sc = sl_bt_advertiser_set_timing(
-        advertising_set_handle,
-        160, // min. adv. interval (milliseconds * 1.6)
-        160, // max. adv. interval (milliseconds * 1.6)
-        0,   // adv. duration
-        0);  // max. num. adv. events
+#if LE_PERIODIC_ADV_ENABLE
+      // Scanners synchronize to the train instead of connecting
+      sc = le_periodic_adv_start();
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to start periodic advertising\n",
+                  (int)sc);
+#endif
+
+#if LE_VOLTAGE_BEACON_ENABLE
+#if !LE_DEEP_SLEEP_ENABLE
+      // Broadcast the averages, nobody connects
+      sc = le_voltage_beacon_start(advertising_set_handle);
       app_assert(sc == SL_STATUS_OK,
-                  "[E: 0x%04x] Failed to set advertising timing\n",
+                  "[E: 0x%04x] Failed to start beacon\n",
                   (int)sc);
-      // Start general advertising and enable connections.
-      sc = sl_bt_advertiser_start(
-        advertising_set_handle,
-        advertiser_general_discoverable,
-        advertiser_connectable_scannable);
+#endif
+
+      // In deep sleep mode the burst is broadcast once measured
+      le_voltage_monitor_start_next();
+#else
+      // Start general advertising and enable connections, fast at first.
+      sc = le_adv_scheduler_start(advertising_set_handle);
       app_assert(sc == SL_STATUS_OK,
                   "[E: 0x%04x] Failed to start advertising\n",
                   (int)sc);
 
+#if LE_VOLTAGE_LOG_ENABLE || LE_VOLTAGE_MONITOR_ALARM_ENABLE
+      // Sample from boot on, windows are logged until a client subscribes
+      // and alarms are tracked while nobody is connected
+      le_voltage_monitor_start_next();
+#endif
+
+#if LE_RELAY_ENABLE
+      // Collect the neighbors' beacons from boot on
+      sc = le_relay_start();
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to start the relay scanner\n",
+                  (int)sc);
+#endif
+#endif
+
+#if LE_TIME_SYNC_ENABLE
+      // Windows run free until a time source is found
+      sc = le_time_sync_start();
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to look for a time source\n",
+                  (int)sc);
+#endif
+
       break;
 
     // -------------------------------
     // This event indicates that a new connection was opened.
     case sl_bt_evt_connection_opened_id:
-      connection_handle = evt->data.evt_connection_opened.connection;
+      open_client(evt->data.evt_connection_opened.connection);
+      le_adv_scheduler_stop();
+
+#if LE_BONDING_ENABLE
+      // Encrypt right away, a bonded central gets its subscriptions back
+      if(evt->data.evt_connection_opened.bonding != SL_BT_INVALID_BONDING_HANDLE) {
+        client_t *client = find_client(evt->data.evt_connection_opened.connection);
+
+        if(client != NULL) {
+          client->bonded = true;
+        }
+      }
+      le_bonding_open(evt->data.evt_connection_opened.connection);
+#endif
+
+      // Start batching from scratch with the default MTU
+      if(count_clients() == 1) {
+        le_voltage_report_reset();
+      }
+
+      // Start with the parameters of the current mode
+      le_conn_policy_open(evt->data.evt_connection_opened.connection);
 
-      sc = sl_bt_connection_set_parameters(connection_handle, 2000, 2000, 0, 1000, 0, 65535);
+      // Keep advertising for further monitoring clients
+      if(count_clients() < SL_BT_CONFIG_MAX_CONNECTIONS) {
+        sc = le_adv_scheduler_start(advertising_set_handle);
+        app_assert(sc == SL_STATUS_OK,
+                    "[E: 0x%04x] Failed to start advertising\n",
+                    (int)sc);
+      }
 
       break;
 
     // -------------------------------
     // This event indicates that a connection was closed.
-    case sl_bt_evt_connection_closed_id:
-      le_voltage_monitor_stop();
+    case sl_bt_evt_connection_closed_id: {
+      uint8_t connection = evt->data.evt_connection_closed.connection;
+      client_t *client = find_client(connection);
+      bool was_in_progress = le_ota_in_progress();
 
-      // Restart advertising after client has disconnected.
-      sc = sl_bt_advertiser_start(
-        advertising_set_handle,
-        advertiser_general_discoverable,
-        advertiser_connectable_scannable);
-      app_assert(sc == SL_STATUS_OK,
-                  "[E: 0x%04x] Failed to start advertising\n",
-                  (int)sc);
+      if(client != NULL) {
+        client->open = false;
+      }
+#if LONG_READS
+      // A new connection with the same handle starts its own long reads
+      if(long_read_connection == connection) {
+        long_read_connection = 0xff;
+      }
+#endif
+      le_conn_policy_close(connection, evt->data.evt_connection_closed.reason);
+#if LE_TX_QUEUE_ENABLE
+      le_tx_queue_close(connection);
+#endif
+      // Install a received image or reboot into the AppLoader, does not return
+      // then
+      le_ota_close(connection);
+      follow_ota(was_in_progress);
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      // Sampling resumes on the capture signal
+      le_voltage_capture_release(connection);
+#endif
+#if LE_RETRANSMIT_ENABLE
+      le_retransmit_release(connection);
+#endif
+#if LE_VOLTAGE_LOG_ENABLE
+      // Keep sampling into the log
+      le_voltage_log_release(connection);
+#elif !LE_VOLTAGE_MONITOR_ALARM_ENABLE
+      // Sample until the last subscriber left
+      if(!any_subscriber()) {
+        le_voltage_monitor_stop();
+      }
+#endif
+      if(count_clients() == 0) {
+        le_voltage_report_reset();
+      } else {
+        update_report_mtu();
+      }
+
+      // Restart advertising after client has disconnected, unless it still
+      // runs for further clients.
+      if(le_adv_scheduler_get_stage() == LE_ADV_SCHEDULER_STAGE_IDLE) {
+        sc = le_adv_scheduler_start(advertising_set_handle);
+        app_assert(sc == SL_STATUS_OK,
+                    "[E: 0x%04x] Failed to start advertising\n",
+                    (int)sc);
+      }
 
       break;
+    }
 
     ///////////////////////////////////////////////////////////////////////////
     // Add additional event handlers here as your application requires!      //
     ///////////////////////////////////////////////////////////////////////////
 
-    case sl_bt_evt_gatt_server_characteristic_status_id:
+    // -------------------------------
+    // This event indicates that an advertising stage has ended.
+    case sl_bt_evt_advertiser_timeout_id:
+#if LE_DEEP_SLEEP_ENABLE
+      // Sleeps until the next report once it has been broadcast
+      le_deep_sleep_on_timeout(evt->data.evt_advertiser_timeout.handle);
+#endif
+      sc = le_adv_scheduler_on_timeout(evt->data.evt_advertiser_timeout.handle);
+      app_assert(sc == SL_STATUS_OK,
+                  "[E: 0x%04x] Failed to start advertising\n",
+                  (int)sc);
+      break;
+
+    // -------------------------------
+    // This event indicates that the connection parameters have changed.
+    case sl_bt_evt_connection_parameters_id:
+      le_conn_policy_on_parameters(&evt->data.evt_connection_parameters);
+#if LE_BONDING_ENABLE
+      // The CCCDs of the bonding data apply once the link is encrypted
+      if(le_bonding_is_encrypted(&evt->data.evt_connection_parameters)) {
+        client_t *client = find_client(evt->data.evt_connection_parameters.connection);
+
+        if(client != NULL) {
+          restore_subscriptions(client);
+        }
+      }
+#endif
+      break;
+
+#if LE_BONDING_ENABLE
+    // -------------------------------
+    // This event indicates that a new bonding was created. The subscriptions
+    // of the central are kept from now on.
+    case sl_bt_evt_sm_bonded_id: {
+      client_t *client = find_client(evt->data.evt_sm_bonded.connection);
+
+      if((client != NULL)
+         && (evt->data.evt_sm_bonded.bonding != SL_BT_INVALID_BONDING_HANDLE)) {
+        client->bonded = true;
+        client->restored = true;
+      }
+      break;
+    }
+#endif
+
+#if LOG_CHANNEL || LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+    // -------------------------------
+    // A central opens, feeds or closes the log download or the capture
+    // upload channel. Each module ignores the channels of the other one.
+    case sl_bt_evt_l2cap_le_channel_open_request_id:
+#if LOG_CHANNEL && LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      if(evt->data.evt_l2cap_le_channel_open_request.spsm == LE_VOLTAGE_CAPTURE_CHANNEL_SPSM) {
+        le_voltage_capture_on_channel_open_request(&evt->data.evt_l2cap_le_channel_open_request);
+      } else {
+        le_voltage_log_on_channel_open_request(&evt->data.evt_l2cap_le_channel_open_request);
+      }
+#elif LOG_CHANNEL
+      le_voltage_log_on_channel_open_request(&evt->data.evt_l2cap_le_channel_open_request);
+#else
+      le_voltage_capture_on_channel_open_request(&evt->data.evt_l2cap_le_channel_open_request);
+#endif
+      break;
+
+    case sl_bt_evt_l2cap_channel_credit_id:
+#if LOG_CHANNEL
+      le_voltage_log_on_channel_credit(&evt->data.evt_l2cap_channel_credit);
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      le_voltage_capture_on_channel_credit(&evt->data.evt_l2cap_channel_credit);
+#endif
+      break;
+
+    case sl_bt_evt_l2cap_channel_data_id:
+#if LOG_CHANNEL
+      le_voltage_log_on_channel_data(&evt->data.evt_l2cap_channel_data);
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      le_voltage_capture_on_channel_data(&evt->data.evt_l2cap_channel_data);
+#endif
+      break;
+
+    case sl_bt_evt_l2cap_channel_closed_id:
+#if LOG_CHANNEL
+      le_voltage_log_on_channel_closed(&evt->data.evt_l2cap_channel_closed);
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      le_voltage_capture_on_channel_closed(&evt->data.evt_l2cap_channel_closed);
+#endif
+      break;
+
+#endif
+    // -------------------------------
+    // This event indicates that the PHY of a connection has changed.
+    case sl_bt_evt_connection_phy_status_id:
+      le_conn_policy_on_phy_status(&evt->data.evt_connection_phy_status);
+      break;
+
+    // -------------------------------
+    // This event reports the RSSI polled by the connection policy.
+    case sl_bt_evt_connection_rssi_id:
+      le_conn_policy_on_rssi(&evt->data.evt_connection_rssi);
+      break;
+
+    // -------------------------------
+    // This event indicates that the ATT MTU has been negotiated.
+    case sl_bt_evt_gatt_mtu_exchanged_id: {
+      client_t *client = find_client(evt->data.evt_gatt_mtu_exchanged.connection);
+
+      // Fit as many window summaries into a notification as the smallest
+      // MTU of the subscribers allows
+      if(client != NULL) {
+        client->mtu = evt->data.evt_gatt_mtu_exchanged.mtu;
+        update_report_mtu();
+      }
+      break;
+    }
+
+    case sl_bt_evt_gatt_server_characteristic_status_id: {
+      client_t *client = find_client(evt->data.evt_gatt_server_characteristic_status.connection);
+
+      if(client == NULL) {
+        break;
+      }
+
       // Check if Average Voltage Characteristic changed
       if(evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_avg_voltage_data) {
 
@@ -156,15 +1114,439 @@ void sl_bt_on_event(sl_bt_msg_t *evt)
         if(gatt_server_client_config == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags) {
 
           // Check if EFR Connect App enabled notifications
-          if(gatt_disable != evt->data.evt_gatt_server_characteristic_status.client_config_flags) {
-            // Start sampling data
-            le_voltage_monitor_start_next();
+          set_notifying(client,
+                        gatt_disable != evt->data.evt_gatt_server_characteristic_status.client_config_flags);
+        }
+      }
+#if !LE_VOLTAGE_BEACON_ENABLE
+      // Extended Voltage Data notifications, sampled like the averages
+      else if((evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_extended_voltage_data)
+              && (gatt_server_client_config == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags)) {
+        set_extended_notifying(client,
+                               gatt_disable != evt->data.evt_gatt_server_characteristic_status.client_config_flags);
+      }
+#endif
+#if LE_VOLTAGE_LOG_ENABLE
+      // Log Data notifications disabled during a download
+      else if((evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_log_data)
+              && (gatt_server_client_config == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags)
+              && (gatt_disable == evt->data.evt_gatt_server_characteristic_status.client_config_flags)) {
+        le_voltage_log_release(client->connection);
+      }
+#endif
+#if LE_RELAY_ENABLE
+      // A new subscriber gets every neighbor, then the new readings
+      else if((evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_neighbor_report)
+              && (gatt_server_client_config == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags)) {
+        client->relay_notifying = gatt_disable != evt->data.evt_gatt_server_characteristic_status.client_config_flags;
+        if(client->relay_notifying) {
+          le_relay_report_all();
+          send_relay_reports();
+        }
+      }
+#endif
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+      else if(evt->data.evt_gatt_server_characteristic_status.characteristic == gattdb_voltage_alarm) {
+        if(gatt_server_client_config == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags) {
+          // Send the current state right away, changes follow
+          client->alarm_indicating = (evt->data.evt_gatt_server_characteristic_status.client_config_flags & gatt_indication) != 0;
+          send_alarm_indication(client);
+        } else if(gatt_server_confirmation == (gatt_server_characteristic_status_flag_t)evt->data.evt_gatt_server_characteristic_status.status_flags) {
+          client->alarm_in_flight = false;
+          if(client->alarm_pending) {
+            send_alarm_indication(client);
+          }
+        }
+      }
+#endif
+      break;
+    }
+
+    // -------------------------------
+    // A remote GATT client reads the monitor configuration.
+    case sl_bt_evt_gatt_server_user_read_request_id:
+      if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_monitor_config) {
+        uint16_t sampling_freq_hz;
+        uint16_t num_of_samples;
+        uint8_t config_buf[4];
+
+        le_voltage_monitor_get_config(&sampling_freq_hz, &num_of_samples);
+        config_buf[0] = (sampling_freq_hz >> 8) & 0x00FF;
+        config_buf[1] = sampling_freq_hz & 0x00FF;
+        config_buf[2] = (num_of_samples >> 8) & 0x00FF;
+        config_buf[3] = num_of_samples & 0x00FF;
+
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_monitor_config,
+          0,
+          sizeof(config_buf),
+          config_buf,
+          NULL);
+      }
+#if !LE_VOLTAGE_BEACON_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_extended_voltage_data) {
+        uint8_t extended_buf[LE_VOLTAGE_REPORT_EXTENDED_SIZE];
+        size_t len = le_voltage_report_build_extended(&last_summary, extended_buf);
+
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_extended_voltage_data,
+          0,
+          len,
+          extended_buf,
+          NULL);
+      }
+#endif
+#if LE_VOLTAGE_LOG_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_log_control) {
+        uint16_t records;
+        uint16_t windows;
+        uint8_t status_buf[4];
+
+        le_voltage_log_get_status(&records, &windows);
+        status_buf[0] = (records >> 8) & 0x00FF;
+        status_buf[1] = records & 0x00FF;
+        status_buf[2] = (windows >> 8) & 0x00FF;
+        status_buf[3] = windows & 0x00FF;
+
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_log_control,
+          0,
+          sizeof(status_buf),
+          status_buf,
+          NULL);
+      }
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_capture_control) {
+        uint8_t capture_buf[LE_VOLTAGE_CAPTURE_STATUS_SIZE];
+
+        le_voltage_capture_build_status(capture_buf);
+
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_capture_control,
+          0,
+          sizeof(capture_buf),
+          capture_buf,
+          NULL);
+      }
+#endif
+#if LE_ENERGY_STATS_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_diagnostics) {
+        sc = send_long_read(evt->data.evt_gatt_server_user_read_request.connection,
+                            gattdb_diagnostics,
+                            evt->data.evt_gatt_server_user_read_request.offset,
+                            build_diagnostics);
+      }
+#endif
+#if LE_TRACE_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_trace) {
+        sc = send_long_read(evt->data.evt_gatt_server_user_read_request.connection,
+                            gattdb_trace,
+                            evt->data.evt_gatt_server_user_read_request.offset,
+                            le_trace_build);
+      }
+#endif
+#if LE_SOAK_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_soak) {
+        sc = send_long_read(evt->data.evt_gatt_server_user_read_request.connection,
+                            gattdb_soak,
+                            evt->data.evt_gatt_server_user_read_request.offset,
+                            le_soak_build);
+      }
+#endif
+#if LE_MEMORY_STATS_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_memory_budget) {
+        sc = send_long_read(evt->data.evt_gatt_server_user_read_request.connection,
+                            gattdb_memory_budget,
+                            evt->data.evt_gatt_server_user_read_request.offset,
+                            le_memory_stats_build);
+      }
+#endif
+#if LE_CHANGE_FILTER_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_change_filter) {
+        uint8_t filter_buf[LE_CHANGE_FILTER_VALUE_SIZE];
+
+        le_change_filter_build(filter_buf);
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_change_filter,
+          0,
+          sizeof(filter_buf),
+          filter_buf,
+          NULL);
+      }
+#endif
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+      else if(evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_voltage_alarm) {
+        uint8_t alarm_buf[3];
+
+        build_alarm_value(alarm_buf);
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          gattdb_voltage_alarm,
+          0,
+          sizeof(alarm_buf),
+          alarm_buf,
+          NULL);
+      }
+#endif
+      else {
+        // Characteristic of a feature compiled out of this build, answered
+        // so the ATT transaction does not time out
+        sc = sl_bt_gatt_server_send_user_read_response(
+          evt->data.evt_gatt_server_user_read_request.connection,
+          evt->data.evt_gatt_server_user_read_request.characteristic,
+          (uint8_t)SL_STATUS_BT_ATT_REQUEST_NOT_SUPPORTED,
+          0,
+          NULL,
+          NULL);
+      }
+      break;
+
+    // -------------------------------
+    // A remote GATT client writes the monitor configuration.
+    case sl_bt_evt_gatt_server_user_write_request_id:
+      if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_monitor_config) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if(value->len != 4) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else {
+          // Applied between windows by the voltage monitor
+          sc = le_voltage_monitor_set_config((value->data[0] << 8) | value->data[1],
+                                             (value->data[2] << 8) | value->data[3]);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+          }
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_monitor_config,
+          att_errorcode);
+      }
+#if LE_VOLTAGE_LOG_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_log_control) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if(value->len != 1) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else if(value->data[0] == LE_VOLTAGE_LOG_CMD_START_DOWNLOAD) {
+          client_t *client = find_client(evt->data.evt_gatt_server_user_write_request.connection);
+
+          // Chunks sized for the MTU of the downloading client
+          if(client != NULL) {
+            le_voltage_log_set_mtu(client->mtu);
+          }
+          sc = le_voltage_log_start_download(evt->data.evt_gatt_server_user_write_request.connection);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+          }
+        } else if(value->data[0] == LE_VOLTAGE_LOG_CMD_STOP_DOWNLOAD) {
+          le_voltage_log_stop_download();
+        } else if(value->data[0] == LE_VOLTAGE_LOG_CMD_ERASE) {
+          le_voltage_log_erase();
+        } else {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_log_control,
+          att_errorcode);
+      }
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_capture_control) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if(value->len != 1) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else if(value->data[0] == LE_VOLTAGE_CAPTURE_CMD_ARM) {
+          // Suspends window sampling until the capture is released
+          sc = le_voltage_capture_arm(evt->data.evt_gatt_server_user_write_request.connection);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+          }
+        } else if(value->data[0] == LE_VOLTAGE_CAPTURE_CMD_TRIGGER) {
+          sc = le_voltage_monitor_capture_trigger();
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+          }
+        } else if(value->data[0] == LE_VOLTAGE_CAPTURE_CMD_RELEASE) {
+          // Sampling resumes on the capture signal
+          le_voltage_capture_abort();
+        } else {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_capture_control,
+          att_errorcode);
+      }
+#endif
+#if LE_ENERGY_STATS_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_diagnostics) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if((value->len != 1) || (value->data[0] != 0)) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        } else {
+          le_energy_stats_reset();
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+          le_voltage_monitor_reset_profile();
+#endif
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_diagnostics,
+          att_errorcode);
+      }
+#endif
+#if LE_TRACE_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_trace) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if((value->len != 1) || (value->data[0] != 0)) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        } else {
+          le_trace_reset();
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_trace,
+          att_errorcode);
+      }
+#endif
+#if LE_SOAK_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_soak) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if((value->len != 1) || (value->data[0] != 0)) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        } else {
+          le_soak_reset();
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_soak,
+          att_errorcode);
+      }
+#endif
+#if LE_CHANGE_FILTER_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_change_filter) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+
+        if(value->len != LE_CHANGE_FILTER_SETTINGS_SIZE) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else {
+          // Applied to the next window even if it could not be stored
+          sc = le_change_filter_set_config((value->data[0] << 8) | value->data[1],
+                                           (value->data[2] << 8) | value->data[3]);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INSUFFICIENT_RESOURCES;
           }
-          // indication and notifications disabled
-          else {
-            le_voltage_monitor_stop();
+        }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_change_filter,
+          att_errorcode);
+      }
+#endif
+#if LE_RETRANSMIT_ENABLE
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_window_request) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        client_t *client = find_client(evt->data.evt_gatt_server_user_write_request.connection);
+        uint8_t att_errorcode = 0;
+
+        if(value->len != LE_RETRANSMIT_REQUEST_SIZE) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else if(client == NULL) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        } else {
+          uint32_t first = ((uint32_t)value->data[0] << 24) | ((uint32_t)value->data[1] << 16)
+                           | ((uint32_t)value->data[2] << 8) | value->data[3];
+          uint32_t last = ((uint32_t)value->data[4] << 24) | ((uint32_t)value->data[5] << 16)
+                          | ((uint32_t)value->data[6] << 8) | value->data[7];
+
+          // Payloads sized for the MTU of the requesting client
+          sc = le_retransmit_request(client->connection, client->mtu, first, last);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
           }
         }
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_window_request,
+          att_errorcode);
+      }
+#endif
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_ota_control) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+        bool was_in_progress = le_ota_in_progress();
+
+        if(value->len != 1) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_INVALID_ATT_LENGTH;
+        } else {
+          sc = le_ota_control(evt->data.evt_gatt_server_user_write_request.connection,
+                              value->data[0]);
+          if(sc != SL_STATUS_OK) {
+            att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+          }
+        }
+        follow_ota(was_in_progress);
+
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          gattdb_ota_control,
+          att_errorcode);
+      }
+      else if(evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_ota_data) {
+        uint8array *value = &evt->data.evt_gatt_server_user_write_request.value;
+        uint8_t att_errorcode = 0;
+        bool was_in_progress = le_ota_in_progress();
+
+        sc = le_ota_write(evt->data.evt_gatt_server_user_write_request.connection,
+                          value->len,
+                          value->data);
+        if(sc != SL_STATUS_OK) {
+          att_errorcode = (uint8_t)SL_STATUS_BT_ATT_VALUE_NOT_ALLOWED;
+        }
+        follow_ota(was_in_progress);
+
+        // Write commands get no response, an aborted update fails LE_OTA_CMD_END
+        if(evt->data.evt_gatt_server_user_write_request.att_opcode != sl_bt_gatt_write_command) {
+          sc = sl_bt_gatt_server_send_user_write_response(
+            evt->data.evt_gatt_server_user_write_request.connection,
+            gattdb_ota_data,
+            att_errorcode);
+        }
+      }
+      else if(evt->data.evt_gatt_server_user_write_request.att_opcode != sl_bt_gatt_write_command) {
+        // Characteristic of a feature compiled out of this build, answered
+        // so the ATT transaction does not time out
+        sc = sl_bt_gatt_server_send_user_write_response(
+          evt->data.evt_gatt_server_user_write_request.connection,
+          evt->data.evt_gatt_server_user_write_request.characteristic,
+          (uint8_t)SL_STATUS_BT_ATT_REQUEST_NOT_SUPPORTED);
       }
       break;
 
@@ -172,23 +1554,99 @@ void sl_bt_on_event(sl_bt_msg_t *evt)
 
       // External signal triggered from LDMA interrupt
       if(evt->data.evt_system_external_signal.extsignals & LE_MONITOR_SIGNAL) {
-        // Get the average
-        uint16_t data_mV = le_voltage_monitor_get_average_mv();
+        le_voltage_monitor_summary_t summary;
 
-        // Convert endianess
-        volt_buf[0] = (data_mV >> 8) & 0x00FF;
-        volt_buf[1] = data_mV & 0x00FF;
+#if LE_TRACE_ENABLE
+        le_trace_record(LE_TRACE_SIGNAL);
+#endif
 
-        // Notify connected user
-        sc = sl_bt_gatt_server_send_notification(connection_handle,
-                                                 gattdb_avg_voltage_data,
-                                                 sizeof(volt_buf),
-                                                 (uint8_t *)&volt_buf);
+#if LE_SOAK_ENABLE
+        le_soak_begin_window();
+#endif
 
+        // Every completed window still held by its buffer, oldest first
+        while(le_voltage_monitor_next_summary(&summary)) {
+          process_window(&summary);
+#if LE_SOAK_ENABLE
+          le_soak_end_window(summary.overruns);
+#endif
+        }
+
+#if !LE_DEEP_SLEEP_ENABLE
         // Start the next measurements
-        le_voltage_monitor_start_next();
+        start_sampling();
+#endif
+      }
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+      // External signal triggered from the IADC window comparator
+      if(evt->data.evt_system_external_signal.extsignals & LE_MONITOR_ALARM_SIGNAL) {
+        for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+          if(clients[i].open) {
+            send_alarm_indication(&clients[i]);
+          }
+        }
+      }
+#endif
+#if LE_RELAY_ENABLE
+      // External signal of new neighbor readings
+      if(evt->data.evt_system_external_signal.extsignals & LE_RELAY_SIGNAL) {
+        send_relay_reports();
       }
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+      // External signal of a completed or a released capture
+      if(evt->data.evt_system_external_signal.extsignals & LE_MONITOR_CAPTURE_SIGNAL) {
+        le_voltage_capture_on_signal();
+        if(!le_voltage_capture_in_progress() && !le_ota_in_progress()) {
+          resume_sampling();
+        }
+      }
+#endif
+      break;
+
+#if LE_RELAY_ENABLE || LE_TIME_SYNC_ENABLE
+    // -------------------------------
+    // A neighbor's advertisement or a time source was received.
+    case sl_bt_evt_scanner_scan_report_id:
+#if LE_RELAY_ENABLE
+      le_relay_on_scan_report(&evt->data.evt_scanner_scan_report);
+#endif
+#if LE_TIME_SYNC_ENABLE
+      le_time_sync_on_scan_report(&evt->data.evt_scanner_scan_report);
+#endif
+      break;
+#endif
+
+#if LE_TIME_SYNC_ENABLE
+    // -------------------------------
+    // The periodic advertising train of the time source was found.
+    case sl_bt_evt_sync_opened_id:
+      le_time_sync_on_opened(&evt->data.evt_sync_opened);
+      break;
+
+    // -------------------------------
+    // An event of the time source's train was received.
+    case sl_bt_evt_sync_data_id:
+      le_time_sync_on_data(&evt->data.evt_sync_data);
+      break;
+
+    // -------------------------------
+    // The time source was lost.
+    case sl_bt_evt_sync_closed_id:
+      le_time_sync_on_closed(&evt->data.evt_sync_closed);
+      break;
+#endif
+
+#if LE_MEMORY_STATS_ENABLE
+    // -------------------------------
+    // The Bluetooth stack ran out of buffers or heap.
+    case sl_bt_evt_system_resource_exhausted_id:
+      le_memory_stats_record_exhausted(
+        evt->data.evt_system_resource_exhausted.num_buffers_discarded,
+        evt->data.evt_system_resource_exhausted.num_buffer_allocation_failures,
+        evt->data.evt_system_resource_exhausted.num_heap_allocation_failures);
       break;
+#endif
 
     // -------------------------------
     // Default event handler.
@@ -25,9 +25,23 @@ GATT_DATA(const uint16_t gattdb_uuidtable_16_map[]) =
 GATT_DATA(const uint8_t gattdb_uuidtable_128_map[]) =
 {
   0xc6, 0x27, 0x16, 0x93, 0xc1, 0xe8, 0xce, 0xb8, 0x07, 0x41, 0xa1, 0xfc, 0x4d, 0x10, 0x88, 0x52, 
+  0x9f, 0xd3, 0x00, 0xbd, 0xdf, 0x21, 0xa8, 0x93, 0x64, 0x42, 0xc2, 0x7f, 0xcf, 0x1a, 0x9c, 0xf9, 
+  0x4a, 0x45, 0x60, 0xa0, 0xec, 0xa2, 0xf9, 0x9c, 0x63, 0x47, 0xca, 0xb7, 0x42, 0x1e, 0x07, 0x17, 
+  0x02, 0x06, 0xab, 0x0f, 0x8a, 0xdb, 0x76, 0xa6, 0xa9, 0x42, 0xab, 0x24, 0xed, 0xbe, 0xf4, 0x8c, 
+  0x86, 0xd1, 0xbb, 0x20, 0x8d, 0xf9, 0xb6, 0xb5, 0x2f, 0x4b, 0x4d, 0x14, 0xb8, 0x86, 0x1a, 0xa0, 
+  0xb1, 0x97, 0x7c, 0x8f, 0x04, 0x22, 0x12, 0x8a, 0xcd, 0x4d, 0x85, 0xea, 0x47, 0x7d, 0x88, 0xbb, 
+  0x84, 0x28, 0x36, 0x53, 0x62, 0xd1, 0xce, 0x89, 0x41, 0x41, 0x7c, 0x5b, 0x37, 0x91, 0x2f, 0x8a, 
+  0x76, 0x66, 0x64, 0x6c, 0xc7, 0x26, 0x86, 0x8e, 0x59, 0x43, 0xc2, 0x19, 0x93, 0x21, 0x57, 0x93, 
+  0x6e, 0x13, 0xe5, 0x60, 0x0c, 0x47, 0xe6, 0x94, 0x62, 0x4a, 0x50, 0xd9, 0x31, 0x39, 0x34, 0x6a, 
+  0xf8, 0x30, 0xcf, 0xa4, 0x5a, 0x59, 0x2d, 0xab, 0xde, 0x4c, 0xf7, 0x79, 0x0c, 0xec, 0x86, 0xb9, 
+  0x30, 0xdc, 0x60, 0xa5, 0x88, 0x78, 0x8f, 0x85, 0x13, 0x4a, 0x18, 0x38, 0xb0, 0x56, 0xb0, 0x91, 
+  0x50, 0xbf, 0x61, 0x4d, 0xfd, 0x5b, 0xbc, 0x99, 0xca, 0x47, 0xd2, 0x17, 0x52, 0x20, 0x39, 0x60, 
+  0xc0, 0x4d, 0x0a, 0x44, 0x7e, 0xb9, 0xe4, 0x8a, 0xfc, 0x41, 0xb9, 0x5e, 0xa4, 0xe9, 0xda, 0x3d, 
+  0x7c, 0x68, 0xe0, 0x2b, 0x79, 0x4f, 0x48, 0x91, 0x3a, 0x49, 0x92, 0xb4, 0x6e, 0xb5, 0x60, 0x3f, 
   0x63, 0x60, 0x32, 0xe0, 0x37, 0x5e, 0xa4, 0x88, 0x53, 0x4e, 0x6d, 0xfb, 0x64, 0x35, 0xbf, 0xf7, 
+  0x53, 0xa1, 0x81, 0x1f, 0x58, 0x2c, 0xd0, 0xa5, 0x45, 0x40, 0xfc, 0x34, 0xf3, 0x27, 0x42, 0x98, 
 };
-GATT_DATA(const sli_bt_gattdb_value_t gattdb_attribute_field_22) = {
+GATT_DATA(const sli_bt_gattdb_value_t gattdb_attribute_field_54) = {
   .len = 16,
   .data = { 0xf0, 0x19, 0x21, 0xb4, 0x47, 0x8f, 0xa4, 0xbf, 0xa1, 0x4f, 0x63, 0xfd, 0xee, 0xd6, 0x14, 0x1d, }
 };
@@ -104,22 +118,56 @@ GATT_DATA(const sli_bt_gattdb_attribute_t gattdb_attributes_map[]) = {
   { .handle = 0x14, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x10, .char_uuid = 0x8000 } },
   { .handle = 0x15, .uuid = 0x8000, .permissions = 0x800, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
   { .handle = 0x16, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x01 } },
-  { .handle = 0x17, .uuid = 0x0000, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x00, .constdata = &gattdb_attribute_field_22 },
-  { .handle = 0x18, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x08, .char_uuid = 0x8001 } },
-  { .handle = 0x19, .uuid = 0x8001, .permissions = 0x802, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x17, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x12, .char_uuid = 0x8001 } },
+  { .handle = 0x18, .uuid = 0x8001, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x19, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x02 } },
+  { .handle = 0x1a, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x8002 } },
+  { .handle = 0x1b, .uuid = 0x8002, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x1c, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x8003 } },
+  { .handle = 0x1d, .uuid = 0x8003, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x1e, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x10, .char_uuid = 0x8004 } },
+  { .handle = 0x1f, .uuid = 0x8004, .permissions = 0x800, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x20, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x03 } },
+  { .handle = 0x21, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x8005 } },
+  { .handle = 0x22, .uuid = 0x8005, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x23, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x8006 } },
+  { .handle = 0x24, .uuid = 0x8006, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x25, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x8007 } },
+  { .handle = 0x26, .uuid = 0x8007, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x27, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x02, .char_uuid = 0x8008 } },
+  { .handle = 0x28, .uuid = 0x8008, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x29, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x22, .char_uuid = 0x8009 } },
+  { .handle = 0x2a, .uuid = 0x8009, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x2b, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x02, .clientconfig_index = 0x04 } },
+  { .handle = 0x2c, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0a, .char_uuid = 0x800a } },
+  { .handle = 0x2d, .uuid = 0x800a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x2e, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x1a, .char_uuid = 0x800b } },
+  { .handle = 0x2f, .uuid = 0x800b, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x30, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x05 } },
+  { .handle = 0x31, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x10, .char_uuid = 0x800c } },
+  { .handle = 0x32, .uuid = 0x800c, .permissions = 0x800, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x33, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x06 } },
+  { .handle = 0x34, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x18, .char_uuid = 0x800d } },
+  { .handle = 0x35, .uuid = 0x800d, .permissions = 0x802, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x36, .uuid = 0x000a, .permissions = 0x803, .caps = 0xffff, .state = 0x00, .datatype = 0x03, .configdata = { .flags = 0x01, .clientconfig_index = 0x07 } },
+  { .handle = 0x37, .uuid = 0x0000, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x00, .constdata = &gattdb_attribute_field_54 },
+  { .handle = 0x38, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x08, .char_uuid = 0x800e } },
+  { .handle = 0x39, .uuid = 0x800e, .permissions = 0x802, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
+  { .handle = 0x3a, .uuid = 0x0002, .permissions = 0x801, .caps = 0xffff, .state = 0x00, .datatype = 0x05, .characteristic = { .properties = 0x0c, .char_uuid = 0x800f } },
+  { .handle = 0x3b, .uuid = 0x800f, .permissions = 0x802, .caps = 0xffff, .state = 0x00, .datatype = 0x07, .dynamicdata = NULL },
 };
 
 GATT_HEADER(const sli_bt_gattdb_t gattdb) = {
   .attributes = gattdb_attributes_map,
-  .attribute_table_size = 25,
-  .attribute_num = 25,
+  .attribute_table_size = 59,
+  .attribute_num = 59,
   .uuid16 = gattdb_uuidtable_16_map,
   .uuid16_table_size = 11,
   .uuid16_num = 11,
   .uuid128 = gattdb_uuidtable_128_map,
-  .uuid128_table_size = 2,
-  .uuid128_num = 2,
-  .num_ccfg = 2,
+  .uuid128_table_size = 16,
+  .uuid128_num = 16,
+  .num_ccfg = 8,
   .caps_mask = 0xffff,
   .enabled_caps = 0xffff,
 };
@@ -19,8 +19,22 @@ extern const sli_bt_gattdb_t gattdb;
 #define gattdb_system_id                      18
 #define gattdb_voltage_monitor                19
 #define gattdb_avg_voltage_data               21
-#define gattdb_ota                            23
-#define gattdb_ota_control                    25
+#define gattdb_extended_voltage_data          24
+#define gattdb_monitor_config                 27
+#define gattdb_log_control                    29
+#define gattdb_log_data                       31
+#define gattdb_diagnostics                    34
+#define gattdb_trace                          36
+#define gattdb_soak                           38
+#define gattdb_memory_budget                  40
+#define gattdb_voltage_alarm                  42
+#define gattdb_change_filter                  45
+#define gattdb_capture_control                47
+#define gattdb_neighbor_report                50
+#define gattdb_window_request                 53
+#define gattdb_ota                            55
+#define gattdb_ota_control                    57
+#define gattdb_ota_data                       59
 
 
 #endif // __GATT_DB_H
@@ -14,8 +14,6 @@ const sli_bt_gattdb_t gattdb = {0};
 #endif // SL_CATALOG_GATT_CONFIGURATION_PRESENT
 #endif // SL_COMPONENT_CATALOG_PRESENT
 
-#include "sl_ota_dfu.h"
-
 static const sl_bt_configuration_t config = SL_BT_CONFIG_DEFAULT;
 
 /** @brief Table of used BGAPI classes */
@@ -24,10 +22,12 @@ static const struct sli_bgapi_class * const bt_class_table[] =
   SL_BT_BGAPI_CLASS(system),
   SL_BT_BGAPI_CLASS(advertiser),
   SL_BT_BGAPI_CLASS(scanner),
+  SL_BT_BGAPI_CLASS(sync),
   SL_BT_BGAPI_CLASS(connection),
   SL_BT_BGAPI_CLASS(gatt),
   SL_BT_BGAPI_CLASS(gatt_server),
   SL_BT_BGAPI_CLASS(sm),
+  SL_BT_BGAPI_CLASS(l2cap),
   NULL
 };
 #if !defined(SL_CATALOG_KERNEL_PRESENT)
@@ -57,6 +57,7 @@ void sl_bt_init(void)
   sl_status_t err = sl_bt_init_stack(&config);
   (void) err;
   sl_bt_init_classes(bt_class_table);
+  sl_bt_init_periodic_advertising();
 }
 
 SL_WEAK void sl_bt_on_event(sl_bt_msg_t* evt)
@@ -66,7 +67,6 @@ SL_WEAK void sl_bt_on_event(sl_bt_msg_t* evt)
 
 void sl_bt_process_event(sl_bt_msg_t *evt)
 {
-  sl_bt_ota_dfu_on_event(evt);
   sl_bt_on_event(evt);
 }
 
@@ -5,8 +5,11 @@
 #define SL_CATALOG_APP_ASSERT_PRESENT
 #define SL_CATALOG_BLUETOOTH_FEATURE_ADVERTISER_PRESENT
 #define SL_CATALOG_BLUETOOTH_FEATURE_CONNECTION_PRESENT
+#define SL_CATALOG_BLUETOOTH_FEATURE_L2CAP_PRESENT
+#define SL_CATALOG_BLUETOOTH_FEATURE_PERIODIC_ADV_PRESENT
 #define SL_CATALOG_BLUETOOTH_FEATURE_SCANNER_PRESENT
 #define SL_CATALOG_BLUETOOTH_FEATURE_SM_PRESENT
+#define SL_CATALOG_BLUETOOTH_FEATURE_SYNC_PRESENT
 #define SL_CATALOG_BLUETOOTH_PRESENT
 #define SL_CATALOG_DEVICE_INIT_NVIC_PRESENT
 #define SL_CATALOG_EMLIB_CORE_DEBUG_CONFIG_PRESENT
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE advertising scheduler configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_ADV_SCHEDULER_CONFIG_H
+#define LE_ADV_SCHEDULER_CONFIG_H
+
+// <h> Fast advertising
+// <i> Used for the first seconds after boot and after a disconnect.
+
+// <o LE_ADV_SCHEDULER_FAST_INTERVAL_MS> Advertising interval [ms] <20-10240>
+// <i> Default: 100
+#define LE_ADV_SCHEDULER_FAST_INTERVAL_MS  100
+
+// <o LE_ADV_SCHEDULER_FAST_DURATION_S> Duration [s] <1-655>
+// <i> Default: 30
+#define LE_ADV_SCHEDULER_FAST_DURATION_S  30
+
+// </h>
+
+// <h> Slow advertising
+// <i> Follows the fast stage.
+
+// <o LE_ADV_SCHEDULER_SLOW_INTERVAL_MS> Advertising interval [ms] <20-10240>
+// <i> Default: 2000
+#define LE_ADV_SCHEDULER_SLOW_INTERVAL_MS  2000
+
+// <o LE_ADV_SCHEDULER_SLOW_DURATION_S> Duration [s] <0-655>
+// <i> Advertising stops once the slow stage ends, until the next reset. The
+// <i> device stays in EM2 and only samples into the offline log.
+// <i> 0 advertises forever.
+// <i> Default: 0
+#define LE_ADV_SCHEDULER_SLOW_DURATION_S  0
+
+// <o LE_ADV_SCHEDULER_SLOW_MAX_EVENTS> Maximum number of advertising events <0-255>
+// <i> Ends the slow stage after this many advertisements, whichever of the
+// <i> duration and the event count comes first. 0 does not limit the count.
+// <i> Default: 0
+#define LE_ADV_SCHEDULER_SLOW_MAX_EVENTS  0
+
+// </h>
+
+#endif // LE_ADV_SCHEDULER_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,55 @@
+/***************************************************************************//**
+ * @file
+ * @brief Bonding configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_BONDING_CONFIG_H
+#define LE_BONDING_CONFIG_H
+
+// <h> Bonding
+
+// <q LE_BONDING_ENABLE> Bond with centrals and restore their subscriptions
+// <i> Every new connection is asked for Just Works pairing with bonding. A
+// <i> bonded central finds the same GATT database hash on reconnect and skips
+// <i> the service discovery, and its notification subscriptions are restored
+// <i> from the bonding data once the link is encrypted.
+// <i> Default: 1
+#define LE_BONDING_ENABLE  1
+
+// <o LE_BONDING_MAX_BONDINGS> Maximum number of bondings <1-32>
+// <i> Once full, a new bonding replaces the oldest one.
+// <i> Default: 4
+#define LE_BONDING_MAX_BONDINGS  4
+
+// </h>
+
+#endif // LE_BONDING_CONFIG_H
+
+// <<< end of configuration section >>>
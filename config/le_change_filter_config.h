@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * @file
+ * @brief Report-on-change filter configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_CHANGE_FILTER_CONFIG_H
+#define LE_CHANGE_FILTER_CONFIG_H
+
+// <h> Report on change
+
+// <q LE_CHANGE_FILTER_ENABLE> Only notify windows that changed
+// <i> A window is only notified if its average differs from the last
+// <i> notified one by at least the hysteresis, or if nothing has been
+// <i> notified for the heartbeat interval. Notified windows are sent right
+// <i> away instead of being batched. Both settings can be changed through the
+// <i> Change Filter characteristic and are kept in NVM3.
+// <i> Default: 1
+#define LE_CHANGE_FILTER_ENABLE  1
+
+// <o LE_CHANGE_FILTER_HYSTERESIS_MV> Default hysteresis [mV] <0-65535>
+// <i> 0 notifies every window.
+// <i> Default: 10
+#define LE_CHANGE_FILTER_HYSTERESIS_MV  10
+
+// <o LE_CHANGE_FILTER_HEARTBEAT_S> Default heartbeat interval [s] <0-65535>
+// <i> Longest time without a notification. 0 disables the heartbeat.
+// <i> Default: 60
+#define LE_CHANGE_FILTER_HEARTBEAT_S  60
+
+// <o LE_CHANGE_FILTER_NVM3_KEY> NVM3 key of the settings <0x10000-0xFFFFF>
+// <i> Must not overlap the log keys.
+// <i> Default: 0x20000
+#define LE_CHANGE_FILTER_NVM3_KEY  0x20000
+
+// </h>
+
+#endif // LE_CHANGE_FILTER_CONFIG_H
+
+// <<< end of configuration section >>>
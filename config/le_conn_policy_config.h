@@ -0,0 +1,184 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE connection policy configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_CONN_POLICY_CONFIG_H
+#define LE_CONN_POLICY_CONFIG_H
+
+// <h> Streaming parameters
+// <i> Used while the pending notifications fit into a few connection events.
+
+// <o LE_CONN_POLICY_STREAM_MIN_INTERVAL> Minimum connection interval (x 1.25 ms) <6-3200>
+// <i> Default: 400 (500 ms)
+#define LE_CONN_POLICY_STREAM_MIN_INTERVAL  400
+
+// <o LE_CONN_POLICY_STREAM_MAX_INTERVAL> Maximum connection interval (x 1.25 ms) <6-3200>
+// <i> Default: 800 (1 s)
+#define LE_CONN_POLICY_STREAM_MAX_INTERVAL  800
+
+// <o LE_CONN_POLICY_STREAM_LATENCY> Peripheral latency (connection events) <0-499>
+// <i> Connection events the peripheral may skip when it has nothing to send.
+// <i> Default: 4
+#define LE_CONN_POLICY_STREAM_LATENCY  4
+
+// <o LE_CONN_POLICY_STREAM_TIMEOUT> Supervision timeout (x 10 ms) <10-3200>
+// <i> Default: 1200 (12 s)
+#define LE_CONN_POLICY_STREAM_TIMEOUT  1200
+
+// </h>
+
+// <h> Bulk transfer parameters
+// <i> Used while a backlog of notifications is drained, e.g. the offline log.
+
+// <o LE_CONN_POLICY_BULK_MIN_INTERVAL> Minimum connection interval (x 1.25 ms) <6-3200>
+// <i> Default: 12 (15 ms)
+#define LE_CONN_POLICY_BULK_MIN_INTERVAL  12
+
+// <o LE_CONN_POLICY_BULK_MAX_INTERVAL> Maximum connection interval (x 1.25 ms) <6-3200>
+// <i> Default: 24 (30 ms)
+#define LE_CONN_POLICY_BULK_MAX_INTERVAL  24
+
+// <o LE_CONN_POLICY_BULK_LATENCY> Peripheral latency (connection events) <0-499>
+// <i> Default: 0
+#define LE_CONN_POLICY_BULK_LATENCY  0
+
+// <o LE_CONN_POLICY_BULK_TIMEOUT> Supervision timeout (x 10 ms) <10-3200>
+// <i> Default: 400 (4 s)
+#define LE_CONN_POLICY_BULK_TIMEOUT  400
+
+// </h>
+
+// <h> Policy
+
+// <o LE_CONN_POLICY_BULK_ENTER_DEPTH> Pending notifications to switch to bulk <1-255>
+// <i> Default: 2
+#define LE_CONN_POLICY_BULK_ENTER_DEPTH  2
+
+// <o LE_CONN_POLICY_BULK_EXIT_DEPTH> Pending notifications to switch back to streaming <0-254>
+// <i> Must be lower than the depth entering bulk mode.
+// <i> Default: 0
+#define LE_CONN_POLICY_BULK_EXIT_DEPTH  0
+
+// <o LE_CONN_POLICY_MAX_RETRIES> Parameter requests per mode change <1-10>
+// <i> The parameters are requested again when the central applies values
+// <i> outside of the requested range, up to this many times.
+// <i> Default: 3
+#define LE_CONN_POLICY_MAX_RETRIES  3
+
+// </h>
+
+// <h> Link layer
+
+// <o LE_CONN_POLICY_MAX_MTU> Largest ATT MTU <23-247>
+// <i> Any value above 23 makes the stack request an MTU exchange when a
+// <i> connection opens. 247 carries the largest notification payload of 244
+// <i> bytes.
+// <i> Default: 247
+#define LE_CONN_POLICY_MAX_MTU  247
+
+// <o LE_CONN_POLICY_DATA_LENGTH> Link layer TX data length [bytes] <27-251>
+// <i> Requested with the data length update on every new connection. 251
+// <i> sends a 247 byte ATT PDU in a single link layer packet.
+// <i> Default: 251
+#define LE_CONN_POLICY_DATA_LENGTH  251
+
+// <o LE_CONN_POLICY_BUFFERED_PDUS> Full-size packets buffered per connection <1-8>
+// <i> Checked against SL_BT_CONFIG_BUFFER_SIZE for all connections at
+// <i> compile time.
+// <i> Default: 2
+#define LE_CONN_POLICY_BUFFERED_PDUS  2
+
+// </h>
+
+// <h> PHY
+
+// <q LE_CONN_POLICY_PHY_ENABLE> Prefer a PHY for the workload
+// <i> Bulk transfers run on LE 2M, streaming on LE 1M. The central may
+// <i> refuse, the PHY is then requested again up to the retry count.
+// <i> Default: 1
+#define LE_CONN_POLICY_PHY_ENABLE  1
+
+// <q LE_CONN_POLICY_CODED_ENABLE> Switch weak links to LE Coded
+// <i> The RSSI of every connection is polled, links below the enter
+// <i> threshold move to LE Coded whatever the workload, and move back once
+// <i> above the exit threshold.
+// <i> Default: 1
+#define LE_CONN_POLICY_CODED_ENABLE  1
+
+// <o LE_CONN_POLICY_CODED_ENTER_RSSI> RSSI to switch to LE Coded [dBm] <-127-20>
+// <i> Default: -85
+#define LE_CONN_POLICY_CODED_ENTER_RSSI  (-85)
+
+// <o LE_CONN_POLICY_CODED_EXIT_RSSI> RSSI to leave LE Coded [dBm] <-127-20>
+// <i> Must be higher than the enter threshold.
+// <i> Default: -75
+#define LE_CONN_POLICY_CODED_EXIT_RSSI  (-75)
+
+// <o LE_CONN_POLICY_RSSI_INTERVAL_S> RSSI poll interval [s] <1-3600>
+// <i> Default: 10
+#define LE_CONN_POLICY_RSSI_INTERVAL_S  10
+
+// </h>
+
+// <h> TX power
+
+// <q LE_CONN_POLICY_TX_POWER_ENABLE> Lower the TX power on strong links
+// <i> The path loss of every connection is estimated from its RSSI and the
+// <i> TX power assumed for the central. After every RSSI poll the TX power
+// <i> steps down towards the lowest level that still reaches the weakest
+// <i> central at the target RSSI, and jumps up as soon as a link gets weaker
+// <i> or a connection is lost to a supervision timeout. The TX power applies
+// <i> to advertising as well, it is back at the maximum whenever a connection
+// <i> opens or the last one closes.
+// <i> Default: 1
+#define LE_CONN_POLICY_TX_POWER_ENABLE  1
+
+// <o LE_CONN_POLICY_TX_POWER_TARGET_RSSI> RSSI to keep at the central [dBm] <-100-0>
+// <i> The link margin is the difference to the receiver sensitivity, about
+// <i> -97 dBm on LE 1M.
+// <i> Default: -70
+#define LE_CONN_POLICY_TX_POWER_TARGET_RSSI  (-70)
+
+// <o LE_CONN_POLICY_TX_POWER_PEER_DBM> TX power assumed for the central [dBm] <-20-20>
+// <i> Default: 0
+#define LE_CONN_POLICY_TX_POWER_PEER_DBM  0
+
+// <o LE_CONN_POLICY_TX_POWER_STEP> TX power step down per RSSI poll [0.1 dBm] <5-100>
+// <i> Raising the TX power is never stepped.
+// <i> Default: 20
+#define LE_CONN_POLICY_TX_POWER_STEP  20
+
+// </h>
+
+#endif // LE_CONN_POLICY_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @file
+ * @brief Deep sleep configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_DEEP_SLEEP_CONFIG_H
+#define LE_DEEP_SLEEP_CONFIG_H
+
+// <h> Deep sleep
+
+// <q LE_DEEP_SLEEP_ENABLE> Sleep in EM4 between beacon reports
+// <i> Needs the beacon mode. Every wake-up measures one burst window,
+// <i> broadcasts its average a few times, stops the acquisition peripherals
+// <i> and enters EM4 until the BURTC wakes the device up for the next report.
+// <i> The wake-up is a reset, the Bluetooth stack boots again, and the beacon
+// <i> sequence counter survives in the backup RAM. A debugger can only attach
+// <i> while the device is awake.
+// <i> Default: 0
+#define LE_DEEP_SLEEP_ENABLE  0
+
+// <o LE_DEEP_SLEEP_PERIOD_S> Report period [s] <10-86400>
+// <i> Timed by the BURTC on the ULFRCO, within the ULFRCO tolerance.
+// <i> Default: 600
+#define LE_DEEP_SLEEP_PERIOD_S  600
+
+// <o LE_DEEP_SLEEP_SAMPLING_FREQ_HZ> Burst sampling frequency [Hz] <1-1000>
+// <i> Default: 1000
+#define LE_DEEP_SLEEP_SAMPLING_FREQ_HZ  1000
+
+// <o LE_DEEP_SLEEP_NUM_OF_SAMPLES> Samples per burst <1-512>
+// <i> Default: 32
+#define LE_DEEP_SLEEP_NUM_OF_SAMPLES  32
+
+// <o LE_DEEP_SLEEP_BROADCASTS> Advertising events per report <1-255>
+// <i> Default: 3
+#define LE_DEEP_SLEEP_BROADCASTS  3
+
+// <o LE_DEEP_SLEEP_BROADCAST_INTERVAL_MS> Advertising interval of a report [ms] <20-10240>
+// <i> Default: 100
+#define LE_DEEP_SLEEP_BROADCAST_INTERVAL_MS  100
+
+// </h>
+
+#endif // LE_DEEP_SLEEP_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,72 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE energy statistics configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_ENERGY_STATS_CONFIG_H
+#define LE_ENERGY_STATS_CONFIG_H
+
+// <h> Energy statistics
+
+// <q LE_ENERGY_STATS_ENABLE> Estimate the charge spent per reading
+// <i> Track the time spent in every energy mode, the completed windows, the
+// <i> sent notifications and the sensor power-on time, and report them with
+// <i> the estimated charge per reading on the Diagnostics characteristic.
+// <i> Default: 1
+#define LE_ENERGY_STATS_ENABLE  1
+
+// <o LE_ENERGY_STATS_EM0_CURRENT_NA> EM0 current [nA]
+// <i> Default: 1040000 (27 uA/MHz at 38.4 MHz)
+#define LE_ENERGY_STATS_EM0_CURRENT_NA  1040000
+
+// <o LE_ENERGY_STATS_EM1_CURRENT_NA> EM1 current [nA]
+// <i> Default: 650000 (17 uA/MHz at 38.4 MHz)
+#define LE_ENERGY_STATS_EM1_CURRENT_NA  650000
+
+// <o LE_ENERGY_STATS_EM2_CURRENT_NA> EM2 current [nA]
+// <i> Full RAM retention and the LFXO running. Also used for EM3.
+// <i> Default: 1400
+#define LE_ENERGY_STATS_EM2_CURRENT_NA  1400
+
+// <o LE_ENERGY_STATS_NOTIFICATION_CHARGE_NC> Radio charge per notification [nC]
+// <i> Added on top of the energy mode currents for every notification.
+// <i> Default: 6000 (4.1 mA for about 1.5 ms at 0 dBm)
+#define LE_ENERGY_STATS_NOTIFICATION_CHARGE_NC  6000
+
+// <o LE_ENERGY_STATS_SENSOR_CURRENT_NA> Sensor current while powered [nA]
+// <i> Default: 1000000
+#define LE_ENERGY_STATS_SENSOR_CURRENT_NA  1000000
+
+// </h>
+
+#endif // LE_ENERGY_STATS_CONFIG_H
+
+// <<< end of configuration section >>>
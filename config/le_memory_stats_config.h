@@ -0,0 +1,51 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE memory budget statistics configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_MEMORY_STATS_CONFIG_H
+#define LE_MEMORY_STATS_CONFIG_H
+
+// <h> Memory budget
+
+// <q LE_MEMORY_STATS_ENABLE> Report the RAM headroom
+// <i> The unused stack is painted at init and scanned for its high-water
+// <i> mark on every read of the Memory Budget characteristic, next to the
+// <i> high-water mark of the heap, which holds the Bluetooth buffers, and
+// <i> the resources the Bluetooth stack reported exhausted. Used to size
+// <i> SL_STACK_SIZE, SL_HEAP_SIZE and SL_BT_CONFIG_BUFFER_SIZE.
+// <i> Default: 1
+#define LE_MEMORY_STATS_ENABLE  1
+
+// </h>
+
+#endif // LE_MEMORY_STATS_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,64 @@
+/***************************************************************************//**
+ * @file
+ * @brief OTA update configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_OTA_CONFIG_H
+#define LE_OTA_CONFIG_H
+
+// <h> OTA update
+
+// <q LE_OTA_IN_APP_ENABLE> Receive the image in the application
+// <i> The image is written to the OTA Data characteristic on the running
+// <i> application, with sampling suspended and the bulk connection
+// <i> parameters, and stored in the bootloader storage slot. Needs a
+// <i> bootloader with a storage slot large enough for the image, otherwise
+// <i> the device reboots into the AppLoader like when disabled. Remove the
+// <i> OTA Data characteristic from ota_dfu.xml when disabled, so OTA clients
+// <i> reconnect to the AppLoader instead.
+// <i> Default: 1
+#define LE_OTA_IN_APP_ENABLE  1
+
+// <o LE_OTA_STAGING_SIZE> Staging buffer size in bytes <256-8192:4>
+// <i> Chunks are collected in RAM and written to the storage slot in
+// <i> batches of this size, so every flash page is erased once and written
+// <i> in a few large writes. Must divide the flash page size.
+// <i> Default: 1024
+#define LE_OTA_STAGING_SIZE  1024
+
+// <o LE_OTA_STORAGE_SLOT> Bootloader storage slot <0-7>
+// <i> Default: 0
+#define LE_OTA_STORAGE_SLOT  0
+
+// </h>
+
+#endif // LE_OTA_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE periodic advertising configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_PERIODIC_ADV_CONFIG_H
+#define LE_PERIODIC_ADV_CONFIG_H
+
+#define LE_PERIODIC_ADV_PHY_1M  1
+#define LE_PERIODIC_ADV_PHY_2M  2
+
+// <h> Periodic advertising
+
+// <q LE_PERIODIC_ADV_ENABLE> Publish the latest windows in a periodic advertising train
+// <i> A second, non-connectable advertising set carries the latest window
+// <i> summaries in its periodic advertising data. Any number of scanners can
+// <i> synchronize to the train and receive every report at a known time
+// <i> with a low scan duty cycle, without connecting. The legacy advertising
+// <i> keeps serving discovery and connections. Not available in deep sleep
+// <i> mode. The train is not sealed.
+// <i> Default: 1
+#define LE_PERIODIC_ADV_ENABLE  1
+
+// <o LE_PERIODIC_ADV_INTERVAL_MS> Periodic advertising interval [ms] <0-81910>
+// <i> 0 follows the window period of the configuration at start-up, other
+// <i> values are rounded down to the 1.25 ms unit, at least 7.5 ms. Every
+// <i> event repeats the latest data until the next window completes.
+// <i> Default: 0
+#define LE_PERIODIC_ADV_INTERVAL_MS  0
+
+// <o LE_PERIODIC_ADV_BATCH> Window summaries per train event <1-16>
+// <i> The latest windows are repeated, newest first, so a synchronized
+// <i> scanner missing a few events loses no window.
+// <i> Default: 4
+#define LE_PERIODIC_ADV_BATCH  4
+
+// <o LE_PERIODIC_ADV_EXT_INTERVAL_MS> Extended advertising interval [ms] <20-10240>
+// <i> Extended advertisements lead new scanners to the train. Synchronized
+// <i> scanners do not listen to them.
+// <i> Default: 1000
+#define LE_PERIODIC_ADV_EXT_INTERVAL_MS  1000
+
+// <o LE_PERIODIC_ADV_SECONDARY_PHY> PHY of the train
+//   <LE_PERIODIC_ADV_PHY_1M=> 1M
+//   <LE_PERIODIC_ADV_PHY_2M=> 2M
+// <i> 2M halves the air time of every event, 1M has the longer range. The
+// <i> extended advertisements always start on 1M.
+// <i> Default: LE_PERIODIC_ADV_PHY_1M
+#define LE_PERIODIC_ADV_SECONDARY_PHY  LE_PERIODIC_ADV_PHY_1M
+
+// </h>
+
+#endif // LE_PERIODIC_ADV_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE neighbor relay configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_RELAY_CONFIG_H
+#define LE_RELAY_CONFIG_H
+
+// <h> Neighbor relay
+
+// <q LE_RELAY_ENABLE> Relay the voltage beacons of neighbors
+// <i> The node scans for the voltage beacons of other nodes, keeps the
+// <i> latest frame of each and notifies the new ones together on the
+// <i> Neighbor Report characteristic, so one gateway connection collects
+// <i> the readings of nodes out of its range. Sealed frames are relayed as
+// <i> they are. The scanner keeps the radio receiving: for mains-powered
+// <i> nodes only. Not available in beacon mode.
+// <i> Default: 0
+#define LE_RELAY_ENABLE  0
+
+// <o LE_RELAY_MAX_NEIGHBORS> Neighbors tracked <1-128>
+// <i> Once the table is full, the neighbor heard from least recently makes
+// <i> room for a new one.
+// <i> Default: 32
+#define LE_RELAY_MAX_NEIGHBORS  32
+
+// <o LE_RELAY_SCAN_INTERVAL_MS> Scan interval [ms] <3-10240>
+// <i> Default: 100
+#define LE_RELAY_SCAN_INTERVAL_MS  100
+
+// <o LE_RELAY_SCAN_WINDOW_MS> Scan window [ms] <3-10240>
+// <i> At most the scan interval, equal to it to scan continuously.
+// <i> Default: 100
+#define LE_RELAY_SCAN_WINDOW_MS  100
+
+// <o LE_RELAY_REPORT_INTERVAL_MS> Report interval [ms] <100-60000>
+// <i> New readings are collected for this long and notified together, as
+// <i> many per notification as the ATT MTU allows.
+// <i> Default: 1000
+#define LE_RELAY_REPORT_INTERVAL_MS  1000
+
+// </h>
+
+#endif // LE_RELAY_CONFIG_H
+
+// <<< end of configuration section >>>
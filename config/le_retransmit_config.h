@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE window retransmission configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_RETRANSMIT_CONFIG_H
+#define LE_RETRANSMIT_CONFIG_H
+
+// <h> Window retransmission
+
+// <q LE_RETRANSMIT_ENABLE> Send recent windows again on request
+// <i> The latest windows are kept in RAM. A client that sees a gap in the
+// <i> window sequence numbers writes the missing range to the Window Request
+// <i> characteristic and gets the windows still held notified on it, in the
+// <i> Average Voltage Data format. Needs LE_VOLTAGE_REPORT_SEQUENCE_ENABLE.
+// <i> Default: 1
+#define LE_RETRANSMIT_ENABLE  1
+
+// <o LE_RETRANSMIT_HISTORY_SIZE> Windows kept <1-1024>
+// <i> Every window takes one window summary of RAM, 28 bytes without scan
+// <i> mode.
+// <i> Default: 64
+#define LE_RETRANSMIT_HISTORY_SIZE  64
+
+// <o LE_RETRANSMIT_DRAIN_INTERVAL_MS> Response poll interval [ms] <1-1000>
+// <i> Notifications are queued until the stack runs out of buffers, then
+// <i> retried after this interval.
+// <i> Default: 10
+#define LE_RETRANSMIT_DRAIN_INTERVAL_MS  10
+
+// </h>
+
+#endif // LE_RETRANSMIT_CONFIG_H
+
+// <<< end of configuration section >>>
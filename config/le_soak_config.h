@@ -0,0 +1,52 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE soak test configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_SOAK_CONFIG_H
+#define LE_SOAK_CONFIG_H
+
+// <h> Soak test
+
+// <q LE_SOAK_ENABLE> Count the load of the window path
+// <i> Counts the delivered and the lost windows, the notifications accepted
+// <i> and refused by the stack, the notifications the transmit queue dropped
+// <i> and its deepest backlog, and the DWT cycles the main loop spends on
+// <i> each window. Read from the Soak characteristic, usually together with
+// <i> LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE to find the highest window rate a
+// <i> node sustains. Compiled out when disabled.
+// <i> Default: 0
+#define LE_SOAK_ENABLE  0
+
+// </h>
+
+#endif // LE_SOAK_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,67 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE window time synchronization configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_TIME_SYNC_CONFIG_H
+#define LE_TIME_SYNC_CONFIG_H
+
+// <h> Window time synchronization
+
+// <q LE_TIME_SYNC_ENABLE> Align the windows to a time source
+// <i> The node synchronizes to the periodic advertising train of a time
+// <i> source and trims LETIMER0 so its windows complete on the events of
+// <i> the train. Nodes following the same source sample the same intervals
+// <i> to within a few milliseconds. The train interval must be a whole
+// <i> number of windows, or the window a whole number of train intervals,
+// <i> to within a quarter sampling period per window. The radio receives
+// <i> every event of the train. Needs a continuous acquisition mode, not
+// <i> available with deep sleep or the alarm mode.
+// <i> Default: 0
+#define LE_TIME_SYNC_ENABLE  0
+
+// <o LE_TIME_SYNC_TIMEOUT_MS> Synchronization timeout [ms] <100-163840>
+// <i> The train is given up when none of its events is received for this
+// <i> long, and the node looks for a time source again. Several train
+// <i> intervals at least.
+// <i> Default: 5000
+#define LE_TIME_SYNC_TIMEOUT_MS  5000
+
+// <o LE_TIME_SYNC_MAX_LATENCY_MS> Largest event latency [ms] <1-100>
+// <i> Train events handled further than this from their expected time,
+// <i> e.g. while the main loop was busy, do not move the time base.
+// <i> Default: 4
+#define LE_TIME_SYNC_MAX_LATENCY_MS  4
+
+// </h>
+
+#endif // LE_TIME_SYNC_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE latency trace configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_TRACE_CONFIG_H
+#define LE_TRACE_CONFIG_H
+
+// <h> Latency trace
+
+// <q LE_TRACE_ENABLE> Trace the path of a window
+// <i> DWT cycle stamps are taken when the LDMA interrupt hands a window
+// <i> over, when the main loop dispatches its signal, when the window is
+// <i> reduced and when its notification is accepted. The latest stamps are
+// <i> kept in a RAM ring, and the time between two consecutive points adds
+// <i> up in a histogram. Both are read from the Trace characteristic. The
+// <i> cycle counter stops while the core sleeps. Compiled out when disabled.
+// <i> Default: 0
+#define LE_TRACE_ENABLE  0
+
+// <o LE_TRACE_RING_SIZE> Stamps kept <4-64>
+// <i> Default: 32
+#define LE_TRACE_RING_SIZE  32
+
+// <o LE_TRACE_BIN_SHIFT> Width of the first histogram bin [log2 cycles] <0-16>
+// <i> Bin 0 counts spans below 2^(shift + 1) cycles, every next bin twice
+// <i> as wide, the last one everything above.
+// <i> Default: 8
+#define LE_TRACE_BIN_SHIFT  8
+
+// </h>
+
+#endif // LE_TRACE_CONFIG_H
+
+// <<< end of configuration section >>>
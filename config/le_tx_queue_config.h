@@ -0,0 +1,66 @@
+/***************************************************************************//**
+ * @file
+ * @brief Notification transmit queue configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_TX_QUEUE_CONFIG_H
+#define LE_TX_QUEUE_CONFIG_H
+
+// <h> Notification transmit queue
+
+// <q LE_TX_QUEUE_ENABLE> Retry notifications refused by the stack
+// <i> Window notifications the stack has no buffer for are kept and sent
+// <i> again, in order, as soon as buffers are released. While the queue is
+// <i> congested new windows are held back and leave later in full batches.
+// <i> Default: 1
+#define LE_TX_QUEUE_ENABLE  1
+
+// <o LE_TX_QUEUE_DEPTH> Queued notifications <1-16>
+// <i> Every entry takes the largest notification payload of RAM. Once full,
+// <i> the oldest entry is dropped.
+// <i> Default: 4
+#define LE_TX_QUEUE_DEPTH  4
+
+// <o LE_TX_QUEUE_CONGESTION_DEPTH> Backpressure threshold <1-16>
+// <i> Queued notifications from which new windows are held back.
+// <i> Default: 2
+#define LE_TX_QUEUE_CONGESTION_DEPTH  2
+
+// <o LE_TX_QUEUE_RETRY_INTERVAL_MS> Retry interval [ms] <1-1000>
+// <i> Notifications are sent until the stack refuses one, then retried after
+// <i> this interval.
+// <i> Default: 10
+#define LE_TX_QUEUE_RETRY_INTERVAL_MS  10
+
+// </h>
+
+#endif // LE_TX_QUEUE_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,104 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage beacon configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_BEACON_CONFIG_H
+#define LE_VOLTAGE_BEACON_CONFIG_H
+
+// <h> Beacon
+
+// <q LE_VOLTAGE_BEACON_ENABLE> Broadcast averages instead of accepting connections
+// <i> Every window average is published with a sequence counter in the
+// <i> manufacturer specific data of non-connectable advertisements. The GATT
+// <i> service and the offline log are not used.
+// <i> Default: 0
+#define LE_VOLTAGE_BEACON_ENABLE  0
+
+// <o LE_VOLTAGE_BEACON_INTERVAL_MS> Advertising interval [ms] <100-10240>
+// <i> Non-connectable advertisements are limited to 100 ms and above.
+// <i> Default: 1000
+#define LE_VOLTAGE_BEACON_INTERVAL_MS  1000
+
+// <o LE_VOLTAGE_BEACON_COMPANY_ID> Company identifier <0x0000-0xFFFF>
+// <i> Bluetooth SIG company identifier of the manufacturer specific data.
+// <i> Default: 0x02FF (Silicon Laboratories)
+#define LE_VOLTAGE_BEACON_COMPANY_ID  0x02FF
+
+// </h>
+
+// <h> Sealed frames
+
+// <q LE_VOLTAGE_BEACON_SEAL_ENABLE> Encrypt and authenticate the beacon
+// <i> The average is encrypted with AES-128-CCM by the crypto accelerator,
+// <i> and the company identifier, frame type and a 32-bit frame counter are
+// <i> authenticated with it. The nonce is made of the device unique ID and
+// <i> the frame counter, which never repeats: it continues from a value
+// <i> reserved in NVM3 ahead of use.
+// <i> Default: 1
+#define LE_VOLTAGE_BEACON_SEAL_ENABLE  1
+
+// <o LE_VOLTAGE_BEACON_TAG_SIZE> Authentication tag size [bytes] <4-16:2>
+// <i> Default: 4
+#define LE_VOLTAGE_BEACON_TAG_SIZE  4
+
+// <o LE_VOLTAGE_BEACON_KEY_NVM3_KEY> NVM3 key of the AES-128 key <0x00000-0xFFFFF>
+// <i> The 16-byte key is provisioned into this NVM3 object, e.g. with
+// <i> Simplicity Commander. Loaded once at boot.
+// <i> Default: 0x20020
+#define LE_VOLTAGE_BEACON_KEY_NVM3_KEY  0x20020
+
+// <o LE_VOLTAGE_BEACON_COUNTER_NVM3_KEY> NVM3 key of the frame counter reservation <0x00000-0xFFFFF>
+// <i> Default: 0x20021
+#define LE_VOLTAGE_BEACON_COUNTER_NVM3_KEY  0x20021
+
+// <o LE_VOLTAGE_BEACON_COUNTER_RESERVE> Frame counters reserved per NVM3 write <16-65536>
+// <i> Up to this many counter values are skipped after a reset.
+// <i> Default: 1024
+#define LE_VOLTAGE_BEACON_COUNTER_RESERVE  1024
+
+// <q LE_VOLTAGE_BEACON_DEV_KEY_ENABLE> Fall back to the development key
+// <i> Without a provisioned key the beacon is sealed with the key below,
+// <i> shared by every device built this way. Otherwise the beacon stays
+// <i> off until a key is provisioned.
+// <i> Default: 0
+#define LE_VOLTAGE_BEACON_DEV_KEY_ENABLE  0
+
+// Development key, see LE_VOLTAGE_BEACON_DEV_KEY_ENABLE
+#define LE_VOLTAGE_BEACON_DEV_KEY \
+  { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, \
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F }
+
+// </h>
+
+#endif // LE_VOLTAGE_BEACON_CONFIG_H
+
+// <<< end of configuration section >>>
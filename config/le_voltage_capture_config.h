@@ -0,0 +1,60 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage capture upload configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_CAPTURE_CONFIG_H
+#define LE_VOLTAGE_CAPTURE_CONFIG_H
+
+// <h> Transient capture upload
+
+// <o LE_VOLTAGE_CAPTURE_CHANNEL_SPSM> Simplified protocol/service multiplexer <0x80-0xFF>
+// <i> Dynamic SPSM of the upload channel. A central opening an LE credit
+// <i> based channel on it receives the completed capture, paced by its
+// <i> credits. The capture is released once it has been sent in full.
+// <i> Default: 0x81
+#define LE_VOLTAGE_CAPTURE_CHANNEL_SPSM  0x81
+
+// <o LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU> Largest SDU sent [bytes] <23-1024>
+// <i> Limited further by the SDU size of the central.
+// <i> Default: 512
+#define LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU  512
+
+// <o LE_VOLTAGE_CAPTURE_DRAIN_INTERVAL_MS> Upload poll interval [ms] <1-1000>
+// <i> SDUs are queued until the credits or the stack buffers run out, then
+// <i> retried after this interval.
+// <i> Default: 10
+#define LE_VOLTAGE_CAPTURE_DRAIN_INTERVAL_MS  10
+
+// </h>
+
+#endif // LE_VOLTAGE_CAPTURE_CONFIG_H
+
+// <<< end of configuration section >>>
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage log configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_LOG_CONFIG_H
+#define LE_VOLTAGE_LOG_CONFIG_H
+
+// <h> Offline log
+
+// <q LE_VOLTAGE_LOG_ENABLE> Log windows to NVM3 while nobody is subscribed
+// <i> Sampling keeps running while no central has enabled notifications. The
+// <i> window averages are compressed and appended to NVM3, and can be
+// <i> downloaded through the Log Control and Log Data characteristics.
+// <i> When disabled, sampling stops with the notifications.
+// <i> Default: 1
+#define LE_VOLTAGE_LOG_ENABLE  1
+
+// <o LE_VOLTAGE_LOG_WINDOWS_PER_RECORD> Windows per log record <1-64>
+// <i> Window averages are collected in RAM and written as one NVM3 object
+// <i> once this many have been collected. Fewer, larger records use less
+// <i> flash per window, but more windows are lost on a reset. With
+// <i> timestamps a record of 32 windows is the largest fitting into an NVM3
+// <i> object in the worst case.
+// <i> Default: 32
+#define LE_VOLTAGE_LOG_WINDOWS_PER_RECORD  32
+
+// <o LE_VOLTAGE_LOG_MAX_RECORDS> Maximum number of log records <2-128>
+// <i> Once the log is full the oldest record is overwritten.
+// <i> Default: 64
+#define LE_VOLTAGE_LOG_MAX_RECORDS  64
+
+// <o LE_VOLTAGE_LOG_NVM3_KEY_BASE> First NVM3 key of the log <0x10000-0xFFF00>
+// <i> The log uses LE_VOLTAGE_LOG_MAX_RECORDS consecutive keys.
+// <i> Default: 0x10000
+#define LE_VOLTAGE_LOG_NVM3_KEY_BASE  0x10000
+
+// <o LE_VOLTAGE_LOG_DRAIN_INTERVAL_MS> Download poll interval [ms] <1-1000>
+// <i> While downloading, notifications are queued until the stack runs out of
+// <i> buffers, then retried after this interval.
+// <i> Default: 10
+#define LE_VOLTAGE_LOG_DRAIN_INTERVAL_MS  10
+
+// </h>
+
+// <h> L2CAP channel download
+
+// <q LE_VOLTAGE_LOG_CHANNEL_ENABLE> Download the log over an L2CAP channel
+// <i> A central opening an LE credit based channel on the SPSM below gets the
+// <i> record stream of the Log Data characteristic as channel SDUs, paced by
+// <i> its credits, without the per-notification ATT overhead. Closing the
+// <i> channel stops the download. Needs SL_BT_CONFIG_USER_L2CAP_COC_CHANNELS.
+// <i> Default: 1
+#define LE_VOLTAGE_LOG_CHANNEL_ENABLE  1
+
+// <o LE_VOLTAGE_LOG_CHANNEL_SPSM> Simplified protocol/service multiplexer <0x80-0xFF>
+// <i> Dynamic SPSM the central connects to.
+// <i> Default: 0x80
+#define LE_VOLTAGE_LOG_CHANNEL_SPSM  0x80
+
+// <o LE_VOLTAGE_LOG_CHANNEL_MAX_SDU> Largest SDU sent [bytes] <23-1024>
+// <i> Limited further by the SDU size of the central. The stack segments an
+// <i> SDU into link layer sized PDUs, each taking one credit.
+// <i> Default: 512
+#define LE_VOLTAGE_LOG_CHANNEL_MAX_SDU  512
+
+// </h>
+
+#endif // LE_VOLTAGE_LOG_CONFIG_H
+
+// <<< end of configuration section >>>
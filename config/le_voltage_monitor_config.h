@@ -0,0 +1,435 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage monitor configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_MONITOR_CONFIG_H
+#define LE_VOLTAGE_MONITOR_CONFIG_H
+
+#define LE_VOLTAGE_MONITOR_ACQ_SINGLE_SHOT  0
+#define LE_VOLTAGE_MONITOR_ACQ_PING_PONG    1
+#define LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE   2
+
+#define LE_VOLTAGE_MONITOR_SENSOR_POWER_CONTINUOUS  0
+#define LE_VOLTAGE_MONITOR_SENSOR_POWER_GATED       1
+
+#define LE_VOLTAGE_MONITOR_FILTER_BOXCAR  0
+#define LE_VOLTAGE_MONITOR_FILTER_FIR     1
+
+#define LE_VOLTAGE_MONITOR_WARMUP_NORMAL      0
+#define LE_VOLTAGE_MONITOR_WARMUP_STANDBY     1
+#define LE_VOLTAGE_MONITOR_WARMUP_KEEP_WARM   2
+#define LE_VOLTAGE_MONITOR_WARMUP_AUTO        3
+
+#define LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_COMPARATOR  0
+#define LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_GPIO        1
+
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_RAMP   0
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_NOISE  1
+
+// <h> Acquisition
+
+// <o LE_VOLTAGE_MONITOR_ACQ_MODE> Acquisition mode
+//   <LE_VOLTAGE_MONITOR_ACQ_SINGLE_SHOT=> Single shot (stop after every window)
+//   <LE_VOLTAGE_MONITOR_ACQ_PING_PONG=> Continuous (multi-buffered LDMA)
+//   <LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE=> Hardware averaging (one conversion per window)
+// <i> Single shot stops LETIMER0 and the IADC after every window and restarts
+// <i> them once the application has consumed the result. Continuous mode links
+// <i> LDMA descriptors in a ring so buffers are reduced while the next one is
+// <i> filled.
+// <i> Hardware averaging triggers a single oversampled and digitally averaged
+// <i> conversion per window, so no sample buffer has to be reduced by the CPU.
+// <i> Default: LE_VOLTAGE_MONITOR_ACQ_PING_PONG
+#define LE_VOLTAGE_MONITOR_ACQ_MODE  LE_VOLTAGE_MONITOR_ACQ_PING_PONG
+
+// <o LE_VOLTAGE_MONITOR_NUM_BUFFERS> Continuous mode buffers <2-4>
+// <i> A completed window can still be reduced until this many minus one
+// <i> later windows have completed, so the main loop may fall behind by
+// <i> that many windows before one is lost. Only used in continuous mode.
+// <i> Default: 3
+#define LE_VOLTAGE_MONITOR_NUM_BUFFERS  3
+
+// <o LE_VOLTAGE_MONITOR_HW_AVG_OSR> Hardware averaging oversampling ratio
+//   <iadcCfgOsrHighSpeed2x=> 2x
+//   <iadcCfgOsrHighSpeed4x=> 4x
+//   <iadcCfgOsrHighSpeed8x=> 8x
+//   <iadcCfgOsrHighSpeed16x=> 16x
+//   <iadcCfgOsrHighSpeed32x=> 32x
+//   <iadcCfgOsrHighSpeed64x=> 64x
+// <i> Only used in hardware averaging mode.
+// <i> Default: iadcCfgOsrHighSpeed64x
+#define LE_VOLTAGE_MONITOR_HW_AVG_OSR  iadcCfgOsrHighSpeed64x
+
+// <o LE_VOLTAGE_MONITOR_HW_AVG_DIGAVG> Hardware averaging digital averaging
+//   <iadcDigAvg1=> 1 sample
+//   <iadcDigAvg2=> 2 samples
+//   <iadcDigAvg4=> 4 samples
+//   <iadcDigAvg8=> 8 samples
+//   <iadcDigAvg16=> 16 samples
+// <i> Only used in hardware averaging mode.
+// <i> Default: iadcDigAvg16
+#define LE_VOLTAGE_MONITOR_HW_AVG_DIGAVG  iadcDigAvg16
+
+// <o LE_VOLTAGE_MONITOR_MAX_SAMPLES> Maximum number of samples per window <1-2048>
+// <i> Sizes the sampling buffer(s), two bytes per sample and channel. The
+// <i> window size can be changed at runtime up to this value.
+// <i> Default: 512
+#define LE_VOLTAGE_MONITOR_MAX_SAMPLES  512
+
+// <o LE_VOLTAGE_MONITOR_ARENA_SIZE> Acquisition arena [bytes] <512-24576:4>
+// <i> RAM set aside for the sampling buffer(s), the transient capture ring
+// <i> and the ring of completed windows. The build fails when they do not
+// <i> fit. Continuous acquisition of one channel takes 2 bytes per sample of
+// <i> LE_VOLTAGE_MONITOR_MAX_SAMPLES and buffer, the capture 2 bytes per ring
+// <i> sample.
+// <i> Default: 5632
+#define LE_VOLTAGE_MONITOR_ARENA_SIZE  5632
+
+// <o LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ> Maximum sampling frequency [Hz] <1-10000>
+// <i> Upper bound for the sampling frequency set at runtime.
+// <i> Default: 1000
+#define LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ  1000
+
+// </h>
+
+// <h> IADC operating point
+
+// <o LE_VOLTAGE_MONITOR_WARMUP_POLICY> IADC warmup mode
+//   <LE_VOLTAGE_MONITOR_WARMUP_AUTO=> Automatic (least charge per trigger)
+//   <LE_VOLTAGE_MONITOR_WARMUP_NORMAL=> Normal (off between conversions)
+//   <LE_VOLTAGE_MONITOR_WARMUP_STANDBY=> Keep in standby
+//   <LE_VOLTAGE_MONITOR_WARMUP_KEEP_WARM=> Keep warm
+// <i> Normal powers the IADC down after every conversion and pays the full
+// <i> warmup on the next trigger. Keep in standby shortens the warmup at the
+// <i> cost of a standby current, keep warm removes it and draws the most
+// <i> between conversions. Automatic estimates the charge of one trigger
+// <i> period for every mode from the trigger rate, the conversion time and the
+// <i> currents below, and picks the smallest whenever the window
+// <i> configuration changes.
+// <i> Default: LE_VOLTAGE_MONITOR_WARMUP_AUTO
+#define LE_VOLTAGE_MONITOR_WARMUP_POLICY  LE_VOLTAGE_MONITOR_WARMUP_AUTO
+
+// <o LE_VOLTAGE_MONITOR_IADC_ACTIVE_UA> IADC current while warming up or converting [uA] <1-1000>
+// <i> Used by the automatic warmup mode.
+// <i> Default: 290
+#define LE_VOLTAGE_MONITOR_IADC_ACTIVE_UA  290
+
+// <o LE_VOLTAGE_MONITOR_IADC_STANDBY_UA> IADC current in standby [uA] <0-1000>
+// <i> Used by the automatic warmup mode.
+// <i> Default: 10
+#define LE_VOLTAGE_MONITOR_IADC_STANDBY_UA  10
+
+// <o LE_VOLTAGE_MONITOR_IADC_KEEP_WARM_UA> IADC current kept warm [uA] <0-1000>
+// <i> Used by the automatic warmup mode.
+// <i> Default: 50
+#define LE_VOLTAGE_MONITOR_IADC_KEEP_WARM_UA  50
+
+// </h>
+
+// <h> Filter
+
+// <o LE_VOLTAGE_MONITOR_FILTER> Window filter
+//   <LE_VOLTAGE_MONITOR_FILTER_BOXCAR=> Plain average
+//   <LE_VOLTAGE_MONITOR_FILTER_FIR=> Decimating FIR, then average
+// <i> The plain average weighs all samples of a window equally. The FIR
+// <i> low-pass filters and decimates the sensor samples in place first, with
+// <i> a parabolic kernel that attenuates interference above the output rate
+// <i> better, and reports the average of its outputs. Minimum, maximum, RMS
+// <i> and deviation always describe the unfiltered samples. Not available in
+// <i> hardware averaging mode.
+// <i> Default: LE_VOLTAGE_MONITOR_FILTER_BOXCAR
+#define LE_VOLTAGE_MONITOR_FILTER  LE_VOLTAGE_MONITOR_FILTER_BOXCAR
+
+// <o LE_VOLTAGE_MONITOR_FIR_TAPS> FIR taps <2-32>
+// <i> Default: 16
+#define LE_VOLTAGE_MONITOR_FIR_TAPS  16
+
+// <o LE_VOLTAGE_MONITOR_FIR_DECIMATION> FIR decimation <1-32>
+// <i> One output every this many samples, usually half the number of taps.
+// <i> Windows shorter than the kernel are averaged plainly.
+// <i> Default: 8
+#define LE_VOLTAGE_MONITOR_FIR_DECIMATION  8
+
+// <o LE_VOLTAGE_MONITOR_IIR_SHIFT> Running estimate smoothing <0-8>
+// <i> The running estimate follows the window averages through a single-pole
+// <i> IIR low-pass with a coefficient of 2^-shift. 0 disables the smoothing.
+// <i> Default: 3
+#define LE_VOLTAGE_MONITOR_IIR_SHIFT  3
+
+// </h>
+
+// <h> Inputs
+
+// <q LE_VOLTAGE_MONITOR_SCAN_ENABLE> Convert several inputs per trigger
+// <i> Use an IADC scan table instead of the single input. Every LETIMER0
+// <i> trigger converts the first LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS entries
+// <i> of the channel table in le_voltage_monitor_variant_config.h, by
+// <i> default: the sensor input (PC2), AVDD, the second sensor input (PC3)
+// <i> and DVDD. Every notification entry then carries the averages of all
+// <i> channels, which needs the raw payload format.
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_SCAN_ENABLE  0
+
+// <o LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS> Number of scan channels <1-4>
+// <i> At most the number of entries of the channel table.
+// <i> Default: 3
+#define LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS  3
+
+// <o LE_VOLTAGE_MONITOR_CFG0_ANALOG_GAIN> Sensor inputs analog gain
+//   <iadcCfgAnalogGain0P5x=> 0.5x
+//   <iadcCfgAnalogGain1x=> 1x
+//   <iadcCfgAnalogGain2x=> 2x
+//   <iadcCfgAnalogGain3x=> 3x
+//   <iadcCfgAnalogGain4x=> 4x
+// <i> IADC configuration 0, referenced to AVDD. Used by the sensor inputs.
+// <i> Default: iadcCfgAnalogGain1x
+#define LE_VOLTAGE_MONITOR_CFG0_ANALOG_GAIN  iadcCfgAnalogGain1x
+
+// <o LE_VOLTAGE_MONITOR_CFG1_OSR> Supply inputs oversampling ratio
+//   <iadcCfgOsrHighSpeed2x=> 2x
+//   <iadcCfgOsrHighSpeed4x=> 4x
+//   <iadcCfgOsrHighSpeed8x=> 8x
+//   <iadcCfgOsrHighSpeed16x=> 16x
+//   <iadcCfgOsrHighSpeed32x=> 32x
+//   <iadcCfgOsrHighSpeed64x=> 64x
+// <i> IADC configuration 1, referenced to the internal 1.21 V reference.
+// <i> Used by the AVDD and DVDD scan channels.
+// <i> Default: iadcCfgOsrHighSpeed2x
+#define LE_VOLTAGE_MONITOR_CFG1_OSR  iadcCfgOsrHighSpeed2x
+
+// <o LE_VOLTAGE_MONITOR_CFG1_ANALOG_GAIN> Supply inputs analog gain
+//   <iadcCfgAnalogGain0P5x=> 0.5x
+//   <iadcCfgAnalogGain1x=> 1x
+//   <iadcCfgAnalogGain2x=> 2x
+//   <iadcCfgAnalogGain3x=> 3x
+//   <iadcCfgAnalogGain4x=> 4x
+// <i> Default: iadcCfgAnalogGain1x
+#define LE_VOLTAGE_MONITOR_CFG1_ANALOG_GAIN  iadcCfgAnalogGain1x
+
+// </h>
+
+// <h> Calibration
+
+// <q LE_VOLTAGE_MONITOR_CAL_ENABLE> Correct the sensor inputs with a stored calibration
+// <i> On the first boot AVDD is measured against the internal 1.21 V
+// <i> reference and the offset of configuration 0 on a grounded input. Both
+// <i> are kept in NVM3 and loaded on every later boot, the millivolt scaling
+// <i> of the sensor inputs uses the measured AVDD instead of its nominal
+// <i> 3.3 V and removes the offset. A change of the resolution or of the
+// <i> sensor inputs analog gain calibrates again.
+// <i> Default: 1
+#define LE_VOLTAGE_MONITOR_CAL_ENABLE  1
+
+// <o LE_VOLTAGE_MONITOR_CAL_CONVERSIONS> Conversions averaged per calibration input <1-256>
+// <i> Default: 16
+#define LE_VOLTAGE_MONITOR_CAL_CONVERSIONS  16
+
+// <o LE_VOLTAGE_MONITOR_CAL_NVM3_KEY> NVM3 key of the calibration <0x10000-0xFFFFF>
+// <i> Must not overlap the log keys or the change filter settings.
+// <i> Default: 0x20010
+#define LE_VOLTAGE_MONITOR_CAL_NVM3_KEY  0x20010
+
+// </h>
+
+// <h> Sensor power
+
+// <o LE_VOLTAGE_MONITOR_SENSOR_POWER> Sensor power mode
+//   <LE_VOLTAGE_MONITOR_SENSOR_POWER_CONTINUOUS=> On while sampling
+//   <LE_VOLTAGE_MONITOR_SENSOR_POWER_GATED=> Gated around every conversion
+// <i> Continuous drives the sensor power pin high from the start to the stop
+// <i> of the sampling. Gated lets LETIMER0 output 1 drive the pin through PRS,
+// <i> switching the sensor on ahead of every IADC trigger and off after the
+// <i> conversion, without waking the CPU.
+// <i> Default: LE_VOLTAGE_MONITOR_SENSOR_POWER_GATED
+#define LE_VOLTAGE_MONITOR_SENSOR_POWER  LE_VOLTAGE_MONITOR_SENSOR_POWER_GATED
+
+// <o LE_VOLTAGE_MONITOR_SENSOR_SETTLE_US> Settle time before the conversion [us] <31-1000000>
+// <i> Only used in gated mode. Rounded up to LETIMER0 clock periods.
+// <i> Default: 500
+#define LE_VOLTAGE_MONITOR_SENSOR_SETTLE_US  500
+
+// <o LE_VOLTAGE_MONITOR_SENSOR_HOLD_US> Hold time after the conversion [us] <0-1000000>
+// <i> Only used in gated mode. The sensor stays on for the conversion time,
+// <i> which follows from the IADC settings, plus this margin.
+// <i> Default: 30
+#define LE_VOLTAGE_MONITOR_SENSOR_HOLD_US  30
+
+// </h>
+
+// <h> Alarm
+
+// <q LE_VOLTAGE_MONITOR_ALARM_ENABLE> Window comparator alarm mode
+// <i> The IADC window comparator watches every conversion of the sensor input
+// <i> and interrupts only when it leaves the band between the low and the high
+// <i> threshold, and again once it has returned into the band narrowed by the
+// <i> hysteresis on both sides. No windows complete in this mode, so there are
+// <i> no periodic notifications and no log or beacon data. Requires the
+// <i> continuous or hardware averaging acquisition mode and a single input.
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_ALARM_ENABLE  0
+
+// <o LE_VOLTAGE_MONITOR_ALARM_LOW_MV> Low threshold [mV] <0-65535>
+// <i> Default: 1000
+#define LE_VOLTAGE_MONITOR_ALARM_LOW_MV  1000
+
+// <o LE_VOLTAGE_MONITOR_ALARM_HIGH_MV> High threshold [mV] <0-65535>
+// <i> Default: 2500
+#define LE_VOLTAGE_MONITOR_ALARM_HIGH_MV  2500
+
+// <o LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV> Hysteresis [mV] <0-65535>
+// <i> Default: 50
+#define LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV  50
+
+// </h>
+
+// <h> Transient capture
+
+// <q LE_VOLTAGE_MONITOR_CAPTURE_ENABLE> Capture transients at a high rate
+// <i> Once armed, window sampling is suspended and the sensor input is
+// <i> sampled at the capture rate into a ring kept by a circular LDMA
+// <i> descriptor chain. After a trigger the ring keeps filling until the
+// <i> post-trigger samples are in and is then frozen, holding the samples
+// <i> around the trigger until the capture is released. The sensor stays
+// <i> powered while armed. Requires a single input.
+// <i> Default: 1
+#define LE_VOLTAGE_MONITOR_CAPTURE_ENABLE  1
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ> Capture sampling frequency [Hz] <1-16384>
+// <i> Rounded to LETIMER0 clock periods. The warmup and conversion of a
+// <i> sample have to fit into one period.
+// <i> Default: 4096
+#define LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ  4096
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES> Ring size [samples] <64-8192:4>
+// <i> Two bytes per sample, filled by four linked LDMA descriptors.
+// <i> Default: 1024
+#define LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES  1024
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER> Samples kept ahead of the trigger <1-8192>
+// <i> Triggers are ignored until the ring holds this many samples.
+// <i> Default: 256
+#define LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER  256
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_POST_TRIGGER> Samples recorded from the trigger on <1-8192>
+// <i> The ring is frozen at the end of a descriptor, so pre- and
+// <i> post-trigger samples may take at most three quarters of the ring.
+// <i> Default: 512
+#define LE_VOLTAGE_MONITOR_CAPTURE_POST_TRIGGER  512
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER> Trigger
+//   <LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_COMPARATOR=> Sensor input leaving a band
+//   <LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_GPIO=> GPIO edge
+// <i> The IADC window comparator checks every capture conversion against the
+// <i> band below, without the CPU. The comparator is shared with the alarm
+// <i> mode. A software trigger is always available.
+// <i> Default: LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_COMPARATOR
+#define LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER  LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_COMPARATOR
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_LOW_MV> Low trigger threshold [mV] <0-65535>
+// <i> Default: 500
+#define LE_VOLTAGE_MONITOR_CAPTURE_LOW_MV  500
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_HIGH_MV> High trigger threshold [mV] <0-65535>
+// <i> Default: 3000
+#define LE_VOLTAGE_MONITOR_CAPTURE_HIGH_MV  3000
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PORT> Trigger GPIO port
+//   <gpioPortA=> Port A
+//   <gpioPortB=> Port B
+//   <gpioPortC=> Port C
+//   <gpioPortD=> Port D
+// <i> BTN0 of the BRD4184A is on PB00.
+// <i> Default: gpioPortB
+#define LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PORT  gpioPortB
+
+// <o LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN> Trigger GPIO pin <0-15>
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN  0
+
+// <q LE_VOLTAGE_MONITOR_CAPTURE_GPIO_FALLING> Trigger on the falling edge
+// <i> The pin is pulled towards the other level.
+// <i> Default: 1
+#define LE_VOLTAGE_MONITOR_CAPTURE_GPIO_FALLING  1
+
+// </h>
+
+// <h> Synthetic source
+
+// <q LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE> Generate the samples instead of converting them
+// <i> For soak tests without an analog input. The LDMA copies a generated
+// <i> waveform into the sampling buffers, one sample per LETIMER0 period in
+// <i> place of the conversion, so the windows take the same LDMA, interrupt
+// <i> and event path at the configured rate. The IADC stays idle, and the
+// <i> device does not go below EM1 while sampling. A scan takes consecutive
+// <i> samples, one per channel. Not available in hardware averaging or
+// <i> alarm mode. For the highest window rates raise
+// <i> LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ and shorten the windows.
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE  0
+
+// <o LE_VOLTAGE_MONITOR_SYNTHETIC_WAVEFORM> Waveform
+//   <LE_VOLTAGE_MONITOR_SYNTHETIC_RAMP=> Ramp
+//   <LE_VOLTAGE_MONITOR_SYNTHETIC_NOISE=> Noise
+// <i> A sawtooth from the low to the high level, or uniform pseudo-random
+// <i> noise between them.
+// <i> Default: LE_VOLTAGE_MONITOR_SYNTHETIC_RAMP
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_WAVEFORM  LE_VOLTAGE_MONITOR_SYNTHETIC_RAMP
+
+// <o LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD> Waveform period [samples] <4-1024:2>
+// <i> The waveform runs on from one window to the next. Its table takes the
+// <i> period plus the largest buffer, two bytes per sample, of the
+// <i> acquisition arena.
+// <i> Default: 100
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD  100
+
+// <o LE_VOLTAGE_MONITOR_SYNTHETIC_LOW_MV> Low level [mV] <0-65535>
+// <i> Default: 500
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_LOW_MV  500
+
+// <o LE_VOLTAGE_MONITOR_SYNTHETIC_HIGH_MV> High level [mV] <0-65535>
+// <i> Default: 3000
+#define LE_VOLTAGE_MONITOR_SYNTHETIC_HIGH_MV  3000
+
+// </h>
+
+// <h> Profiling
+
+// <q LE_VOLTAGE_MONITOR_PROFILE_ENABLE> Count the cycles of the window reduction
+// <i> Measure every window reduction, including the filter, with the DWT
+// <i> cycle counter. The last and the largest count are appended to the
+// <i> Diagnostics characteristic.
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_PROFILE_ENABLE  0
+
+// </h>
+
+#endif // LE_VOLTAGE_MONITOR_CONFIG_H
+
+// <<< end of configuration section >>>
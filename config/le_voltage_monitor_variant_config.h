@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage monitor product variant configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_MONITOR_VARIANT_CONFIG_H
+#define LE_VOLTAGE_MONITOR_VARIANT_CONFIG_H
+
+// <h> Sensor power
+
+// <o LE_VOLTAGE_MONITOR_SENSOR_POWER_PORT> Sensor power GPIO port
+//   <gpioPortA=> Port A
+//   <gpioPortB=> Port B
+//   <gpioPortC=> Port C
+//   <gpioPortD=> Port D
+// <i> Driven by LETIMER0 through PRS when the sensor is gated.
+// <i> Default: gpioPortC
+#define LE_VOLTAGE_MONITOR_SENSOR_POWER_PORT  gpioPortC
+
+// <o LE_VOLTAGE_MONITOR_SENSOR_POWER_PIN> Sensor power GPIO pin <0-15>
+// <i> Default: 1
+#define LE_VOLTAGE_MONITOR_SENSOR_POWER_PIN  1
+
+// </h>
+
+// <h> Peripheral channels
+
+// <o LE_VOLTAGE_MONITOR_PRS_CHANNEL_IADC> PRS channel triggering the IADC <0-11>
+// <i> CH7 is used by the Bluetooth stack.
+// <i> Default: 1
+#define LE_VOLTAGE_MONITOR_PRS_CHANNEL_IADC  1
+
+// <o LE_VOLTAGE_MONITOR_PRS_CHANNEL_GPIO> PRS channel driving the sensor power pin <0-11>
+// <i> Only CH0 to CH5 can be routed to port A/B, and CH6 to CH11 to
+// <i> port C/D. CH7 is used by the Bluetooth stack.
+// <i> Default: 6
+#define LE_VOLTAGE_MONITOR_PRS_CHANNEL_GPIO  6
+
+// <o LE_VOLTAGE_MONITOR_LDMA_CHANNEL> LDMA channel moving the results <0-7>
+// <i> Default: 0
+#define LE_VOLTAGE_MONITOR_LDMA_CHANNEL  0
+
+// </h>
+
+// Input channels, in scan order. The single mode converts entry 0, the scan
+// mode the first LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS entries. One
+//   X(index, pos_input, bus, bus_alloc, config_id, divider)
+// per entry, index counting from 0:
+// - pos_input: positive IADC input, the negative one is ground
+// - bus, bus_alloc: GPIO analog bus register of the pin and its IADC0
+//   allocation, 0 for the internal inputs
+// - config_id: IADC configuration 0, the sensor inputs referenced to AVDD,
+//   or 1, the supply inputs referenced to the internal 1.21 V reference.
+//   Their gain and OSR are set in le_voltage_monitor_config.h.
+// - divider: division of the input ahead of the IADC, AVDD and DVDD are
+//   divided by 4
+// The table is expanded into the init and reduction code, so everything
+// of a variant is resolved at build time.
+#define LE_VOLTAGE_MONITOR_CHANNELS(X)                                      \
+  X(0, iadcPosInputPortCPin2, ABUSALLOC,  GPIO_ABUSALLOC_AEVEN0_ADC0,  0, 1) \
+  X(1, iadcPosInputAvdd,      ABUSALLOC,  0,                           1, 4) \
+  X(2, iadcPosInputPortCPin3, CDBUSALLOC, GPIO_CDBUSALLOC_CDODD0_ADC0, 0, 1) \
+  X(3, iadcPosInputDvdd,      ABUSALLOC,  0,                           1, 4)
+
+#endif // LE_VOLTAGE_MONITOR_VARIANT_CONFIG_H
+
+// <<< end of configuration section >>>
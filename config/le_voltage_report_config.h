@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file
+ * @brief LE voltage report configuration file.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+#ifndef LE_VOLTAGE_REPORT_CONFIG_H
+#define LE_VOLTAGE_REPORT_CONFIG_H
+
+#define LE_VOLTAGE_REPORT_FORMAT_RAW         0
+#define LE_VOLTAGE_REPORT_FORMAT_COMPRESSED  1
+
+// <h> Notifications
+
+// <q LE_VOLTAGE_REPORT_BATCHING_ENABLE> Batch several windows per notification
+// <i> Queue consecutive window summaries and send them in a single
+// <i> notification sized to the negotiated ATT MTU. When disabled, every
+// <i> window is notified on its own.
+// <i> Default: 1
+#define LE_VOLTAGE_REPORT_BATCHING_ENABLE  1
+
+// <o LE_VOLTAGE_REPORT_FORMAT> Payload format
+//   <LE_VOLTAGE_REPORT_FORMAT_RAW=> Big-endian 16-bit values
+//   <LE_VOLTAGE_REPORT_FORMAT_COMPRESSED=> Header, base value and signed deltas
+// <i> The raw format is a plain sequence of big-endian 16-bit entries. The
+// <i> compressed format starts with a header byte holding the encoding and the
+// <i> sample count, followed by the first average and the 8-bit or 4-bit
+// <i> deltas between consecutive averages.
+// <i> Default: LE_VOLTAGE_REPORT_FORMAT_COMPRESSED
+#define LE_VOLTAGE_REPORT_FORMAT  LE_VOLTAGE_REPORT_FORMAT_COMPRESSED
+
+// <q LE_VOLTAGE_REPORT_MIN_MAX_ENABLE> Include window minimum and maximum
+// <i> Every entry carries the minimum and maximum sample of the window in
+// <i> addition to the average. Only supported by the raw payload format.
+// <i> Default: 0
+#define LE_VOLTAGE_REPORT_MIN_MAX_ENABLE  0
+
+// <o LE_VOLTAGE_REPORT_MAX_BATCH> Maximum number of windows per notification <1-122>
+// <i> Size of the summary ring buffer. The batch depth used on a connection
+// <i> is further limited by the ATT MTU. The compressed format carries at most
+// <i> 64 windows per notification.
+// <i> Default: 64
+#define LE_VOLTAGE_REPORT_MAX_BATCH  64
+
+// <q LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE> Timestamp the windows
+// <i> Every notification and log record starts with a timestamp block: the
+// <i> completion time of its first window, the time between consecutive
+// <i> windows, and how long ago the newest window completed when the payload
+// <i> was built. This lets the receiver correct the delivery latency and
+// <i> align the readings of several nodes.
+// <i> Default: 1
+#define LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE  1
+
+// <q LE_VOLTAGE_REPORT_SEQUENCE_ENABLE> Number the windows
+// <i> Every notification starts with the sequence number of its first
+// <i> window, and its windows are numbered without a gap. A gap between
+// <i> notifications shows windows lost on the way, held back by the change
+// <i> filter, or not sampled at all. The extended statistics end with the
+// <i> sequence number of their window.
+// <i> Default: 1
+#define LE_VOLTAGE_REPORT_SEQUENCE_ENABLE  1
+
+// </h>
+
+#endif // LE_VOLTAGE_REPORT_CONFIG_H
+
+// <<< end of configuration section >>>
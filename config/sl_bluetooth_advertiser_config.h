@@ -5,7 +5,7 @@
 // <o SL_BT_CONFIG_USER_ADVERTISERS> Max number of advertising sets reserved for user <0-255>
 // <i> Default: 1
 // <i> Define the number of advertising sets that the application needs to use concurrently.
-#define SL_BT_CONFIG_USER_ADVERTISERS     (1)
+#define SL_BT_CONFIG_USER_ADVERTISERS     (2)
 // <<< end of configuration section >>>
 
 #endif
@@ -0,0 +1,11 @@
+#ifndef SL_BT_PERIODIC_SYNC_CONFIG_H
+#define SL_BT_PERIODIC_SYNC_CONFIG_H
+
+// <<< Use Configuration Wizard in Context Menu >>>
+// <o SL_BT_CONFIG_MAX_PERIODIC_ADVERTISING_SYNC> Max number of periodic advertising synchronizations <0-255>
+// <i> Default: 1
+// <i> Define the number of periodic advertising synchronizations that the application needs to use concurrently.
+#define SL_BT_CONFIG_MAX_PERIODIC_ADVERTISING_SYNC     (1)
+// <<< end of configuration section >>>
+
+#endif
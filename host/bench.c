@@ -0,0 +1,313 @@
+/***************************************************************************//**
+* @file bench.c
+* @brief Host benchmark of the window reduction and the payload encoders.
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "le_window_math.h"
+#include "le_voltage_report.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Benchmark Definitions.
+ ******************************************************************************/
+// 12-bit codes over the 3.3 V range of the original conversion
+#define BENCH_RANGE_MV            3300
+#define BENCH_FULL_SCALE          0xFFF
+
+#define BENCH_MAX_SAMPLES         1024
+#define BENCH_DEFAULT_ITERATIONS  20000
+
+// One window per second of a 32768 Hz sleeptimer
+#define BENCH_TICK_FREQ_HZ        32768
+#define BENCH_WINDOWS             LE_VOLTAGE_REPORT_HDR_MAX_COUNT
+
+// Largest notification payload, an ATT MTU of 247
+#define BENCH_PAYLOAD_LIMIT       244
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static const uint32_t windowSizes[] = { 16, 64, 256, 1024 };
+
+static uint16_t samples[BENCH_MAX_SAMPLES] __attribute__((aligned(4)));
+static le_voltage_monitor_summary_t summaries[BENCH_WINDOWS];
+static uint16_t averages[BENCH_WINDOWS];
+static uint32_t ticks[BENCH_WINDOWS];
+static uint8_t payload[BENCH_PAYLOAD_LIMIT];
+
+// Keeps the results alive
+static volatile uint32_t sink;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Monotonic time in nanoseconds.
+ ******************************************************************************/
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    A slow ramp with a few codes of pseudo-random noise.
+ ******************************************************************************/
+static void fill_samples(void)
+{
+  uint16_t lfsr = 0xACE1;
+
+  for(uint32_t i = 0; i < BENCH_MAX_SAMPLES; i++) {
+    lfsr = (lfsr >> 1) ^ ((lfsr & 1) ? 0xB400 : 0);
+    samples[i] = (uint16_t)(1000 + (i * 2) + (lfsr & 0x0F));
+  }
+
+  for(uint32_t i = 0; i < BENCH_WINDOWS; i++) {
+    summaries[i].avg_mv = (uint16_t)(1200 + (i % 7));
+    summaries[i].min_mv = summaries[i].avg_mv - 20;
+    summaries[i].max_mv = summaries[i].avg_mv + 20;
+    summaries[i].rms_mv = summaries[i].avg_mv;
+    summaries[i].stddev_uv = 5000;
+    summaries[i].running_mv = summaries[i].avg_mv;
+    summaries[i].tick = i * BENCH_TICK_FREQ_HZ;
+    summaries[i].overruns = 0;
+    summaries[i].sequence = i;
+    averages[i] = summaries[i].avg_mv;
+    ticks[i] = summaries[i].tick;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    The per-sample conversion of the original
+ *    le_voltage_monitor_get_average_mv().
+ ******************************************************************************/
+static uint16_t convert_average_mv(const uint16_t *window, uint32_t count)
+{
+  uint32_t avg = 0;
+
+  for(uint32_t i = 0; i < count; i++) {
+    avg += window[i] * BENCH_RANGE_MV / BENCH_FULL_SCALE;
+  }
+  return (uint16_t)(avg / count);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Average of the single-pass reduction, scaled once per window.
+ ******************************************************************************/
+static uint16_t scalar_average_mv(const uint16_t *window, uint32_t count,
+                                  uint32_t factor)
+{
+  le_window_stats_t stats;
+
+  le_window_math_reduce(window, count, 1, &stats);
+  return le_window_math_scale(stats.sum, factor);
+}
+
+
+#if LE_WINDOW_MATH_PACKED_AVAILABLE
+/***************************************************************************//**
+ * @brief
+ *    Average of the packed reduction, scaled once per window.
+ ******************************************************************************/
+static uint16_t packed_average_mv(const uint16_t *window, uint32_t count,
+                                  uint32_t factor)
+{
+  le_window_stats_t stats;
+
+  le_window_math_reduce_packed(window, count, &stats);
+  return le_window_math_scale(stats.sum, factor);
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Time the reductions of every window size.
+ ******************************************************************************/
+static bool bench_reduction(uint32_t iterations)
+{
+  bool agree = true;
+
+  printf("%8s %12s %12s %12s   %s\n",
+         "samples", "convert_ns", "scalar_ns", "packed_ns", "avg_mv convert/scalar/packed");
+
+  for(uint32_t s = 0; s < sizeof(windowSizes) / sizeof(windowSizes[0]); s++) {
+    uint32_t count = windowSizes[s];
+    uint32_t factor = le_window_math_scale_factor(BENCH_RANGE_MV, BENCH_FULL_SCALE, count);
+    uint16_t convert_mv = convert_average_mv(samples, count);
+    uint16_t scalar_mv = scalar_average_mv(samples, count, factor);
+    uint16_t packed_mv = scalar_mv;
+    double convert_ns;
+    double scalar_ns;
+    double packed_ns = 0;
+    uint64_t start;
+
+    start = now_ns();
+    for(uint32_t i = 0; i < iterations; i++) {
+      sink += convert_average_mv(samples, count);
+    }
+    convert_ns = (double)(now_ns() - start) / iterations;
+
+    start = now_ns();
+    for(uint32_t i = 0; i < iterations; i++) {
+      sink += scalar_average_mv(samples, count, factor);
+    }
+    scalar_ns = (double)(now_ns() - start) / iterations;
+
+#if LE_WINDOW_MATH_PACKED_AVAILABLE
+    {
+      le_window_stats_t scalar;
+      le_window_stats_t packed;
+
+      le_window_math_reduce(samples, count, 1, &scalar);
+      le_window_math_reduce_packed(samples, count, &packed);
+      if((scalar.sum != packed.sum) || (scalar.sum_sq != packed.sum_sq)
+         || (scalar.min != packed.min) || (scalar.max != packed.max)) {
+        agree = false;
+      }
+    }
+    packed_mv = packed_average_mv(samples, count, factor);
+
+    start = now_ns();
+    for(uint32_t i = 0; i < iterations; i++) {
+      sink += packed_average_mv(samples, count, factor);
+    }
+    packed_ns = (double)(now_ns() - start) / iterations;
+#endif
+
+    printf("%8lu %12.1f %12.1f %12.1f   %u/%u/%u\n",
+           (unsigned long)count, convert_ns, scalar_ns, packed_ns,
+           convert_mv, scalar_mv, packed_mv);
+  }
+
+  return agree;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Time the payload encoders on the fixed run of windows.
+ ******************************************************************************/
+static void bench_encoders(uint32_t iterations)
+{
+  le_voltage_report_clock_t clock = {
+    ticks[BENCH_WINDOWS - 1] + 100, BENCH_TICK_FREQ_HZ
+  };
+  le_voltage_report_run_t run = { summaries, BENCH_WINDOWS, 0, BENCH_WINDOWS };
+  uint16_t encoded = 0;
+  size_t len = 0;
+  uint64_t start;
+
+  printf("\n%-20s %12s %8s %8s\n", "encoder", "ns", "bytes", "windows");
+
+  start = now_ns();
+  for(uint32_t i = 0; i < iterations; i++) {
+    len = le_voltage_report_encode(averages, BENCH_WINDOWS, payload,
+                                   BENCH_PAYLOAD_LIMIT, &encoded);
+    sink += (uint32_t)len;
+  }
+  printf("%-20s %12.1f %8lu %8u\n", "compressed",
+         (double)(now_ns() - start) / iterations, (unsigned long)len, encoded);
+
+  start = now_ns();
+  for(uint32_t i = 0; i < iterations; i++) {
+    len = le_voltage_report_encode_timestamps(ticks, BENCH_WINDOWS, &clock, payload);
+    sink += (uint32_t)len;
+  }
+  printf("%-20s %12.1f %8lu %8u\n", "timestamps",
+         (double)(now_ns() - start) / iterations, (unsigned long)len, BENCH_WINDOWS);
+
+  // Timestamps, sequence and format as configured for the device
+  start = now_ns();
+  for(uint32_t i = 0; i < iterations; i++) {
+    len = le_voltage_report_build_run(&run, &clock, payload, BENCH_PAYLOAD_LIMIT, &encoded);
+    sink += (uint32_t)len;
+  }
+  printf("%-20s %12.1f %8lu %8u\n", "notification",
+         (double)(now_ns() - start) / iterations, (unsigned long)len, encoded);
+
+  start = now_ns();
+  for(uint32_t i = 0; i < iterations; i++) {
+    len = le_voltage_report_build_extended(&summaries[0], payload);
+    sink += (uint32_t)len;
+  }
+  printf("%-20s %12.1f %8lu %8u\n", "extended",
+         (double)(now_ns() - start) / iterations, (unsigned long)len, 1);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Run the benchmark, optionally with the number of iterations per
+ *    measurement. Fails if the packed and the scalar reduction disagree.
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+  uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+  bool agree;
+
+  if(argc > 1) {
+    iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+    if(iterations == 0) {
+      iterations = 1;
+    }
+  }
+
+  fill_samples();
+  agree = bench_reduction(iterations);
+  bench_encoders(iterations);
+
+  if(!agree) {
+    printf("\npacked and scalar reductions differ\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file cmsis_compiler.h
+ * @brief Portable DSP intrinsics for host builds
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef CMSIS_COMPILER_H
+#define CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+/***************************************************************************//**
+ * @brief
+ *    Plain C versions of the Cortex-M33 DSP instructions used by
+ *    le_window_math_reduce_packed(), so the packed reduction can be checked
+ *    against the scalar one on the host. They say nothing about its speed on
+ *    the target, the DWT profile does.
+ ******************************************************************************/
+// GE flags of the latest USUB16, one per halfword
+static uint32_t hostGeFlags = 0;
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum)
+{
+  return sum
+         + (uint32_t)((int32_t)(int16_t)(x & 0xFFFF) * (int16_t)(y & 0xFFFF))
+         + (uint32_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t sum)
+{
+  return sum
+         + (uint64_t)(int64_t)((int32_t)(int16_t)(x & 0xFFFF) * (int16_t)(y & 0xFFFF))
+         + (uint64_t)(int64_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+static inline uint32_t __USUB16(uint32_t x, uint32_t y)
+{
+  hostGeFlags = (((x & 0xFFFF) >= (y & 0xFFFF)) ? 1 : 0)
+                | (((x >> 16) >= (y >> 16)) ? 2 : 0);
+  return (((x - y) & 0xFFFF) | (((x >> 16) - (y >> 16)) << 16));
+}
+
+static inline uint32_t __SEL(uint32_t x, uint32_t y)
+{
+  return (((hostGeFlags & 1) ? x : y) & 0xFFFF)
+         | (((hostGeFlags & 2) ? x : y) & 0xFFFF0000);
+}
+
+#endif /* CMSIS_COMPILER_H */
@@ -0,0 +1,155 @@
+/***************************************************************************//**
+* @file le_adv_scheduler.c
+* @brief Advertising scheduler definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_adv_scheduler.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_bluetooth.h"
+
+// Advertising interval in units of 0.625 ms, duration in units of 10 ms
+#define ADV_INTERVAL(ms)               (((ms) * 8) / 5)
+#define ADV_DURATION(s)                ((s) * 100)
+
+/***************************************************************************//**
+ * @brief
+ *    Advertising stage.
+ ******************************************************************************/
+typedef struct {
+  uint32_t interval;
+  uint16_t duration;
+  uint8_t max_events;
+} adv_stage_t;
+
+static const adv_stage_t stages[] = {
+  [LE_ADV_SCHEDULER_STAGE_FAST] = {
+    ADV_INTERVAL(LE_ADV_SCHEDULER_FAST_INTERVAL_MS),
+    ADV_DURATION(LE_ADV_SCHEDULER_FAST_DURATION_S),
+    0
+  },
+  [LE_ADV_SCHEDULER_STAGE_SLOW] = {
+    ADV_INTERVAL(LE_ADV_SCHEDULER_SLOW_INTERVAL_MS),
+    ADV_DURATION(LE_ADV_SCHEDULER_SLOW_DURATION_S),
+    LE_ADV_SCHEDULER_SLOW_MAX_EVENTS
+  },
+};
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint8_t stage = LE_ADV_SCHEDULER_STAGE_IDLE;
+static uint8_t advertisingSet = 0xff;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Advertise with the timing of the current stage.
+ ******************************************************************************/
+static sl_status_t start_stage(void)
+{
+  const adv_stage_t *timing = &stages[stage];
+  sl_status_t sc;
+
+  // The stack raises sl_bt_evt_advertiser_timeout_id at the end of the stage
+  sc = sl_bt_advertiser_set_timing(advertisingSet,
+                                   timing->interval,
+                                   timing->interval,
+                                   timing->duration,
+                                   timing->max_events);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_advertiser_start(advertisingSet,
+                                advertiser_general_discoverable,
+                                advertiser_connectable_scannable);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start connectable advertising from the fast stage.
+ ******************************************************************************/
+sl_status_t le_adv_scheduler_start(uint8_t advertising_set)
+{
+  advertisingSet = advertising_set;
+  stage = LE_ADV_SCHEDULER_STAGE_FAST;
+
+  return start_stage();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Move to the next stage once the advertising set timed out.
+ ******************************************************************************/
+sl_status_t le_adv_scheduler_on_timeout(uint8_t advertising_set)
+{
+  if((advertising_set != advertisingSet)
+     || (stage == LE_ADV_SCHEDULER_STAGE_IDLE)) {
+    return SL_STATUS_OK;
+  }
+
+  stage++;
+  if(stage == LE_ADV_SCHEDULER_STAGE_IDLE) {
+    // Nobody came back, keep sampling without advertising
+    return SL_STATUS_OK;
+  }
+
+  return start_stage();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Note that the advertising set stopped because a central connected.
+ ******************************************************************************/
+void le_adv_scheduler_stop(void)
+{
+  stage = LE_ADV_SCHEDULER_STAGE_IDLE;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the current stage.
+ ******************************************************************************/
+uint8_t le_adv_scheduler_get_stage(void)
+{
+  return stage;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file le_adv_scheduler.h
+ * @brief Advertising scheduler interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_ADV_SCHEDULER_H_
+#define LE_ADV_SCHEDULER_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "le_adv_scheduler_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Advertising stages.
+ ******************************************************************************/
+#define LE_ADV_SCHEDULER_STAGE_FAST     0
+#define LE_ADV_SCHEDULER_STAGE_SLOW     1
+#define LE_ADV_SCHEDULER_STAGE_IDLE     2
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start connectable advertising from the fast stage.
+ *
+ * @param[in] advertising_set
+ *    Advertising set handle.
+ *
+ * @return
+ *    Status of the advertiser commands.
+ ******************************************************************************/
+sl_status_t le_adv_scheduler_start(uint8_t advertising_set);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Move to the next stage once the advertising set timed out.
+ *
+ * @param[in] advertising_set
+ *    Advertising set handle of the timeout event.
+ *
+ * @return
+ *    Status of the advertiser commands.
+ ******************************************************************************/
+sl_status_t le_adv_scheduler_on_timeout(uint8_t advertising_set);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Note that the advertising set stopped because a central connected.
+ ******************************************************************************/
+void le_adv_scheduler_stop(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the current stage.
+ *
+ * @return
+ *    LE_ADV_SCHEDULER_STAGE_FAST, _SLOW or _IDLE.
+ ******************************************************************************/
+uint8_t le_adv_scheduler_get_stage(void);
+
+#endif /* LE_ADV_SCHEDULER_H_ */
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+* @file le_bonding.c
+* @brief Bonding definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_bonding.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/***************************************************************************//**
+ * @brief
+ *    Bonding database policy: replace the oldest bonding once full.
+ ******************************************************************************/
+#define BONDING_POLICY_REPLACE_OLDEST   0x01
+
+
+/***************************************************************************//**
+ * @brief
+ *    Configure the security manager.
+ ******************************************************************************/
+sl_status_t le_bonding_init(void)
+{
+  sl_status_t sc;
+
+  sc = sl_bt_sm_store_bonding_configuration(LE_BONDING_MAX_BONDINGS,
+                                            BONDING_POLICY_REPLACE_OLDEST);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  // No display or keyboard, pairing without confirmation
+  sc = sl_bt_sm_configure(0, sl_bt_sm_io_capability_noinputnooutput);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_sm_set_bondable_mode(1);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Request encryption on a new connection.
+ ******************************************************************************/
+void le_bonding_open(uint8_t connection)
+{
+  // A central refusing to pair keeps the unencrypted link
+  (void)sl_bt_sm_increase_security(connection);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a connection parameters event reports an encrypted link.
+ ******************************************************************************/
+bool le_bonding_is_encrypted(const sl_bt_evt_connection_parameters_t *params)
+{
+  return params->security_mode != sl_bt_connection_mode1_level1;
+}
@@ -0,0 +1,83 @@
+/***************************************************************************//**
+ * @file le_bonding.h
+ * @brief Bonding interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_BONDING_H_
+#define LE_BONDING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+#include "le_bonding_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Configure the security manager: Just Works pairing, bondable, and the
+ *    bonding database size. Call it once the stack has booted.
+ *
+ * @return
+ *    SL_STATUS_OK, or the error of the stack.
+ ******************************************************************************/
+sl_status_t le_bonding_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Request encryption on a new connection, which bonds a new central and
+ *    restores the keys of a bonded one.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_bonding_open(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a connection parameters event reports an encrypted link.
+ *
+ * @param[in] params
+ *    Connection parameters event data.
+ *
+ * @return
+ *    True if the link is encrypted.
+ ******************************************************************************/
+bool le_bonding_is_encrypted(const sl_bt_evt_connection_parameters_t *params);
+
+#endif /* LE_BONDING_H_ */
@@ -0,0 +1,76 @@
+/***************************************************************************//**
+* @file le_byte_order.c
+* @brief Big-endian field definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_byte_order.h"
+#include <stdint.h>
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append a 16-bit value in big-endian byte order.
+ ******************************************************************************/
+uint8_t *le_byte_order_put_u16(uint8_t *p, uint16_t value)
+{
+  p[0] = (value >> 8) & 0x00FF;
+  p[1] = value & 0x00FF;
+  return p + 2;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append a 32-bit value in big-endian byte order.
+ ******************************************************************************/
+uint8_t *le_byte_order_put_u32(uint8_t *p, uint32_t value)
+{
+  p[0] = (value >> 24) & 0x00FF;
+  p[1] = (value >> 16) & 0x00FF;
+  p[2] = (value >> 8) & 0x00FF;
+  p[3] = value & 0x00FF;
+  return p + 4;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Read a 32-bit value in big-endian byte order.
+ ******************************************************************************/
+uint32_t le_byte_order_get_u32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+         | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
@@ -0,0 +1,166 @@
+/***************************************************************************//**
+* @file le_change_filter.c
+* @brief Report-on-change filter definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_change_filter.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "nvm3_default.h"
+#include "sl_sleeptimer.h"
+#include "le_voltage_log_config.h"
+
+#if LE_VOLTAGE_LOG_ENABLE \
+  && (LE_CHANGE_FILTER_NVM3_KEY >= LE_VOLTAGE_LOG_NVM3_KEY_BASE) \
+  && (LE_CHANGE_FILTER_NVM3_KEY < (LE_VOLTAGE_LOG_NVM3_KEY_BASE + LE_VOLTAGE_LOG_MAX_RECORDS))
+#error "LE_CHANGE_FILTER_NVM3_KEY overlaps the log keys"
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint16_t hysteresisMv = LE_CHANGE_FILTER_HYSTERESIS_MV;
+static uint16_t heartbeatS = LE_CHANGE_FILTER_HEARTBEAT_S;
+
+// Last notified average and when it was notified
+static bool haveLast = false;
+static uint16_t lastMv;
+static uint32_t lastTick;
+
+static uint32_t skipped = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize the filter settings.
+ ******************************************************************************/
+void le_change_filter_init(void)
+{
+  uint8_t settings[LE_CHANGE_FILTER_SETTINGS_SIZE];
+  uint32_t type;
+  size_t len;
+
+  // Keep the defaults unless a complete object was stored
+  if((nvm3_getObjectInfo(nvm3_defaultHandle, LE_CHANGE_FILTER_NVM3_KEY, &type, &len) == ECODE_NVM3_OK)
+     && (type == NVM3_OBJECTTYPE_DATA)
+     && (len == sizeof(settings))
+     && (nvm3_readData(nvm3_defaultHandle, LE_CHANGE_FILTER_NVM3_KEY, settings, len) == ECODE_NVM3_OK)) {
+    hysteresisMv = (settings[0] << 8) | settings[1];
+    heartbeatS = (settings[2] << 8) | settings[3];
+  }
+
+  haveLast = false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget the last notified window.
+ ******************************************************************************/
+void le_change_filter_restart(void)
+{
+  haveLast = false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Decide whether a window is notified.
+ ******************************************************************************/
+bool le_change_filter_check(uint16_t avg_mv)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint16_t change;
+
+  if(haveLast) {
+    change = (avg_mv > lastMv) ? (avg_mv - lastMv) : (lastMv - avg_mv);
+
+    // Wrap-safe, the heartbeat interval is well below the tick counter range
+    if((change < hysteresisMv)
+       && ((heartbeatS == 0)
+           || ((now - lastTick) < ((uint32_t)heartbeatS * sl_sleeptimer_get_timer_frequency())))) {
+      skipped++;
+      return false;
+    }
+  }
+
+  haveLast = true;
+  lastMv = avg_mv;
+  lastTick = now;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Change and store the settings.
+ ******************************************************************************/
+sl_status_t le_change_filter_set_config(uint16_t hysteresis_mv,
+                                        uint16_t heartbeat_s)
+{
+  uint8_t settings[LE_CHANGE_FILTER_SETTINGS_SIZE];
+
+  hysteresisMv = hysteresis_mv;
+  heartbeatS = heartbeat_s;
+
+  settings[0] = (hysteresis_mv >> 8) & 0x00FF;
+  settings[1] = hysteresis_mv & 0x00FF;
+  settings[2] = (heartbeat_s >> 8) & 0x00FF;
+  settings[3] = heartbeat_s & 0x00FF;
+
+  if(nvm3_writeData(nvm3_defaultHandle, LE_CHANGE_FILTER_NVM3_KEY, settings, sizeof(settings)) != ECODE_NVM3_OK) {
+    return SL_STATUS_FAIL;
+  }
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Change Filter characteristic value.
+ ******************************************************************************/
+void le_change_filter_build(uint8_t *buf)
+{
+  buf[0] = (hysteresisMv >> 8) & 0x00FF;
+  buf[1] = hysteresisMv & 0x00FF;
+  buf[2] = (heartbeatS >> 8) & 0x00FF;
+  buf[3] = heartbeatS & 0x00FF;
+  buf[4] = (skipped >> 24) & 0x00FF;
+  buf[5] = (skipped >> 16) & 0x00FF;
+  buf[6] = (skipped >> 8) & 0x00FF;
+  buf[7] = skipped & 0x00FF;
+}
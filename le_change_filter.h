@@ -0,0 +1,116 @@
+/***************************************************************************//**
+ * @file le_change_filter.h
+ * @brief Report-on-change filter interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_CHANGE_FILTER_H_
+#define LE_CHANGE_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+#include "le_change_filter_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Size of the Change Filter characteristic value: hysteresis in mV and
+ *    heartbeat interval in s as big-endian uint16, then the number of skipped
+ *    windows as big-endian uint32. Writes carry the first two fields only.
+ ******************************************************************************/
+#define LE_CHANGE_FILTER_VALUE_SIZE     8
+#define LE_CHANGE_FILTER_SETTINGS_SIZE  4
+
+
+/***************************************************************************//**
+ * @brief
+ *    Load the settings from NVM3, or fall back to the configured defaults.
+ ******************************************************************************/
+void le_change_filter_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget the last notified window, so the next one is always notified.
+ *    Called whenever a client subscribes.
+ ******************************************************************************/
+void le_change_filter_restart(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Decide whether a window is notified. Windows that are not are counted
+ *    as skipped.
+ *
+ * @param[in] avg_mv
+ *    Average of the window in millivolts.
+ *
+ * @return
+ *    True if the window changed by at least the hysteresis, or the heartbeat
+ *    interval has passed since the last notified window.
+ ******************************************************************************/
+bool le_change_filter_check(uint16_t avg_mv);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Change the settings and store them in NVM3.
+ *
+ * @param[in] hysteresis_mv
+ *    Smallest change of the average that is notified, 0 notifies every
+ *    window.
+ *
+ * @param[in] heartbeat_s
+ *    Longest time without a notification, 0 disables the heartbeat.
+ *
+ * @return
+ *    SL_STATUS_OK, or SL_STATUS_FAIL if the settings could not be stored.
+ *    They are applied in either case.
+ ******************************************************************************/
+sl_status_t le_change_filter_set_config(uint16_t hysteresis_mv,
+                                        uint16_t heartbeat_s);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Change Filter characteristic value.
+ *
+ * @param[out] buf
+ *    LE_CHANGE_FILTER_VALUE_SIZE bytes.
+ ******************************************************************************/
+void le_change_filter_build(uint8_t *buf);
+
+#endif /* LE_CHANGE_FILTER_H_ */
@@ -0,0 +1,180 @@
+/***************************************************************************//**
+* @file le_channel.c
+* @brief L2CAP credit based channel definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_channel.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_bluetooth.h"
+
+/***************************************************************************//**
+ * @brief
+ *    L2CAP LE credit based connection results, the SDU length field heading
+ *    the first PDU of every SDU, and the receive side of the channel.
+ ******************************************************************************/
+#define CHANNEL_RESULT_SUCCESS              0x0000
+#define CHANNEL_RESULT_SPSM_NOT_SUPPORTED   0x0002
+#define CHANNEL_RESULT_NO_RESOURCES         0x0004
+#define CHANNEL_SDU_LENGTH_SIZE             2
+#define CHANNEL_RX_MTU                      23
+#define CHANNEL_RX_MPS                      23
+#define CHANNEL_RX_CREDITS                  1
+
+
+/***************************************************************************//**
+ * @brief
+ *    Answer an open request, and take over the channel if it is accepted.
+ ******************************************************************************/
+bool le_channel_accept(le_channel_t *channel,
+                       const sl_bt_evt_l2cap_le_channel_open_request_t *request,
+                       uint16_t spsm, bool available, uint16_t max_sdu)
+{
+  uint16_t result = CHANNEL_RESULT_SUCCESS;
+  sl_status_t sc;
+
+  if(request->spsm != spsm) {
+    result = CHANNEL_RESULT_SPSM_NOT_SUPPORTED;
+  } else if(!available) {
+    result = CHANNEL_RESULT_NO_RESOURCES;
+  }
+
+  sc = sl_bt_l2cap_send_le_channel_open_response(request->connection,
+                                                 request->cid,
+                                                 CHANNEL_RX_MTU,
+                                                 CHANNEL_RX_MPS,
+                                                 CHANNEL_RX_CREDITS,
+                                                 result);
+  if((sc != SL_STATUS_OK) || (result != CHANNEL_RESULT_SUCCESS)) {
+    return false;
+  }
+
+  // SDUs as long as both sides allow, paced by the credits of the central
+  channel->connection = request->connection;
+  channel->cid = request->cid;
+  channel->credits = request->credit;
+  channel->mps = (request->max_pdu != 0) ? request->max_pdu : CHANNEL_RX_MPS;
+  channel->max_sdu = (request->max_sdu < max_sdu) ? request->max_sdu : max_sdu;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send an SDU if the credits of the central cover all of its PDUs.
+ ******************************************************************************/
+sl_status_t le_channel_send_sdu(le_channel_t *channel, uint16_t len,
+                                const uint8_t *sdu)
+{
+  uint32_t pdus = ((uint32_t)len + CHANNEL_SDU_LENGTH_SIZE + channel->mps - 1) / channel->mps;
+  sl_status_t sc;
+
+  // Every PDU of the SDU takes a credit
+  if(pdus > channel->credits) {
+    // Sent once the central grants more credits
+    return SL_STATUS_NO_MORE_RESOURCE;
+  }
+
+  sc = sl_bt_l2cap_channel_send_data(channel->connection, channel->cid, len, sdu);
+  if(sc == SL_STATUS_OK) {
+    channel->credits -= pdus;
+  }
+  return sc;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Close the channel if it is open.
+ ******************************************************************************/
+void le_channel_close(le_channel_t *channel)
+{
+  if(channel->cid != 0) {
+    (void)sl_bt_l2cap_close_channel(channel->connection, channel->cid);
+    channel->cid = 0;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add the credits granted by the central.
+ ******************************************************************************/
+bool le_channel_on_credit(le_channel_t *channel,
+                          const sl_bt_evt_l2cap_channel_credit_t *credit)
+{
+  if((channel->cid == 0)
+     || (channel->cid != credit->cid)
+     || (channel->connection != credit->connection)) {
+    return false;
+  }
+
+  channel->credits += credit->credit;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Hand the credit of received data back, nothing is expected.
+ ******************************************************************************/
+void le_channel_on_data(const le_channel_t *channel,
+                        const sl_bt_evt_l2cap_channel_data_t *data)
+{
+  if((channel->cid != 0)
+     && (channel->cid == data->cid)
+     && (channel->connection == data->connection)) {
+    (void)sl_bt_l2cap_channel_send_credit(data->connection, data->cid, 1);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget the channel once the central closed it, nothing is left to
+ *    close.
+ ******************************************************************************/
+bool le_channel_on_closed(le_channel_t *channel,
+                          const sl_bt_evt_l2cap_channel_closed_t *closed)
+{
+  if((channel->cid == 0)
+     || (channel->cid != closed->cid)
+     || (channel->connection != closed->connection)) {
+    return false;
+  }
+
+  channel->cid = 0;
+  return true;
+}
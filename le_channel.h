@@ -0,0 +1,167 @@
+/***************************************************************************//**
+ * @file le_channel.h
+ * @brief L2CAP credit based channel interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_CHANNEL_H_
+#define LE_CHANNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Sending side of an L2CAP LE credit based channel, cid 0 if none is
+ *    open. The central is not expected to send anything.
+ ******************************************************************************/
+typedef struct {
+  uint8_t connection;  ///< Connection handle
+  uint16_t cid;        ///< Channel identifier, 0 if closed
+  uint32_t credits;    ///< PDUs the central still accepts
+  uint16_t mps;        ///< Largest PDU of the central
+  uint16_t max_sdu;    ///< Largest SDU both sides allow
+} le_channel_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Answer an open request, and take over the channel if it is accepted.
+ *
+ * @param[out] channel
+ *    Channel state, set up only if the request is accepted.
+ *
+ * @param[in] request
+ *    Open request event.
+ *
+ * @param[in] spsm
+ *    SPSM served, requests on other ones are refused.
+ *
+ * @param[in] available
+ *    False to refuse the request for lack of resources.
+ *
+ * @param[in] max_sdu
+ *    Largest SDU sent, limited further by the SDU size of the central.
+ *
+ * @return
+ *    True if the channel is open.
+ ******************************************************************************/
+bool le_channel_accept(le_channel_t *channel,
+                       const sl_bt_evt_l2cap_le_channel_open_request_t *request,
+                       uint16_t spsm, bool available, uint16_t max_sdu);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send an SDU if the credits of the central cover all of its PDUs.
+ *
+ * @param[in,out] channel
+ *    Open channel.
+ *
+ * @param[in] len
+ *    SDU length, at most channel->max_sdu.
+ *
+ * @param[in] sdu
+ *    SDU.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_NO_MORE_RESOURCE until the central grants more
+ *    credits or the stack has buffers again, or the error of the stack.
+ ******************************************************************************/
+sl_status_t le_channel_send_sdu(le_channel_t *channel, uint16_t len,
+                                const uint8_t *sdu);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Close the channel if it is open.
+ *
+ * @param[in,out] channel
+ *    Channel state.
+ ******************************************************************************/
+void le_channel_close(le_channel_t *channel);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add the credits granted by the central.
+ *
+ * @param[in,out] channel
+ *    Channel state.
+ *
+ * @param[in] credit
+ *    Channel credit event.
+ *
+ * @return
+ *    True if the credits are for this channel, and more SDUs may be sent.
+ ******************************************************************************/
+bool le_channel_on_credit(le_channel_t *channel,
+                          const sl_bt_evt_l2cap_channel_credit_t *credit);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard data received on the channel, handing its credit back.
+ *
+ * @param[in] channel
+ *    Channel state.
+ *
+ * @param[in] data
+ *    Channel data event.
+ ******************************************************************************/
+void le_channel_on_data(const le_channel_t *channel,
+                        const sl_bt_evt_l2cap_channel_data_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget the channel once the central closed it.
+ *
+ * @param[in,out] channel
+ *    Channel state.
+ *
+ * @param[in] closed
+ *    Channel closed event.
+ *
+ * @return
+ *    True if this channel closed.
+ ******************************************************************************/
+bool le_channel_on_closed(le_channel_t *channel,
+                          const sl_bt_evt_l2cap_channel_closed_t *closed);
+
+#endif /* LE_CHANNEL_H_ */
@@ -0,0 +1,604 @@
+/***************************************************************************//**
+* @file le_conn_policy.c
+* @brief Connection parameter policy definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_conn_policy.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sl_bluetooth_config.h"
+#include "sl_simple_timer.h"
+
+// The supervision timeout has to cover (1 + latency) * interval * 2
+#if (LE_CONN_POLICY_STREAM_TIMEOUT * 4) \
+  <= ((1 + LE_CONN_POLICY_STREAM_LATENCY) * LE_CONN_POLICY_STREAM_MAX_INTERVAL)
+#error "LE_CONN_POLICY_STREAM_TIMEOUT too short for the interval and latency"
+#endif
+
+#if (LE_CONN_POLICY_BULK_TIMEOUT * 4) \
+  <= ((1 + LE_CONN_POLICY_BULK_LATENCY) * LE_CONN_POLICY_BULK_MAX_INTERVAL)
+#error "LE_CONN_POLICY_BULK_TIMEOUT too short for the interval and latency"
+#endif
+
+#if LE_CONN_POLICY_BULK_EXIT_DEPTH >= LE_CONN_POLICY_BULK_ENTER_DEPTH
+#error "LE_CONN_POLICY_BULK_EXIT_DEPTH must be lower than LE_CONN_POLICY_BULK_ENTER_DEPTH"
+#endif
+
+#if LE_CONN_POLICY_CODED_EXIT_RSSI <= LE_CONN_POLICY_CODED_ENTER_RSSI
+#error "LE_CONN_POLICY_CODED_EXIT_RSSI must be higher than LE_CONN_POLICY_CODED_ENTER_RSSI"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Stack memory taken by a buffered link layer packet besides its payload,
+ *    an estimate of the buffer bookkeeping.
+ ******************************************************************************/
+#define PDU_BUFFER_OVERHEAD   32
+
+#if (SL_BT_CONFIG_MAX_CONNECTIONS * LE_CONN_POLICY_BUFFERED_PDUS \
+     * (LE_CONN_POLICY_DATA_LENGTH + PDU_BUFFER_OVERHEAD)) > SL_BT_CONFIG_BUFFER_SIZE
+#error "SL_BT_CONFIG_BUFFER_SIZE too small for the buffered packets of all connections"
+#endif
+
+// Weak links are only detected by the PHY policy
+#define CODED   (LE_CONN_POLICY_PHY_ENABLE && LE_CONN_POLICY_CODED_ENABLE)
+
+// The RSSI drives both the LE Coded switch and the TX power
+#define RSSI_POLL   (CODED || LE_CONN_POLICY_TX_POWER_ENABLE)
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    RSSI of a link not polled yet.
+ ******************************************************************************/
+#define RSSI_UNKNOWN    127
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Connection parameter set.
+ ******************************************************************************/
+typedef struct {
+  uint16_t min_interval;
+  uint16_t max_interval;
+  uint16_t latency;
+  uint16_t timeout;
+} conn_params_t;
+
+static const conn_params_t modeParams[] = {
+  [LE_CONN_POLICY_MODE_STREAMING] = {
+    LE_CONN_POLICY_STREAM_MIN_INTERVAL,
+    LE_CONN_POLICY_STREAM_MAX_INTERVAL,
+    LE_CONN_POLICY_STREAM_LATENCY,
+    LE_CONN_POLICY_STREAM_TIMEOUT
+  },
+  [LE_CONN_POLICY_MODE_BULK] = {
+    LE_CONN_POLICY_BULK_MIN_INTERVAL,
+    LE_CONN_POLICY_BULK_MAX_INTERVAL,
+    LE_CONN_POLICY_BULK_LATENCY,
+    LE_CONN_POLICY_BULK_TIMEOUT
+  },
+};
+
+
+/***************************************************************************//**
+ * @brief
+ *    Open connection and its requests left for the current mode.
+ ******************************************************************************/
+typedef struct {
+  bool open;
+  uint8_t connection;
+  uint8_t retriesLeft;
+#if LE_CONN_POLICY_PHY_ENABLE
+  uint8_t phy;              // PHY in use, sl_bt_gap_phy_type_t
+  uint8_t phyRetriesLeft;
+#endif
+#if CODED
+  bool weak;                // RSSI below the LE Coded threshold
+#endif
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  int8_t rssi;              // Last polled RSSI in dBm, or RSSI_UNKNOWN
+#endif
+} link_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Every connection follows the same mode
+static uint8_t mode = LE_CONN_POLICY_MODE_STREAMING;
+
+// Open connections
+static link_t links[SL_BT_CONFIG_MAX_CONNECTIONS];
+
+#if RSSI_POLL
+static sl_simple_timer_t rssiTimer;
+#endif
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+// Maximum TX power in use in 0.1 dBm, and RSSI answers left in this poll
+static int16_t txPower = SL_BT_CONFIG_MAX_TX_POWER;
+static uint8_t rssiPending;
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Find the link of a connection.
+ ******************************************************************************/
+static link_t *find_link(uint8_t connection)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(links[i].open && (links[i].connection == connection)) {
+      return &links[i];
+    }
+  }
+  return NULL;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a connection is open.
+ ******************************************************************************/
+static bool any_link(void)
+{
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(links[i].open) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Request the parameters of the current mode on a connection.
+ ******************************************************************************/
+static void request_params(link_t *link)
+{
+  const conn_params_t *params = &modeParams[mode];
+  sl_status_t sc;
+
+  if(link->retriesLeft == 0) {
+    return;
+  }
+
+  // A request refused by the stack, e.g. while another connection update
+  // is in progress, is retried with the next parameters event
+  sc = sl_bt_connection_set_parameters(link->connection,
+                                       params->min_interval,
+                                       params->max_interval,
+                                       params->latency,
+                                       params->timeout,
+                                       0,
+                                       0xFFFF);
+  (void)sc;
+  link->retriesLeft--;
+}
+
+
+#if LE_CONN_POLICY_PHY_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    PHY wanted on a connection. The PHY types of the status event have the
+ *    values of the matching preference bits.
+ ******************************************************************************/
+static uint8_t wanted_phy(const link_t *link)
+{
+#if CODED
+  if(link->weak) {
+    return sl_bt_gap_phy_coded;
+  }
+#else
+  (void)link;
+#endif
+  return (mode == LE_CONN_POLICY_MODE_BULK) ? sl_bt_gap_phy_2m : sl_bt_gap_phy_1m;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Request the wanted PHY on a connection unless it is in use.
+ ******************************************************************************/
+static void request_phy(link_t *link)
+{
+  sl_status_t sc;
+
+  if((link->phyRetriesLeft == 0) || (link->phy == wanted_phy(link))) {
+    return;
+  }
+
+  // Any PHY stays acceptable, a central without support keeps the link up
+  sc = sl_bt_connection_set_preferred_phy(link->connection,
+                                          wanted_phy(link),
+                                          sl_bt_gap_phy_any);
+  (void)sc;
+  link->phyRetriesLeft--;
+}
+#endif
+
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Set the maximum TX power, within the configured range.
+ ******************************************************************************/
+static void set_tx_power(int16_t power)
+{
+  int16_t set_min;
+  int16_t set_max;
+
+  if(power > SL_BT_CONFIG_MAX_TX_POWER) {
+    power = SL_BT_CONFIG_MAX_TX_POWER;
+  } else if(power < SL_BT_CONFIG_MIN_TX_POWER) {
+    power = SL_BT_CONFIG_MIN_TX_POWER;
+  }
+  if(power == txPower) {
+    return;
+  }
+
+  // The stack rounds to a level the PA supports
+  if(sl_bt_system_set_tx_power(SL_BT_CONFIG_MIN_TX_POWER,
+                               power,
+                               &set_min,
+                               &set_max) == SL_STATUS_OK) {
+    txPower = power;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    TX power reaching the central of a link at the target RSSI, in 0.1 dBm.
+ *    The path loss is the same both ways.
+ ******************************************************************************/
+static int16_t wanted_tx_power(const link_t *link)
+{
+  if(link->rssi == RSSI_UNKNOWN) {
+    return SL_BT_CONFIG_MAX_TX_POWER;
+  }
+  return (LE_CONN_POLICY_TX_POWER_PEER_DBM - link->rssi
+          + LE_CONN_POLICY_TX_POWER_TARGET_RSSI) * 10;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Step the TX power down towards the weakest link once every link
+ *    answered the RSSI poll.
+ ******************************************************************************/
+static void step_tx_power(void)
+{
+  int16_t wanted = SL_BT_CONFIG_MIN_TX_POWER;
+
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(links[i].open && (wanted_tx_power(&links[i]) > wanted)) {
+      wanted = wanted_tx_power(&links[i]);
+    }
+  }
+
+  if(wanted < (txPower - LE_CONN_POLICY_TX_POWER_STEP)) {
+    wanted = txPower - LE_CONN_POLICY_TX_POWER_STEP;
+  }
+  set_tx_power(wanted);
+}
+#endif
+
+
+#if RSSI_POLL
+/***************************************************************************//**
+ * @brief
+ *    RSSI timer callback, called from the main loop.
+ ******************************************************************************/
+static void rssi_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  sl_status_t sc;
+
+  (void)timer;
+  (void)data;
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  rssiPending = 0;
+#endif
+  // Answered with sl_bt_evt_connection_rssi_id
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(links[i].open) {
+      sc = sl_bt_connection_get_rssi(links[i].connection);
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+      if(sc == SL_STATUS_OK) {
+        rssiPending++;
+      }
+#else
+      (void)sc;
+#endif
+    }
+  }
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Switch all connections to a parameter set.
+ ******************************************************************************/
+static void set_mode(uint8_t new_mode)
+{
+  if(new_mode == mode) {
+    return;
+  }
+
+  mode = new_mode;
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(links[i].open) {
+      links[i].retriesLeft = LE_CONN_POLICY_MAX_RETRIES;
+      request_params(&links[i]);
+#if LE_CONN_POLICY_PHY_ENABLE
+      links[i].phyRetriesLeft = LE_CONN_POLICY_MAX_RETRIES;
+      request_phy(&links[i]);
+#endif
+    }
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set up the ATT MTU and the data length of future connections.
+ ******************************************************************************/
+sl_status_t le_conn_policy_init(void)
+{
+  sl_status_t sc;
+  uint16_t max_mtu;
+
+  // The GATT client of the stack starts the MTU exchange on every new
+  // connection, the result comes with sl_bt_evt_gatt_mtu_exchanged_id
+  sc = sl_bt_gatt_server_set_max_mtu(LE_CONN_POLICY_MAX_MTU, &max_mtu);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_connection_set_default_data_length(LE_CONN_POLICY_DATA_LENGTH);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take over a new connection.
+ ******************************************************************************/
+void le_conn_policy_open(uint8_t connection)
+{
+  link_t *link = NULL;
+
+  for(uint32_t i = 0; i < SL_BT_CONFIG_MAX_CONNECTIONS; i++) {
+    if(!links[i].open) {
+      link = &links[i];
+      break;
+    }
+  }
+  if(link == NULL) {
+    return;
+  }
+
+  // The first connection starts streaming, later ones join the current mode
+  if(!any_link()) {
+    mode = LE_CONN_POLICY_MODE_STREAMING;
+#if RSSI_POLL
+    (void)sl_simple_timer_start(&rssiTimer,
+                                LE_CONN_POLICY_RSSI_INTERVAL_S * 1000,
+                                rssi_timer_cb,
+                                NULL,
+                                true);
+#endif
+  }
+  link->open = true;
+  link->connection = connection;
+  link->retriesLeft = LE_CONN_POLICY_MAX_RETRIES;
+  request_params(link);
+#if LE_CONN_POLICY_PHY_ENABLE
+  // Connections open on LE 1M
+  link->phy = sl_bt_gap_1m_phy;
+  link->phyRetriesLeft = LE_CONN_POLICY_MAX_RETRIES;
+#if CODED
+  link->weak = false;
+#endif
+  request_phy(link);
+#endif
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  // Full power until the new central is measured, for the advertising too
+  link->rssi = RSSI_UNKNOWN;
+  set_tx_power(SL_BT_CONFIG_MAX_TX_POWER);
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget a closed connection.
+ ******************************************************************************/
+void le_conn_policy_close(uint8_t connection, uint16_t reason)
+{
+  link_t *link = find_link(connection);
+
+  if(link != NULL) {
+    link->open = false;
+  }
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  // A lost link may have been the victim of a too low TX power
+  if(reason == SL_STATUS_BT_CTRL_CONNECTION_TIMEOUT) {
+    set_tx_power(SL_BT_CONFIG_MAX_TX_POWER);
+  }
+#else
+  (void)reason;
+#endif
+  if(!any_link()) {
+    mode = LE_CONN_POLICY_MODE_STREAMING;
+#if RSSI_POLL
+    (void)sl_simple_timer_stop(&rssiTimer);
+#endif
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+    set_tx_power(SL_BT_CONFIG_MAX_TX_POWER);
+#endif
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Update the number of notifications waiting to be sent.
+ ******************************************************************************/
+void le_conn_policy_set_queue_depth(uint16_t pending)
+{
+  if(!any_link()) {
+    return;
+  }
+
+  if(pending >= LE_CONN_POLICY_BULK_ENTER_DEPTH) {
+    set_mode(LE_CONN_POLICY_MODE_BULK);
+  } else if(pending <= LE_CONN_POLICY_BULK_EXIT_DEPTH) {
+    set_mode(LE_CONN_POLICY_MODE_STREAMING);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle the parameters applied by the central.
+ ******************************************************************************/
+void le_conn_policy_on_parameters(const sl_bt_evt_connection_parameters_t *params)
+{
+  const conn_params_t *wanted = &modeParams[mode];
+  link_t *link = find_link(params->connection);
+
+  if(link == NULL) {
+    return;
+  }
+
+  if((params->interval >= wanted->min_interval)
+     && (params->interval <= wanted->max_interval)
+     && (params->latency == wanted->latency)) {
+    return;
+  }
+
+  // The central picked its own values, ask again while retries are left
+  request_params(link);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the current parameter set.
+ ******************************************************************************/
+uint8_t le_conn_policy_get_mode(void)
+{
+  return mode;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a PHY change.
+ ******************************************************************************/
+void le_conn_policy_on_phy_status(const sl_bt_evt_connection_phy_status_t *status)
+{
+#if LE_CONN_POLICY_PHY_ENABLE
+  link_t *link = find_link(status->connection);
+
+  if(link == NULL) {
+    return;
+  }
+
+  // The central picked another PHY, ask again while retries are left
+  link->phy = status->phy;
+  request_phy(link);
+#else
+  (void)status;
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a polled RSSI value.
+ ******************************************************************************/
+void le_conn_policy_on_rssi(const sl_bt_evt_connection_rssi_t *rssi)
+{
+#if RSSI_POLL
+  link_t *link = find_link(rssi->connection);
+#if CODED
+  bool weak;
+#endif
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  if(rssiPending > 0) {
+    rssiPending--;
+  }
+#endif
+  if((link == NULL) || (rssi->status != 0)) {
+    return;
+  }
+
+#if LE_CONN_POLICY_TX_POWER_ENABLE
+  // Back off at once on a weaker link, step down once all links answered
+  link->rssi = rssi->rssi;
+  if(wanted_tx_power(link) > txPower) {
+    set_tx_power(wanted_tx_power(link));
+  } else if(rssiPending == 0) {
+    step_tx_power();
+  }
+#endif
+
+#if CODED
+  // Hysteresis between the thresholds
+  weak = link->weak;
+  if(rssi->rssi < LE_CONN_POLICY_CODED_ENTER_RSSI) {
+    weak = true;
+  } else if(rssi->rssi > LE_CONN_POLICY_CODED_EXIT_RSSI) {
+    weak = false;
+  }
+
+  if(weak != link->weak) {
+    link->weak = weak;
+    link->phyRetriesLeft = LE_CONN_POLICY_MAX_RETRIES;
+    request_phy(link);
+  }
+#endif
+#else
+  (void)rssi;
+#endif
+}
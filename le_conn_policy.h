@@ -0,0 +1,154 @@
+/***************************************************************************//**
+ * @file le_conn_policy.h
+ * @brief Connection parameter policy interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_CONN_POLICY_H_
+#define LE_CONN_POLICY_H_
+
+#include <stdint.h>
+#include "sl_bluetooth.h"
+#include "le_conn_policy_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Connection parameter sets.
+ ******************************************************************************/
+#define LE_CONN_POLICY_MODE_STREAMING   0
+#define LE_CONN_POLICY_MODE_BULK        1
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the largest ATT MTU and the link layer data length requested on
+ *    future connections. Call it once the stack has booted.
+ *
+ * @return
+ *    SL_STATUS_OK, or the error of the stack.
+ ******************************************************************************/
+sl_status_t le_conn_policy_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take over a new connection and request the parameters of the current
+ *    mode, streaming for the first connection.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_conn_policy_open(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget a closed connection.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ *
+ * @param[in] reason
+ *    Reason of the closed connection event. A supervision timeout restores
+ *    the maximum TX power.
+ ******************************************************************************/
+void le_conn_policy_close(uint8_t connection, uint16_t reason);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Update the number of notifications waiting to be sent. Crossing the
+ *    configured depths switches all connections between the streaming and
+ *    bulk parameters.
+ *
+ * @param[in] pending
+ *    Pending notifications.
+ ******************************************************************************/
+void le_conn_policy_set_queue_depth(uint16_t pending);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle the parameters applied by the central, and request the ones of
+ *    the current mode again if they are out of range.
+ *
+ * @param[in] params
+ *    Connection parameters event data.
+ ******************************************************************************/
+void le_conn_policy_on_parameters(const sl_bt_evt_connection_parameters_t *params);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a PHY change of a connection, and request the wanted PHY again if
+ *    the central picked another one.
+ *
+ * @note
+ *    Only acts with LE_CONN_POLICY_PHY_ENABLE. Bulk transfers want LE 2M,
+ *    streaming LE 1M, and weak links LE Coded.
+ *
+ * @param[in] status
+ *    PHY status event data.
+ ******************************************************************************/
+void le_conn_policy_on_phy_status(const sl_bt_evt_connection_phy_status_t *status);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle the RSSI polled every LE_CONN_POLICY_RSSI_INTERVAL_S, move the
+ *    connection to LE Coded or back when crossing the thresholds, and adjust
+ *    the TX power to the weakest link.
+ *
+ * @note
+ *    Only acts with LE_CONN_POLICY_CODED_ENABLE or
+ *    LE_CONN_POLICY_TX_POWER_ENABLE.
+ *
+ * @param[in] rssi
+ *    RSSI event data.
+ ******************************************************************************/
+void le_conn_policy_on_rssi(const sl_bt_evt_connection_rssi_t *rssi);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the current parameter set.
+ *
+ * @return
+ *    LE_CONN_POLICY_MODE_STREAMING or LE_CONN_POLICY_MODE_BULK.
+ ******************************************************************************/
+uint8_t le_conn_policy_get_mode(void);
+
+#endif /* LE_CONN_POLICY_H_ */
@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file le_cycle_counter.h
+ * @brief DWT cycle counter interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_CYCLE_COUNTER_H_
+#define LE_CYCLE_COUNTER_H_
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start the free running DWT cycle counter, read from DWT->CYCCNT.
+ *
+ * @details
+ *    Shared by the profile, trace and soak counters, calling it again has no
+ *    effect.
+ ******************************************************************************/
+void le_cycle_counter_init(void);
+
+#endif /* LE_CYCLE_COUNTER_H_ */
@@ -0,0 +1,193 @@
+/***************************************************************************//**
+* @file le_deep_sleep.c
+* @brief EM4 deep sleep definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_deep_sleep.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_emu.h"
+#include "em_rmu.h"
+#include "em_burtc.h"
+#include "sl_bluetooth.h"
+
+#if (1 + LE_DEEP_SLEEP_RETAINED_WORDS) > BURAM_RET_REG_NUM
+#error "LE_DEEP_SLEEP_RETAINED_WORDS exceeds the backup RAM"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Backup RAM layout: a marker of valid contents, then the retained words.
+ ******************************************************************************/
+#define RETAINED_MAGIC_WORD     0
+#define RETAINED_FIRST_WORD     1
+#define RETAINED_MAGIC          0x4C454453UL
+
+/***************************************************************************//**
+ * @brief
+ *    ULFRCO frequency, the BURTC clock in EM4.
+ ******************************************************************************/
+#define ULFRCO_HZ               1000
+
+// Sleep duration in BURTC ticks
+#define PERIOD_TICKS            ((uint32_t)LE_DEEP_SLEEP_PERIOD_S * ULFRCO_HZ)
+
+// Advertising interval in units of 0.625 ms
+#define BROADCAST_INTERVAL      ((LE_DEEP_SLEEP_BROADCAST_INTERVAL_MS * 8) / 5)
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Advertising set of the running broadcast, 0xFF if none
+static uint8_t broadcastSet = 0xFF;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check the reset cause and the backup RAM.
+ ******************************************************************************/
+bool le_deep_sleep_init(void)
+{
+  uint32_t cause;
+
+  CMU_ClockEnable(cmuClock_BURAM, true);
+
+  cause = RMU_ResetCauseGet();
+  RMU_ResetCauseClear();
+
+  if((cause & EMU_RSTCAUSE_EM4)
+     && (BURAM->RET[RETAINED_MAGIC_WORD].REG == RETAINED_MAGIC)) {
+    return true;
+  }
+
+  // Power-on, pin or software reset, nothing worth keeping
+  for(uint32_t i = 0; i < LE_DEEP_SLEEP_RETAINED_WORDS; i++) {
+    BURAM->RET[RETAINED_FIRST_WORD + i].REG = 0;
+  }
+  BURAM->RET[RETAINED_MAGIC_WORD].REG = RETAINED_MAGIC;
+  return false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get a retained word.
+ ******************************************************************************/
+uint32_t le_deep_sleep_get_retained(uint8_t index)
+{
+  if(index >= LE_DEEP_SLEEP_RETAINED_WORDS) {
+    return 0;
+  }
+  return BURAM->RET[RETAINED_FIRST_WORD + index].REG;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set a retained word.
+ ******************************************************************************/
+void le_deep_sleep_set_retained(uint8_t index, uint32_t value)
+{
+  if(index < LE_DEEP_SLEEP_RETAINED_WORDS) {
+    BURAM->RET[RETAINED_FIRST_WORD + index].REG = value;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Advertise the report a few times.
+ ******************************************************************************/
+sl_status_t le_deep_sleep_broadcast(uint8_t advertising_set)
+{
+  sl_status_t sc;
+
+  // Ends with sl_bt_evt_advertiser_timeout_id after the last event
+  sc = sl_bt_advertiser_set_timing(advertising_set,
+                                   BROADCAST_INTERVAL,
+                                   BROADCAST_INTERVAL,
+                                   0,
+                                   LE_DEEP_SLEEP_BROADCASTS);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_bt_advertiser_start(advertising_set,
+                              advertiser_user_data,
+                              advertiser_non_connectable);
+  if(sc == SL_STATUS_OK) {
+    broadcastSet = advertising_set;
+  }
+  return sc;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Enter EM4 once the broadcast has ended.
+ ******************************************************************************/
+void le_deep_sleep_on_timeout(uint8_t advertising_set)
+{
+  BURTC_Init_TypeDef burtcInit = BURTC_INIT_DEFAULT;
+  EMU_EM4Init_TypeDef em4Init = EMU_EM4INIT_DEFAULT;
+
+  if(advertising_set != broadcastSet) {
+    return;
+  }
+
+  // The ULFRCO is the only oscillator left running in EM4
+  CMU_ClockSelectSet(cmuClock_EM4GRPACLK, cmuSelect_ULFRCO);
+  CMU_ClockEnable(cmuClock_BURTC, true);
+
+  // Compare match wakes the device up from EM4, counting starts once the
+  // compare value is set. BURTC_Init already enables the module
+  burtcInit.start = false;
+  burtcInit.compare0Top = true;
+  burtcInit.em4comp = true;
+  BURTC_Init(&burtcInit);
+  BURTC_CounterReset();
+  BURTC_CompareSet(0, PERIOD_TICKS);
+  BURTC_IntClear(BURTC_IF_COMP);
+  BURTC_IntEnable(BURTC_IEN_COMP);
+  BURTC_Start();
+
+  // Does not return, the wake-up is a reset
+  EMU_EM4Init(&em4Init);
+  EMU_EnterEM4();
+}
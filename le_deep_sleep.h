@@ -0,0 +1,120 @@
+/***************************************************************************//**
+ * @file le_deep_sleep.h
+ * @brief EM4 deep sleep interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_DEEP_SLEEP_H_
+#define LE_DEEP_SLEEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+#include "le_deep_sleep_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Number of words retained in the backup RAM over EM4.
+ ******************************************************************************/
+#define LE_DEEP_SLEEP_RETAINED_WORDS    8
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check why the device booted and validate the retained words.
+ *
+ * @return
+ *    True after an EM4 wake-up with the retained words of the previous run,
+ *    false after any other reset, the retained words are then cleared.
+ ******************************************************************************/
+bool le_deep_sleep_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get a word retained in the backup RAM.
+ *
+ * @param[in] index
+ *    Word index, below LE_DEEP_SLEEP_RETAINED_WORDS.
+ *
+ * @return
+ *    Value of the word, 0 if it was cleared.
+ ******************************************************************************/
+uint32_t le_deep_sleep_get_retained(uint8_t index);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set a word retained in the backup RAM. It survives EM4 but no other
+ *    reset.
+ *
+ * @param[in] index
+ *    Word index, below LE_DEEP_SLEEP_RETAINED_WORDS.
+ *
+ * @param[in] value
+ *    Value of the word.
+ ******************************************************************************/
+void le_deep_sleep_set_retained(uint8_t index, uint32_t value);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Advertise the current advertising data LE_DEEP_SLEEP_BROADCASTS times.
+ *    The end of the broadcast is reported with sl_bt_evt_advertiser_timeout_id.
+ *
+ * @param[in] advertising_set
+ *    Advertising set holding the beacon data.
+ *
+ * @return
+ *    SL_STATUS_OK, or the error of the stack.
+ ******************************************************************************/
+sl_status_t le_deep_sleep_broadcast(uint8_t advertising_set);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle an advertising timeout, and enter EM4 until the next report once
+ *    the broadcast has ended.
+ *
+ * @note
+ *    Does not return after the broadcast, the device resets on wake-up.
+ *
+ * @param[in] advertising_set
+ *    Advertising set of the timeout event.
+ ******************************************************************************/
+void le_deep_sleep_on_timeout(uint8_t advertising_set);
+
+#endif /* LE_DEEP_SLEEP_H_ */
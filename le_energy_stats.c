@@ -0,0 +1,245 @@
+/***************************************************************************//**
+* @file le_energy_stats.c
+* @brief Energy statistics definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_energy_stats.h"
+#include <stdint.h>
+#include "sl_power_manager.h"
+#include "sl_sleeptimer.h"
+#include "le_voltage_monitor.h"
+#include "le_byte_order.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Energy mode buckets. EM3 is accounted as EM2.
+ ******************************************************************************/
+#define BUCKET_EM0                     0
+#define BUCKET_EM1                     1
+#define BUCKET_EM2                     2
+#define NUM_OF_BUCKETS                 3
+
+// Charge components of the report, in nA * sleeptimer ticks
+#define CHARGE_EM0                     0
+#define CHARGE_EM1                     1
+#define CHARGE_EM2                     2
+#define CHARGE_RADIO                   3
+#define CHARGE_SENSOR                  4
+#define NUM_OF_CHARGES                 5
+
+#define EM_TRANSITION_EVENTS           (SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM0   \
+                                        | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM1 \
+                                        | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM2 \
+                                        | SL_POWER_MANAGER_EVENT_TRANSITION_ENTERING_EM3)
+
+static const uint32_t bucketCurrentNa[NUM_OF_BUCKETS] = {
+  LE_ENERGY_STATS_EM0_CURRENT_NA,
+  LE_ENERGY_STATS_EM1_CURRENT_NA,
+  LE_ENERGY_STATS_EM2_CURRENT_NA
+};
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static void on_em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to);
+
+static sl_power_manager_em_transition_event_handle_t emEventHandle;
+static const sl_power_manager_em_transition_event_info_t emEventInfo = {
+  .event_mask = EM_TRANSITION_EVENTS,
+  .on_event = on_em_transition
+};
+
+// Sleeptimer ticks spent per bucket, and when the current one was entered
+static uint64_t residencyTicks[NUM_OF_BUCKETS];
+static uint32_t lastTransition = 0;
+static uint8_t currentBucket = BUCKET_EM0;
+
+static uint32_t windows = 0;
+static uint32_t notifications = 0;
+static uint64_t sensorOnUs = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Map an energy mode to its bucket.
+ ******************************************************************************/
+static uint8_t em_bucket(sl_power_manager_em_t em)
+{
+  switch(em) {
+    case SL_POWER_MANAGER_EM0:
+      return BUCKET_EM0;
+    case SL_POWER_MANAGER_EM1:
+      return BUCKET_EM1;
+    default:
+      return BUCKET_EM2;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Energy mode transition callback. Called by the power manager around
+ *    sleep with interrupts disabled, so it only books the elapsed time.
+ ******************************************************************************/
+static void on_em_transition(sl_power_manager_em_t from, sl_power_manager_em_t to)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  residencyTicks[em_bucket(from)] += (uint32_t)(now - lastTransition);
+  lastTransition = now;
+  currentBucket = em_bucket(to);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Convert a time in sleeptimer ticks to milliseconds.
+ ******************************************************************************/
+static uint32_t ticks_to_ms(uint64_t ticks, uint32_t freq)
+{
+  return (uint32_t)((ticks * 1000) / freq);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Convert a charge in nA * ticks to pAh per reading.
+ ******************************************************************************/
+static uint32_t charge_to_pah(uint64_t charge, uint32_t freq)
+{
+  uint64_t divisor = (uint64_t)freq * 3600 * (windows ? windows : 1);
+
+  // Split to keep charge * 1000 from overflowing on long runs
+  return (uint32_t)(((charge / divisor) * 1000)
+                    + ((((charge % divisor) * 1000) + (divisor / 2)) / divisor));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Subscribe to the energy mode transitions.
+ ******************************************************************************/
+void le_energy_stats_init(void)
+{
+  le_energy_stats_reset();
+  sl_power_manager_subscribe_em_transition_event(&emEventHandle, &emEventInfo);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear all counters.
+ ******************************************************************************/
+void le_energy_stats_reset(void)
+{
+  for(uint32_t i = 0; i < NUM_OF_BUCKETS; i++) {
+    residencyTicks[i] = 0;
+  }
+  lastTransition = sl_sleeptimer_get_tick_count();
+  windows = 0;
+  notifications = 0;
+  sensorOnUs = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a completed window.
+ ******************************************************************************/
+void le_energy_stats_record_window(void)
+{
+  windows++;
+  sensorOnUs += le_voltage_monitor_get_sensor_on_us();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a notification queued to the stack.
+ ******************************************************************************/
+void le_energy_stats_record_notification(void)
+{
+  notifications++;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the statistics report.
+ ******************************************************************************/
+size_t le_energy_stats_build(uint8_t *buf, size_t size)
+{
+  uint32_t freq = sl_sleeptimer_get_timer_frequency();
+  uint64_t residency[NUM_OF_BUCKETS];
+  uint64_t charge[NUM_OF_CHARGES];
+  uint64_t total = 0;
+  uint8_t *p = buf;
+
+  if(size < LE_ENERGY_STATS_REPORT_SIZE) {
+    return 0;
+  }
+
+  // Include the time spent in the current mode so far
+  for(uint32_t i = 0; i < NUM_OF_BUCKETS; i++) {
+    residency[i] = residencyTicks[i];
+  }
+  residency[currentBucket] += (uint32_t)(sl_sleeptimer_get_tick_count() - lastTransition);
+
+  charge[CHARGE_EM0] = residency[BUCKET_EM0] * bucketCurrentNa[BUCKET_EM0];
+  charge[CHARGE_EM1] = residency[BUCKET_EM1] * bucketCurrentNa[BUCKET_EM1];
+  charge[CHARGE_EM2] = residency[BUCKET_EM2] * bucketCurrentNa[BUCKET_EM2];
+  charge[CHARGE_RADIO] = (uint64_t)notifications * LE_ENERGY_STATS_NOTIFICATION_CHARGE_NC * freq;
+  charge[CHARGE_SENSOR] = (sensorOnUs * LE_ENERGY_STATS_SENSOR_CURRENT_NA / 1000000) * freq;
+
+  for(uint32_t i = 0; i < NUM_OF_CHARGES; i++) {
+    total += charge[i];
+  }
+
+  p = le_byte_order_put_u32(p, windows);
+  p = le_byte_order_put_u32(p, notifications);
+  for(uint32_t i = 0; i < NUM_OF_BUCKETS; i++) {
+    p = le_byte_order_put_u32(p, ticks_to_ms(residency[i], freq));
+  }
+  p = le_byte_order_put_u32(p, (uint32_t)(sensorOnUs / 1000));
+
+  p = le_byte_order_put_u32(p, charge_to_pah(total, freq));
+  for(uint32_t i = 0; i < NUM_OF_CHARGES; i++) {
+    p = le_byte_order_put_u32(p, charge_to_pah(charge[i], freq));
+  }
+
+  return (size_t)(p - buf);
+}
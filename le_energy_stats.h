@@ -0,0 +1,106 @@
+/***************************************************************************//**
+ * @file le_energy_stats.h
+ * @brief Energy statistics interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_ENERGY_STATS_H_
+#define LE_ENERGY_STATS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "le_energy_stats_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Size of the report built by le_energy_stats_build(). All fields are
+ *    big-endian uint32:
+ *
+ *    - completed windows
+ *    - sent notifications
+ *    - time in EM0, EM1 and EM2/EM3 in milliseconds
+ *    - sensor power-on time in milliseconds
+ *    - estimated charge per reading in pAh: total, then the EM0, EM1,
+ *      EM2/EM3, radio and sensor shares
+ ******************************************************************************/
+#define LE_ENERGY_STATS_REPORT_SIZE   48
+
+
+/***************************************************************************//**
+ * @brief
+ *    Subscribe to the power manager energy mode transitions and start
+ *    counting.
+ ******************************************************************************/
+void le_energy_stats_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear all counters.
+ ******************************************************************************/
+void le_energy_stats_reset(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a completed window and the sensor power-on time it took.
+ ******************************************************************************/
+void le_energy_stats_record_window(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a notification queued to the stack.
+ ******************************************************************************/
+void le_energy_stats_record_notification(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the statistics report.
+ *
+ * @param[out] buf
+ *    Report buffer.
+ *
+ * @param[in] size
+ *    Size of the report buffer, at least LE_ENERGY_STATS_REPORT_SIZE.
+ *
+ * @return
+ *    Length of the report, 0 if the buffer is too small.
+ ******************************************************************************/
+size_t le_energy_stats_build(uint8_t *buf, size_t size);
+
+#endif /* LE_ENERGY_STATS_H_ */
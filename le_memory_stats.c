@@ -0,0 +1,169 @@
+/***************************************************************************//**
+* @file le_memory_stats.c
+* @brief Memory budget statistics definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_memory_stats.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <malloc.h>
+#include "em_device.h"
+#include "em_core.h"
+#include "sl_memory.h"
+#include "sl_bluetooth_config.h"
+#include "le_voltage_monitor.h"
+#include "le_byte_order.h"
+
+#if LE_MEMORY_STATS_ENABLE
+
+/***************************************************************************//**
+ * @brief
+ *    Word the unused stack is painted with.
+ ******************************************************************************/
+#define STACK_FILL                0xA5A5A5A5UL
+
+
+/***************************************************************************//**
+ * @brief
+ *    Section boundaries from the linker script.
+ ******************************************************************************/
+extern char __data_start__[];
+extern char __data_end__[];
+extern char __bss_start__[];
+extern char __bss_end__[];
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint16_t buffersDiscarded = 0;
+static uint16_t bufferAllocationFailures = 0;
+static uint16_t heapAllocationFailures = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add to a count, saturating instead of wrapping.
+ ******************************************************************************/
+static void add_saturated(uint16_t *count, uint8_t n)
+{
+  *count = (*count > (UINT16_MAX - n)) ? UINT16_MAX : (uint16_t)(*count + n);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append a 16-bit value in big-endian byte order, saturated.
+ ******************************************************************************/
+static uint8_t *put_u16_saturated(uint8_t *p, size_t value)
+{
+  return le_byte_order_put_u16(p, (value > UINT16_MAX) ? UINT16_MAX : (uint16_t)value);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Paint the stack below the caller.
+ ******************************************************************************/
+void le_memory_stats_init(void)
+{
+  sl_memory_region_t stack = sl_memory_get_stack_region();
+  uint32_t *word = (uint32_t *)stack.base;
+  uint32_t *sp;
+  CORE_DECLARE_IRQ_STATE;
+
+  // An interrupt taken meanwhile would have its frame painted over
+  CORE_ENTER_ATOMIC();
+  sp = (uint32_t *)__get_MSP();
+  while(word < sp) {
+    *word++ = STACK_FILL;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count the exhausted Bluetooth resources.
+ ******************************************************************************/
+void le_memory_stats_record_exhausted(uint8_t buffers_discarded,
+                                      uint8_t buffer_allocation_failures,
+                                      uint8_t heap_allocation_failures)
+{
+  add_saturated(&buffersDiscarded, buffers_discarded);
+  add_saturated(&bufferAllocationFailures, buffer_allocation_failures);
+  add_saturated(&heapAllocationFailures, heap_allocation_failures);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Memory Budget value.
+ ******************************************************************************/
+size_t le_memory_stats_build(uint8_t *buf)
+{
+  sl_memory_region_t stack = sl_memory_get_stack_region();
+  sl_memory_region_t heap = sl_memory_get_heap_region();
+  const uint32_t *word = (const uint32_t *)stack.base;
+  const uint32_t *top = (const uint32_t *)((uintptr_t)stack.base + stack.size);
+  struct mallinfo info = mallinfo();
+  uint8_t *p = buf;
+
+  // The stack grows down, the lowest word that changed marks its deepest use
+  while((word < top) && (*word == STACK_FILL)) {
+    word++;
+  }
+
+  p = put_u16_saturated(p, (size_t)(__data_end__ - __data_start__)
+                        + (size_t)(__bss_end__ - __bss_start__));
+  p = put_u16_saturated(p, stack.size);
+  p = put_u16_saturated(p, (size_t)((uintptr_t)top - (uintptr_t)word));
+  // Newlib never gives memory back, the extent taken from the heap region
+  // is its high-water mark
+  p = put_u16_saturated(p, heap.size);
+  p = put_u16_saturated(p, (size_t)info.arena);
+  p = put_u16_saturated(p, (size_t)info.uordblks);
+  p = put_u16_saturated(p, SL_BT_CONFIG_BUFFER_SIZE);
+  p = put_u16_saturated(p, LE_VOLTAGE_MONITOR_ARENA_SIZE);
+  p = put_u16_saturated(p, le_voltage_monitor_get_arena_usage());
+  p = put_u16_saturated(p, buffersDiscarded);
+  p = put_u16_saturated(p, bufferAllocationFailures);
+  p = put_u16_saturated(p, heapAllocationFailures);
+
+  return (size_t)(p - buf);
+}
+
+#endif
@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ * @file le_memory_stats.h
+ * @brief Memory budget statistics interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_MEMORY_STATS_H_
+#define LE_MEMORY_STATS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "le_memory_stats_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Size of the Memory Budget value built by le_memory_stats_build(). All
+ *    fields are big-endian uint16 byte counts, the failures saturate:
+ *    - static RAM, .data and .bss
+ *    - stack size and its high-water mark
+ *    - heap size, its high-water mark and the bytes allocated now
+ *    - SL_BT_CONFIG_BUFFER_SIZE
+ *    - acquisition arena size and the bytes of it in use
+ *    - Bluetooth buffers discarded, buffer and heap allocation failures
+ ******************************************************************************/
+#define LE_MEMORY_STATS_VALUE_SIZE   24
+
+
+/***************************************************************************//**
+ * @brief
+ *    Paint the unused stack with a fill pattern.
+ *
+ * @details
+ *    Everything below the stack pointer of the caller is painted, so the
+ *    earlier the call, the more of the stack it covers. Call once, after
+ *    the system init, first thing in app_init().
+ *
+ * @note
+ *    Only available with LE_MEMORY_STATS_ENABLE, as all functions of this
+ *    module.
+ ******************************************************************************/
+void le_memory_stats_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count the resources the Bluetooth stack ran out of, from a
+ *    sl_bt_evt_system_resource_exhausted event.
+ ******************************************************************************/
+void le_memory_stats_record_exhausted(uint8_t buffers_discarded,
+                                      uint8_t buffer_allocation_failures,
+                                      uint8_t heap_allocation_failures);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Memory Budget value.
+ *
+ * @param[out] buf
+ *    Value buffer of LE_MEMORY_STATS_VALUE_SIZE bytes.
+ *
+ * @return
+ *    Length of the value.
+ ******************************************************************************/
+size_t le_memory_stats_build(uint8_t *buf);
+
+#endif /* LE_MEMORY_STATS_H_ */
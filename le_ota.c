@@ -0,0 +1,311 @@
+/***************************************************************************//**
+* @file le_ota.c
+* @brief OTA update definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_ota.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "sl_bluetooth.h"
+#if LE_OTA_IN_APP_ENABLE
+#include "btl_interface.h"
+#endif
+
+#if (LE_OTA_STAGING_SIZE % 4) || (FLASH_PAGE_SIZE % LE_OTA_STAGING_SIZE)
+#error "LE_OTA_STAGING_SIZE must be a multiple of 4 and divide the flash page size"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Update states.
+ ******************************************************************************/
+#define STATE_IDLE        0   ///< No update
+#define STATE_RECEIVING   1   ///< Receiving the image in the application
+#define STATE_INSTALL     2   ///< Image verified, installed once disconnected
+#define STATE_APPLOADER   3   ///< Rebooting into the AppLoader once disconnected
+
+/***************************************************************************//**
+ * @brief
+ *    sl_bt_system_reset() mode booting into the AppLoader OTA DFU.
+ ******************************************************************************/
+#define SYSTEM_RESET_OTA_DFU    2
+
+/***************************************************************************//**
+ * @brief
+ *    Value of erased flash, pads the tail of the image to whole words.
+ ******************************************************************************/
+#define ERASED_FLASH_BYTE       0xFF
+
+static uint8_t state = STATE_IDLE;
+static uint8_t otaConnection;
+
+#if LE_OTA_IN_APP_ENABLE
+// Words, the storage writes are word aligned
+static uint32_t stagingBuffer[LE_OTA_STAGING_SIZE / 4];
+static uint16_t stagedLen;
+static uint32_t imageOffset;
+static uint32_t slotLength;
+
+/***************************************************************************//**
+ * @brief
+ *    Private image storage functions.
+ ******************************************************************************/
+static bool begin_image(void);
+static sl_status_t flush_staging(void);
+static sl_status_t end_image(void);
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a command written to the OTA Control characteristic.
+ ******************************************************************************/
+sl_status_t le_ota_control(uint8_t connection, uint8_t command)
+{
+  sl_status_t sc;
+
+  if((state != STATE_IDLE) && (connection != otaConnection)) {
+    return SL_STATUS_BUSY;
+  }
+
+  switch(command) {
+    case LE_OTA_CMD_BEGIN:
+      otaConnection = connection;
+#if LE_OTA_IN_APP_ENABLE
+      // A new begin restarts the image from its first byte
+      if(begin_image()) {
+        state = STATE_RECEIVING;
+        return SL_STATUS_OK;
+      }
+#endif
+      state = STATE_APPLOADER;
+      return SL_STATUS_OK;
+
+    case LE_OTA_CMD_END:
+      if(state != STATE_RECEIVING) {
+        return SL_STATUS_INVALID_STATE;
+      }
+#if LE_OTA_IN_APP_ENABLE
+      sc = end_image();
+      if(sc != SL_STATUS_OK) {
+        state = STATE_IDLE;
+        return sc;
+      }
+      state = STATE_INSTALL;
+#else
+      sc = SL_STATUS_OK;
+#endif
+      return sc;
+
+    default:
+      return SL_STATUS_INVALID_PARAMETER;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Collect a chunk of the image in the staging buffer.
+ ******************************************************************************/
+sl_status_t le_ota_write(uint8_t connection, size_t len, const uint8_t *data)
+{
+#if LE_OTA_IN_APP_ENABLE
+  sl_status_t sc;
+
+  if((state != STATE_RECEIVING) || (connection != otaConnection)) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  while(len > 0) {
+    size_t part = LE_OTA_STAGING_SIZE - stagedLen;
+
+    if(part > len) {
+      part = len;
+    }
+    memcpy((uint8_t *)stagingBuffer + stagedLen, data, part);
+    stagedLen += part;
+    data += part;
+    len -= part;
+
+    if(stagedLen == LE_OTA_STAGING_SIZE) {
+      sc = flush_staging();
+      if(sc != SL_STATUS_OK) {
+        state = STATE_IDLE;
+        return sc;
+      }
+    }
+  }
+
+  return SL_STATUS_OK;
+#else
+  (void)connection;
+  (void)len;
+  (void)data;
+  return SL_STATUS_INVALID_STATE;
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Finish the update of a closed connection.
+ ******************************************************************************/
+void le_ota_close(uint8_t connection)
+{
+  if((state == STATE_IDLE) || (connection != otaConnection)) {
+    return;
+  }
+
+#if LE_OTA_IN_APP_ENABLE
+  if(state == STATE_INSTALL) {
+    // Does not return
+    bootloader_rebootAndInstall();
+  }
+#endif
+  if(state == STATE_APPLOADER) {
+    sl_bt_system_reset(SYSTEM_RESET_OTA_DFU);
+  }
+
+  // An unfinished image is overwritten by the next update
+  state = STATE_IDLE;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether an update is running.
+ ******************************************************************************/
+bool le_ota_in_progress(void)
+{
+  return state != STATE_IDLE;
+}
+
+#if LE_OTA_IN_APP_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Prepare the storage slot for a new image.
+ *
+ * @return
+ *    False if the bootloader has no usable storage slot.
+ ******************************************************************************/
+static bool begin_image(void)
+{
+  BootloaderStorageSlot_t slot;
+
+  if(bootloader_init() != BOOTLOADER_OK) {
+    return false;
+  }
+  if(bootloader_getStorageSlotInfo(LE_OTA_STORAGE_SLOT, &slot) != BOOTLOADER_OK) {
+    return false;
+  }
+  if(slot.length == 0) {
+    return false;
+  }
+
+  slotLength = slot.length;
+  imageOffset = 0;
+  stagedLen = 0;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Write the staging buffer to the storage slot.
+ *
+ * @details
+ *    Every batch but the last fills the buffer, so the batches start at the
+ *    page boundaries where the flash pages are erased before being written.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_WOULD_OVERFLOW if the image does not fit the
+ *    slot, or SL_STATUS_FLASH_PROGRAM_FAILED.
+ ******************************************************************************/
+static sl_status_t flush_staging(void)
+{
+  uint8_t *buffer = (uint8_t *)stagingBuffer;
+
+  while(stagedLen % 4) {
+    buffer[stagedLen++] = ERASED_FLASH_BYTE;
+  }
+  if(stagedLen == 0) {
+    return SL_STATUS_OK;
+  }
+  if((imageOffset + stagedLen) > slotLength) {
+    return SL_STATUS_WOULD_OVERFLOW;
+  }
+
+  if(bootloader_eraseWriteStorage(LE_OTA_STORAGE_SLOT,
+                                  imageOffset,
+                                  buffer,
+                                  stagedLen) != BOOTLOADER_OK) {
+    return SL_STATUS_FLASH_PROGRAM_FAILED;
+  }
+
+  imageOffset += stagedLen;
+  stagedLen = 0;
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Store the rest of the image, verify it and select it for installation.
+ *
+ * @return
+ *    SL_STATUS_OK, or SL_STATUS_FAIL if the image is rejected.
+ ******************************************************************************/
+static sl_status_t end_image(void)
+{
+  sl_status_t sc;
+
+  sc = flush_staging();
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  // Checks the GBL signature and CRC, takes a moment on a large image
+  if(bootloader_verifyImage(LE_OTA_STORAGE_SLOT, NULL) != BOOTLOADER_OK) {
+    return SL_STATUS_FAIL;
+  }
+  if(bootloader_setImageToBootload(LE_OTA_STORAGE_SLOT) != BOOTLOADER_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  return SL_STATUS_OK;
+}
+#endif
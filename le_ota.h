@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file le_ota.h
+ * @brief OTA update interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_OTA_H_
+#define LE_OTA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sl_status.h"
+#include "le_ota_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Commands written to the Silicon Labs OTA Control characteristic.
+ ******************************************************************************/
+#define LE_OTA_CMD_BEGIN    0x00  ///< Start an update
+#define LE_OTA_CMD_END      0x03  ///< The whole image has been written
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a command written to the OTA Control characteristic.
+ *
+ * @details
+ *    LE_OTA_CMD_BEGIN starts receiving the image on the OTA Data
+ *    characteristic. Without LE_OTA_IN_APP_ENABLE, or without a usable
+ *    storage slot, the device reboots into the AppLoader once the connection
+ *    is closed instead. LE_OTA_CMD_END stores the rest of the image, verifies
+ *    it and installs it once the connection is closed.
+ *
+ * @param[in] connection
+ *    Connection handle of the writing client.
+ *
+ * @param[in] command
+ *    LE_OTA_CMD_BEGIN or LE_OTA_CMD_END.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_PARAMETER for an unknown command,
+ *    SL_STATUS_BUSY if another connection is updating, or the error that
+ *    aborted the update.
+ ******************************************************************************/
+sl_status_t le_ota_control(uint8_t connection, uint8_t command);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a chunk of the image written to the OTA Data characteristic.
+ *
+ * @details
+ *    The chunks are collected in a RAM staging buffer of
+ *    LE_OTA_STAGING_SIZE bytes, which is written to the storage slot
+ *    whenever it is full. A failing write aborts the update.
+ *
+ * @param[in] connection
+ *    Connection handle of the writing client.
+ *
+ * @param[in] len
+ *    Chunk length.
+ *
+ * @param[in] data
+ *    Chunk of the image.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_STATE if no update is running on the
+ *    connection, or the error that aborted the update.
+ ******************************************************************************/
+sl_status_t le_ota_write(uint8_t connection, size_t len, const uint8_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle a closed connection: install a completed image or reboot into the
+ *    AppLoader, and abort an unfinished update.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_ota_close(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether an update is running, including a completed one waiting
+ *    for its connection to close.
+ *
+ * @return
+ *    True from LE_OTA_CMD_BEGIN until the update is aborted or its
+ *    connection is closed.
+ ******************************************************************************/
+bool le_ota_in_progress(void);
+
+#endif /* LE_OTA_H_ */
@@ -0,0 +1,268 @@
+/***************************************************************************//**
+* @file le_periodic_adv.c
+* @brief Periodic advertising definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_periodic_adv.h"
+#include <stdint.h>
+#include <string.h>
+#include "sl_bluetooth.h"
+#include "le_voltage_beacon.h"
+
+#if LE_PERIODIC_ADV_ENABLE
+
+/***************************************************************************//**
+ * @brief
+ *    Advertising data layout.
+ ******************************************************************************/
+#define AD_TYPE_FLAGS                  0x01
+#define AD_TYPE_MANUFACTURER_DATA      0xFF
+#define AD_FLAGS_LE_GENERAL_NO_BREDR   0x06
+
+// Company identifier and frame type lead scanners to the train
+#define EXT_MANUFACTURER_DATA_SIZE     (2 + 1)
+#define EXT_ADV_DATA_SIZE              (3 + 2 + EXT_MANUFACTURER_DATA_SIZE)
+
+// Company identifier, frame type, window counter, count and the windows
+#define TRAIN_MANUFACTURER_DATA_SIZE   (2 + 1 + 4 + 1 \
+                                        + (LE_PERIODIC_ADV_BATCH * LE_PERIODIC_ADV_ENTRY_SIZE))
+#define TRAIN_DATA_SIZE                (2 + TRAIN_MANUFACTURER_DATA_SIZE)
+
+// Packet type of the periodic advertising data
+#define PERIODIC_ADVERTISING_PACKET    8
+
+// Legacy advertising PDU configuration bit of an advertising set
+#define CONFIG_LEGACY_PDU              1
+
+// Advertising intervals in units of 0.625 ms, periodic ones in 1.25 ms
+#define EXT_INTERVAL                   ((LE_PERIODIC_ADV_EXT_INTERVAL_MS * 8) / 5)
+#define TRAIN_INTERVAL_MIN             0x0006
+#define TRAIN_INTERVAL_MAX             0xFFFF
+
+#if (TRAIN_DATA_SIZE > 191)
+#error "The batch exceeds one advertiser data command"
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint8_t advertisingSet = 0xff;
+
+// Counter of the newest window, and the batch, newest first
+static uint32_t sequence = 0;
+static uint8_t count = 0;
+static uint8_t entries[LE_PERIODIC_ADV_BATCH * LE_PERIODIC_ADV_ENTRY_SIZE];
+
+
+/***************************************************************************//**
+ * @brief
+ *    Periodic advertising interval of the configured reporting rate.
+ ******************************************************************************/
+static uint16_t train_interval(void)
+{
+  uint32_t interval_ms = LE_PERIODIC_ADV_INTERVAL_MS;
+  uint32_t interval;
+
+  if(interval_ms == 0) {
+    uint16_t sampling_freq_hz;
+    uint16_t num_of_samples;
+
+    le_voltage_monitor_get_config(&sampling_freq_hz, &num_of_samples);
+    interval_ms = ((uint32_t)num_of_samples * 1000) / sampling_freq_hz;
+  }
+
+  interval = (interval_ms * 4) / 5;
+  if(interval < TRAIN_INTERVAL_MIN) {
+    interval = TRAIN_INTERVAL_MIN;
+  } else if(interval > TRAIN_INTERVAL_MAX) {
+    interval = TRAIN_INTERVAL_MAX;
+  }
+
+  return (uint16_t)interval;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Write the extended advertising data pointing at the train.
+ ******************************************************************************/
+static sl_status_t set_ext_data(void)
+{
+  uint8_t adv_data[EXT_ADV_DATA_SIZE];
+  uint8_t *p = adv_data;
+
+  *p++ = 2;
+  *p++ = AD_TYPE_FLAGS;
+  *p++ = AD_FLAGS_LE_GENERAL_NO_BREDR;
+
+  *p++ = 1 + EXT_MANUFACTURER_DATA_SIZE;
+  *p++ = AD_TYPE_MANUFACTURER_DATA;
+  *p++ = LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF;
+  *p++ = (LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF;
+  *p++ = LE_VOLTAGE_BEACON_FRAME_BATCH;
+
+  return sl_bt_advertiser_set_data(advertisingSet,
+                                   sl_bt_advertiser_advertising_data_packet,
+                                   sizeof(adv_data),
+                                   adv_data);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Write the batch to the periodic advertising data. The stack repeats it
+ *    in every train event.
+ ******************************************************************************/
+static sl_status_t set_train_data(void)
+{
+  uint8_t train_data[TRAIN_DATA_SIZE];
+  uint8_t *p = train_data;
+  size_t len = count * LE_PERIODIC_ADV_ENTRY_SIZE;
+
+  // Length of the AD structure is set once the batch is in
+  p++;
+  *p++ = AD_TYPE_MANUFACTURER_DATA;
+  *p++ = LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF;
+  *p++ = (LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF;
+  *p++ = LE_VOLTAGE_BEACON_FRAME_BATCH;
+  *p++ = (sequence >> 24) & 0x00FF;
+  *p++ = (sequence >> 16) & 0x00FF;
+  *p++ = (sequence >> 8) & 0x00FF;
+  *p++ = sequence & 0x00FF;
+  *p++ = count;
+  memcpy(p, entries, len);
+  p += len;
+  train_data[0] = (uint8_t)(p - train_data - 1);
+
+  return sl_bt_advertiser_set_data(advertisingSet,
+                                   PERIODIC_ADVERTISING_PACKET,
+                                   (size_t)(p - train_data),
+                                   train_data);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Create the periodic advertising set and start the train.
+ ******************************************************************************/
+sl_status_t le_periodic_adv_start(void)
+{
+  uint16_t interval = train_interval();
+  sl_status_t sc;
+
+  sc = sl_bt_advertiser_create_set(&advertisingSet);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  // Periodic advertising needs extended advertising PDUs
+  sc = sl_bt_advertiser_clear_configuration(advertisingSet, CONFIG_LEGACY_PDU);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_bt_advertiser_set_phy(advertisingSet,
+                                LE_PERIODIC_ADV_PHY_1M,
+                                LE_PERIODIC_ADV_SECONDARY_PHY);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_bt_advertiser_set_timing(advertisingSet,
+                                   EXT_INTERVAL,
+                                   EXT_INTERVAL,
+                                   0,
+                                   0);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = set_ext_data();
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  // One fixed interval, so synchronized scanners know every next event
+  sc = sl_bt_advertiser_start_periodic_advertising(advertisingSet,
+                                                   interval,
+                                                   interval,
+                                                   0);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = set_train_data();
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_advertiser_start(advertisingSet,
+                                advertiser_user_data,
+                                advertiser_non_connectable);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add a completed window to the batch published in the train.
+ ******************************************************************************/
+sl_status_t le_periodic_adv_update(const le_voltage_monitor_summary_t *summary)
+{
+  // The oldest window drops off the end
+  memmove(&entries[LE_PERIODIC_ADV_ENTRY_SIZE],
+          entries,
+          sizeof(entries) - LE_PERIODIC_ADV_ENTRY_SIZE);
+  entries[0] = (summary->avg_mv >> 8) & 0x00FF;
+  entries[1] = summary->avg_mv & 0x00FF;
+  entries[2] = (summary->min_mv >> 8) & 0x00FF;
+  entries[3] = summary->min_mv & 0x00FF;
+  entries[4] = (summary->max_mv >> 8) & 0x00FF;
+  entries[5] = summary->max_mv & 0x00FF;
+  if(count < LE_PERIODIC_ADV_BATCH) {
+    count++;
+  }
+
+  // Lets scanners tell new windows from repeated ones
+  sequence++;
+
+  if(advertisingSet == 0xff) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  return set_train_data();
+}
+
+#endif
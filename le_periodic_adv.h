@@ -0,0 +1,84 @@
+/***************************************************************************//**
+ * @file le_periodic_adv.h
+ * @brief Periodic advertising interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_PERIODIC_ADV_H_
+#define LE_PERIODIC_ADV_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "le_voltage_monitor.h"
+#include "le_periodic_adv_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Size of one window summary in the periodic advertising data.
+ ******************************************************************************/
+#define LE_PERIODIC_ADV_ENTRY_SIZE  6
+
+
+/***************************************************************************//**
+ * @brief
+ *    Create the periodic advertising set and start the train.
+ *
+ * @details
+ *    The extended advertisements and the periodic advertising data carry the
+ *    manufacturer specific data of LE_VOLTAGE_BEACON_COMPANY_ID with frame
+ *    type LE_VOLTAGE_BEACON_FRAME_BATCH. Until the first window completes the
+ *    train carries no window summary. Only available with
+ *    LE_PERIODIC_ADV_ENABLE.
+ *
+ * @return
+ *    Status of the advertiser commands.
+ ******************************************************************************/
+sl_status_t le_periodic_adv_start(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add a completed window to the batch published in the train.
+ *
+ * @param[in] summary
+ *    Window summary.
+ *
+ * @return
+ *    Status of the advertiser command.
+ ******************************************************************************/
+sl_status_t le_periodic_adv_update(const le_voltage_monitor_summary_t *summary);
+
+#endif /* LE_PERIODIC_ADV_H_ */
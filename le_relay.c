@@ -0,0 +1,332 @@
+/***************************************************************************//**
+* @file le_relay.c
+* @brief Neighbor relay definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_relay.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sl_simple_timer.h"
+#include "sl_sleeptimer.h"
+#include "le_voltage_beacon.h"
+
+#if LE_RELAY_ENABLE
+
+/***************************************************************************//**
+ * @brief
+ *    Beacon frames of the neighbors, see le_voltage_beacon.h. The frame
+ *    starts with the frame type and holds the counter right after it.
+ ******************************************************************************/
+#define AD_TYPE_MANUFACTURER_DATA      0xFF
+
+#define PLAIN_FRAME_SIZE               (1 + 2 + 2)
+#define SEALED_FRAME_MIN_SIZE          (1 + 4 + 2 + 4)
+#define SEALED_FRAME_MAX_SIZE          (1 + 4 + 2 + 16)
+#define MAX_FRAME_SIZE                 SEALED_FRAME_MAX_SIZE
+
+// Extended advertising PDUs and scan responses carry no beacon
+#define PACKET_TYPE_EXTENDED           0x80
+#define PACKET_TYPE_EVENT_MASK         0x07
+#define PACKET_TYPE_SCAN_RESPONSE      0x04
+
+// Scan timing in units of 0.625 ms
+#define SCAN_INTERVAL                  ((LE_RELAY_SCAN_INTERVAL_MS * 8) / 5)
+#define SCAN_WINDOW                    ((LE_RELAY_SCAN_WINDOW_MS * 8) / 5)
+
+#if (LE_RELAY_SCAN_WINDOW_MS > LE_RELAY_SCAN_INTERVAL_MS)
+#error "The scan window must not exceed the scan interval"
+#endif
+
+#if ((LE_RELAY_ENTRY_HEADER_SIZE + MAX_FRAME_SIZE) > LE_RELAY_REPORT_MAX_PAYLOAD)
+#error "A neighbor must fit into one Neighbor Report"
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Latest frame of a neighbor.
+ ******************************************************************************/
+typedef struct {
+  bd_addr address;
+  uint8_t address_type;
+  int8_t rssi;
+  bool pending;        // Not reported yet
+  uint8_t frame_len;   // 0 for a free entry
+  uint8_t frame[MAX_FRAME_SIZE];
+  uint32_t tick;       // Sleeptimer tick count of the latest new frame
+} neighbor_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static neighbor_t neighbors[LE_RELAY_MAX_NEIGHBORS];
+static sl_simple_timer_t reportTimer;
+
+// A reading arrived since the last report timer expiry
+static bool fresh = false;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Find the beacon frame in the advertising data.
+ *
+ * @return
+ *    Frame length, 0 if the data holds no voltage beacon frame.
+ ******************************************************************************/
+static uint8_t find_frame(const uint8_t *data, uint8_t len, const uint8_t **frame)
+{
+  uint8_t i = 0;
+
+  while((i + 1) < len) {
+    uint8_t ad_len = data[i];
+
+    if((ad_len == 0) || ((i + 1 + ad_len) > len)) {
+      return 0;
+    }
+
+    // Company identifier, then the frame
+    if((data[i + 1] == AD_TYPE_MANUFACTURER_DATA)
+       && (ad_len > 3)
+       && (data[i + 2] == (LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF))
+       && (data[i + 3] == ((LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF))) {
+      uint8_t frame_len = ad_len - 3;
+
+      *frame = &data[i + 4];
+      if(((*frame)[0] == LE_VOLTAGE_BEACON_FRAME_PLAIN)
+         && (frame_len == PLAIN_FRAME_SIZE)) {
+        return frame_len;
+      }
+      if(((*frame)[0] == LE_VOLTAGE_BEACON_FRAME_SEALED)
+         && (frame_len >= SEALED_FRAME_MIN_SIZE)
+         && (frame_len <= SEALED_FRAME_MAX_SIZE)) {
+        return frame_len;
+      }
+      return 0;
+    }
+    i += 1 + ad_len;
+  }
+  return 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether two frames carry the same counter, i.e. the same reading.
+ ******************************************************************************/
+static bool same_reading(const neighbor_t *neighbor,
+                         const uint8_t *frame,
+                         uint8_t frame_len)
+{
+  uint8_t counter_size = (frame[0] == LE_VOLTAGE_BEACON_FRAME_PLAIN) ? 2 : 4;
+
+  return (neighbor->frame_len == frame_len)
+         && (neighbor->frame[0] == frame[0])
+         && (memcmp(&neighbor->frame[1], &frame[1], counter_size) == 0);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Find the entry of an address, or the one to take it in: a free entry or
+ *    the neighbor heard from least recently.
+ ******************************************************************************/
+static neighbor_t *find_neighbor(const bd_addr *address, uint8_t address_type)
+{
+  neighbor_t *victim = &neighbors[0];
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  for(uint32_t i = 0; i < LE_RELAY_MAX_NEIGHBORS; i++) {
+    neighbor_t *neighbor = &neighbors[i];
+
+    if(neighbor->frame_len == 0) {
+      // Used entries come first, so the address is not further on
+      return neighbor;
+    }
+    if((neighbor->address_type == address_type)
+       && (memcmp(neighbor->address.addr, address->addr, sizeof(address->addr)) == 0)) {
+      return neighbor;
+    }
+    if((now - neighbor->tick) > (now - victim->tick)) {
+      victim = neighbor;
+    }
+  }
+
+  victim->frame_len = 0;
+  return victim;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Report timer callback, called from the main loop.
+ ******************************************************************************/
+static void report_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  if(fresh) {
+    fresh = false;
+    sl_bt_external_signal(LE_RELAY_SIGNAL);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start scanning for the beacons of neighbors.
+ ******************************************************************************/
+sl_status_t le_relay_start(void)
+{
+  sl_status_t sc;
+
+  // Beacons are not connectable, nothing to ask them
+  sc = sl_bt_scanner_set_mode(sl_bt_gap_1m_phy, sl_bt_scanner_scan_mode_passive);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_bt_scanner_set_timing(sl_bt_gap_1m_phy, SCAN_INTERVAL, SCAN_WINDOW);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_simple_timer_start(&reportTimer,
+                             LE_RELAY_REPORT_INTERVAL_MS,
+                             report_timer_cb,
+                             NULL,
+                             true);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_scanner_start(sl_bt_gap_1m_phy, sl_bt_scanner_discover_observation);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in a scan report.
+ ******************************************************************************/
+void le_relay_on_scan_report(const sl_bt_evt_scanner_scan_report_t *report)
+{
+  const uint8_t *frame;
+  uint8_t frame_len;
+  neighbor_t *neighbor;
+
+  if(((report->packet_type & PACKET_TYPE_EXTENDED) != 0)
+     || ((report->packet_type & PACKET_TYPE_EVENT_MASK) == PACKET_TYPE_SCAN_RESPONSE)) {
+    return;
+  }
+
+  frame_len = find_frame(report->data.data, report->data.len, &frame);
+  if(frame_len == 0) {
+    return;
+  }
+
+  // Beacons repeat a reading until the next window, keep it once
+  neighbor = find_neighbor(&report->address, report->address_type);
+  if((neighbor->frame_len != 0) && same_reading(neighbor, frame, frame_len)) {
+    return;
+  }
+
+  neighbor->address = report->address;
+  neighbor->address_type = report->address_type;
+  neighbor->rssi = report->rssi;
+  neighbor->frame_len = frame_len;
+  memcpy(neighbor->frame, frame, frame_len);
+  neighbor->tick = sl_sleeptimer_get_tick_count();
+  neighbor->pending = true;
+  fresh = true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Report the latest frame of every neighbor again.
+ ******************************************************************************/
+void le_relay_report_all(void)
+{
+  for(uint32_t i = 0; i < LE_RELAY_MAX_NEIGHBORS; i++) {
+    if(neighbors[i].frame_len != 0) {
+      neighbors[i].pending = true;
+    }
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build a Neighbor Report of readings not reported yet.
+ ******************************************************************************/
+size_t le_relay_build(uint8_t *buf, size_t size)
+{
+  size_t len = 0;
+
+  for(uint32_t i = 0; i < LE_RELAY_MAX_NEIGHBORS; i++) {
+    neighbor_t *neighbor = &neighbors[i];
+    size_t entry_size = LE_RELAY_ENTRY_HEADER_SIZE + neighbor->frame_len;
+
+    if(!neighbor->pending) {
+      continue;
+    }
+    if(entry_size > size) {
+      // Would never fit, e.g. a sealed frame at the default ATT MTU
+      neighbor->pending = false;
+      continue;
+    }
+    if((len + entry_size) > size) {
+      continue;
+    }
+
+    // Address as in the Bluetooth SIG notation, most significant byte first
+    for(uint32_t j = 0; j < sizeof(neighbor->address.addr); j++) {
+      buf[len++] = neighbor->address.addr[sizeof(neighbor->address.addr) - 1 - j];
+    }
+    buf[len++] = neighbor->address_type;
+    buf[len++] = (uint8_t)neighbor->rssi;
+    buf[len++] = neighbor->frame_len;
+    memcpy(&buf[len], neighbor->frame, neighbor->frame_len);
+    len += neighbor->frame_len;
+    neighbor->pending = false;
+  }
+
+  return len;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @file le_relay.h
+ * @brief Neighbor relay interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_RELAY_H_
+#define LE_RELAY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+#include "le_relay_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    External signal raised when new neighbor readings are due, next to the
+ *    signals of the voltage monitor.
+ ******************************************************************************/
+#define LE_RELAY_SIGNAL               0x08
+
+/***************************************************************************//**
+ * @brief
+ *    Largest Neighbor Report value. Every neighbor is reported as its
+ *    address (most significant byte first), address type, signed RSSI in dBm
+ *    and frame length, followed by the beacon frame from the frame type on.
+ ******************************************************************************/
+#define LE_RELAY_REPORT_MAX_PAYLOAD   244
+#define LE_RELAY_ENTRY_HEADER_SIZE    9
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start scanning for the beacons of neighbors.
+ *
+ * @note
+ *    Only available with LE_RELAY_ENABLE, as all functions of this module.
+ *
+ * @return
+ *    Status of the scanner and timer commands.
+ ******************************************************************************/
+sl_status_t le_relay_start(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in a scan report. Voltage beacon frames with a sequence counter
+ *    not seen from their address before are kept for the next report.
+ *
+ * @param[in] report
+ *    Scan report event data.
+ ******************************************************************************/
+void le_relay_on_scan_report(const sl_bt_evt_scanner_scan_report_t *report);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Report the latest frame of every neighbor again, e.g. to a new
+ *    subscriber.
+ ******************************************************************************/
+void le_relay_report_all(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build a Neighbor Report of readings not reported yet.
+ *
+ * @details
+ *    As many neighbors as fit are taken in, in table order, and marked as
+ *    reported. A neighbor too large for an empty report is dropped from
+ *    it.
+ *
+ * @param[out] buf
+ *    Report buffer.
+ *
+ * @param[in] size
+ *    Size of the buffer, e.g. the ATT MTU minus 3.
+ *
+ * @return
+ *    Length of the report, 0 if no reading is left.
+ ******************************************************************************/
+size_t le_relay_build(uint8_t *buf, size_t size);
+
+#endif /* LE_RELAY_H_ */
@@ -0,0 +1,289 @@
+/***************************************************************************//**
+* @file le_retransmit.c
+* @brief Resend recently completed windows on request.
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_retransmit.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_simple_timer.h"
+#include "sl_sleeptimer.h"
+#include "sl_bluetooth.h"
+#include "gatt_db.h"
+#include "le_voltage_report.h"
+#include "le_energy_stats.h"
+
+#if LE_RETRANSMIT_ENABLE
+
+#if !LE_VOLTAGE_REPORT_SEQUENCE_ENABLE
+#error "LE_RETRANSMIT_ENABLE needs LE_VOLTAGE_REPORT_SEQUENCE_ENABLE"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    ATT notification header and the largest notification payload (ATT MTU
+ *    of 247 bytes).
+ ******************************************************************************/
+#define ATT_NOTIFICATION_HEADER_SIZE   3
+#define MAX_CHUNK_SIZE                 244
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Summaries of the latest windows, oldest first
+static le_voltage_monitor_summary_t history[LE_RETRANSMIT_HISTORY_SIZE];
+static uint16_t historyTail = 0;
+static uint16_t historyCount = 0;
+
+// Response state, next is the lowest sequence number not sent yet
+static bool responding = false;
+static bool endQueued = false;
+static uint8_t responseConnection;
+static uint32_t nextSequence;
+static uint32_t lastSequence;
+static sl_simple_timer_t drainTimer;
+static uint16_t chunkLimit;
+
+// Notification payload, sent again while the stack is out of buffers
+static uint8_t chunk[MAX_CHUNK_SIZE];
+static uint16_t chunkLen = 0;
+static uint32_t chunkNext;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the response, a chunk not accepted by the stack is dropped.
+ ******************************************************************************/
+static void stop_response(void)
+{
+  (void)sl_simple_timer_stop(&drainTimer);
+  responding = false;
+  chunkLen = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Kept windows of the remaining range, oldest first.
+ ******************************************************************************/
+static le_voltage_report_run_t pending_run(void)
+{
+  le_voltage_report_run_t run = { history, LE_RETRANSMIT_HISTORY_SIZE, 0, 0 };
+
+  for(uint16_t i = 0; i < historyCount; i++) {
+    uint16_t index = (historyTail + i) % LE_RETRANSMIT_HISTORY_SIZE;
+    uint32_t sequence = history[index].sequence;
+
+    if(sequence > lastSequence) {
+      break;
+    }
+    if(sequence >= nextSequence) {
+      if(run.count == 0) {
+        run.start = index;
+      }
+      run.count++;
+    }
+  }
+  return run;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the next payload of the response, or the closing notification
+ *    once no kept window of the range is left.
+ ******************************************************************************/
+static void fill_chunk(void)
+{
+  le_voltage_report_run_t run = pending_run();
+  uint32_t following = 0;
+
+  if(run.count > 0) {
+    le_voltage_report_clock_t clock = {
+      sl_sleeptimer_get_tick_count64(), sl_sleeptimer_get_timer_frequency()
+    };
+    uint16_t encoded;
+
+    chunkLen = (uint16_t)le_voltage_report_build_run(&run, &clock, chunk, chunkLimit,
+                                                     &encoded);
+    if(chunkLen > 0) {
+      chunkNext = history[(run.start + encoded - 1) % LE_RETRANSMIT_HISTORY_SIZE].sequence + 1;
+      return;
+    }
+  }
+
+  if(historyCount > 0) {
+    following = history[(historyTail + historyCount - 1) % LE_RETRANSMIT_HISTORY_SIZE].sequence + 1;
+  }
+  chunk[0] = (uint8_t)(following >> 24);
+  chunk[1] = (uint8_t)(following >> 16);
+  chunk[2] = (uint8_t)(following >> 8);
+  chunk[3] = (uint8_t)following;
+  chunkLen = LE_RETRANSMIT_END_SIZE;
+  endQueued = true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Queue notifications until the stack runs out of buffers.
+ ******************************************************************************/
+static void drain_step(void)
+{
+  sl_status_t sc;
+
+  while(responding) {
+    if(chunkLen == 0) {
+      fill_chunk();
+    }
+
+    sc = sl_bt_gatt_server_send_notification(responseConnection,
+                                             gattdb_window_request,
+                                             chunkLen,
+                                             chunk);
+    if(sc == SL_STATUS_NO_MORE_RESOURCE) {
+      // Retried from the drain timer
+      return;
+    }
+    if(sc != SL_STATUS_OK) {
+      stop_response();
+      return;
+    }
+
+#if LE_ENERGY_STATS_ENABLE
+    le_energy_stats_record_notification();
+#endif
+    chunkLen = 0;
+    nextSequence = chunkNext;
+    if(endQueued) {
+      stop_response();
+    }
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Drain timer callback, called from the main loop.
+ ******************************************************************************/
+static void drain_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  drain_step();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Keep the summary of a completed window.
+ ******************************************************************************/
+void le_retransmit_record(const le_voltage_monitor_summary_t *summary)
+{
+  if(historyCount == LE_RETRANSMIT_HISTORY_SIZE) {
+    historyTail = (historyTail + 1) % LE_RETRANSMIT_HISTORY_SIZE;
+    historyCount--;
+  }
+  history[(historyTail + historyCount) % LE_RETRANSMIT_HISTORY_SIZE] = *summary;
+  historyCount++;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start notifying the kept windows of a range.
+ ******************************************************************************/
+sl_status_t le_retransmit_request(uint8_t connection, uint16_t mtu,
+                                  uint32_t first, uint32_t last)
+{
+  sl_status_t sc;
+
+  if(last < first) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  stop_response();
+  responseConnection = connection;
+  nextSequence = first;
+  lastSequence = last;
+  endQueued = false;
+  chunkLimit = mtu - ATT_NOTIFICATION_HEADER_SIZE;
+  if(chunkLimit > sizeof(chunk)) {
+    chunkLimit = sizeof(chunk);
+  }
+
+  sc = sl_simple_timer_start(&drainTimer,
+                             LE_RETRANSMIT_DRAIN_INTERVAL_MS,
+                             drain_timer_cb,
+                             NULL,
+                             true);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+  responding = true;
+
+  // Sent after the write response, from the main loop
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the response if it runs on a connection.
+ ******************************************************************************/
+void le_retransmit_release(uint8_t connection)
+{
+  if(responding && (responseConnection == connection)) {
+    stop_response();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of kept windows still to be sent.
+ ******************************************************************************/
+uint16_t le_retransmit_get_backlog(void)
+{
+  if(!responding) {
+    return 0;
+  }
+  return pending_run().count;
+}
+
+#endif
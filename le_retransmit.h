@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file le_retransmit.h
+ * @brief Resend recently completed windows on request.
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_RETRANSMIT_H_
+#define LE_RETRANSMIT_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "le_voltage_monitor.h"
+#include "le_retransmit_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Window Request write: big-endian uint32 sequence numbers of the first
+ *    and of the last window to send again.
+ ******************************************************************************/
+#define LE_RETRANSMIT_REQUEST_SIZE   8
+
+/***************************************************************************//**
+ * @brief
+ *    Closing notification of a response: the big-endian uint32 sequence
+ *    number following the newest window kept.
+ ******************************************************************************/
+#define LE_RETRANSMIT_END_SIZE       4
+
+
+/***************************************************************************//**
+ * @brief
+ *    Keep the summary of a completed window. If the history is full the
+ *    oldest summary is dropped.
+ *
+ * @note
+ *    Only available with LE_RETRANSMIT_ENABLE, as all functions of this
+ *    module.
+ *
+ * @param[in] summary
+ *    Window summary.
+ ******************************************************************************/
+void le_retransmit_record(const le_voltage_monitor_summary_t *summary);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start notifying the kept windows of a range on the Window Request
+ *    characteristic, in the Average Voltage Data format. A running response
+ *    is replaced.
+ *
+ * @details
+ *    Windows missing from the history are skipped, every payload is numbered
+ *    by its first window. The response ends with a LE_RETRANSMIT_END_SIZE
+ *    notification.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ *
+ * @param[in] mtu
+ *    Negotiated ATT MTU of the connection.
+ *
+ * @param[in] first
+ *    Sequence number of the first window.
+ *
+ * @param[in] last
+ *    Sequence number of the last window.
+ *
+ * @return
+ *    SL_STATUS_OK, or SL_STATUS_INVALID_PARAMETER if last precedes first.
+ ******************************************************************************/
+sl_status_t le_retransmit_request(uint8_t connection, uint16_t mtu,
+                                  uint32_t first, uint32_t last);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the response if it runs on a connection, e.g. when the connection
+ *    closed.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_retransmit_release(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of kept windows still to be sent by the running
+ *    response.
+ *
+ * @return
+ *    Windows left, 0 if no response runs.
+ ******************************************************************************/
+uint16_t le_retransmit_get_backlog(void);
+
+#endif /* LE_RETRANSMIT_H_ */
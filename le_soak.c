@@ -0,0 +1,179 @@
+/***************************************************************************//**
+* @file le_soak.c
+* @brief Load counters of the window path for soak tests.
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_soak.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "le_tx_queue.h"
+#include "le_byte_order.h"
+#include "le_cycle_counter.h"
+
+#if LE_SOAK_ENABLE
+
+/***************************************************************************//**
+ * @brief
+ *    Soak counters, written by the main loop only.
+ ******************************************************************************/
+typedef struct {
+  uint32_t windows;
+  uint32_t lost;
+  uint32_t accepted;
+  uint32_t refused;
+  uint16_t queuePeak;
+  uint32_t lastCycles;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+} soak_counters_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static soak_counters_t counters;
+
+// Cycle count the current window started at
+static uint32_t windowStart = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start the DWT cycle counter.
+ ******************************************************************************/
+void le_soak_init(void)
+{
+  le_cycle_counter_init();
+  le_soak_reset();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Mark the main loop taking up the completed windows.
+ ******************************************************************************/
+void le_soak_begin_window(void)
+{
+  windowStart = DWT->CYCCNT;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a window handled.
+ ******************************************************************************/
+void le_soak_end_window(uint16_t overruns)
+{
+  uint32_t cycles = DWT->CYCCNT;
+
+  counters.lastCycles = cycles - windowStart;
+  if(counters.lastCycles > counters.maxCycles) {
+    counters.maxCycles = counters.lastCycles;
+  }
+  counters.sumCycles += counters.lastCycles;
+  counters.windows++;
+  counters.lost += overruns;
+
+  // The next window of the batch starts here
+  windowStart = cycles;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a notification.
+ ******************************************************************************/
+void le_soak_record_notification(bool accepted)
+{
+  if(accepted) {
+    counters.accepted++;
+  } else {
+    counters.refused++;
+  }
+
+#if LE_TX_QUEUE_ENABLE
+  if(le_tx_queue_get_pending() > counters.queuePeak) {
+    counters.queuePeak = le_tx_queue_get_pending();
+  }
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Soak value.
+ ******************************************************************************/
+size_t le_soak_build(uint8_t *buf)
+{
+  uint32_t mean = 0;
+  uint32_t dropped = 0;
+  uint8_t *p = buf;
+
+  if(counters.windows > 0) {
+    mean = (uint32_t)(counters.sumCycles / counters.windows);
+  }
+#if LE_TX_QUEUE_ENABLE
+  dropped = le_tx_queue_get_dropped();
+#endif
+
+  p = le_byte_order_put_u32(p, counters.windows);
+  p = le_byte_order_put_u32(p, counters.lost);
+  p = le_byte_order_put_u32(p, counters.accepted);
+  p = le_byte_order_put_u32(p, counters.refused);
+  p = le_byte_order_put_u32(p, dropped);
+  p = le_byte_order_put_u16(p, counters.queuePeak);
+  p = le_byte_order_put_u32(p, counters.lastCycles);
+  p = le_byte_order_put_u32(p, counters.maxCycles);
+  p = le_byte_order_put_u32(p, mean);
+  p = le_byte_order_put_u32(p, CMU_ClockFreqGet(cmuClock_HCLK));
+
+  return (size_t)(p - buf);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the counters.
+ ******************************************************************************/
+void le_soak_reset(void)
+{
+  memset(&counters, 0, sizeof(counters));
+}
+
+#endif
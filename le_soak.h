@@ -0,0 +1,117 @@
+/***************************************************************************//**
+ * @file le_soak.h
+ * @brief Load counters of the window path for soak tests.
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_SOAK_H_
+#define LE_SOAK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "le_soak_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Soak value: windows delivered, windows lost, notifications accepted,
+ *    notifications refused and notifications dropped by the transmit queue
+ *    since boot as big-endian uint32, the deepest transmit queue as
+ *    big-endian uint16,
+ *    then the cycles of the latest window, the most and the mean per window
+ *    and the core clock in Hz as big-endian uint32.
+ ******************************************************************************/
+#define LE_SOAK_VALUE_SIZE  38
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start the DWT cycle counter.
+ *
+ * @note
+ *    Only available with LE_SOAK_ENABLE, as all functions of this module.
+ ******************************************************************************/
+void le_soak_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Mark the main loop taking up the completed windows.
+ ******************************************************************************/
+void le_soak_begin_window(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a window handled, with the cycles since it was taken up or since
+ *    the previous window of the batch ended.
+ *
+ * @param[in] overruns
+ *    Windows lost before this one.
+ ******************************************************************************/
+void le_soak_end_window(uint16_t overruns);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Count a notification.
+ *
+ * @param[in] accepted
+ *    False if it was refused.
+ ******************************************************************************/
+void le_soak_record_notification(bool accepted);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Soak value.
+ *
+ * @param[out] buf
+ *    Value buffer of LE_SOAK_VALUE_SIZE bytes.
+ *
+ * @return
+ *    Length of the value.
+ ******************************************************************************/
+size_t le_soak_build(uint8_t *buf);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the counters.
+ ******************************************************************************/
+void le_soak_reset(void);
+
+#endif /* LE_SOAK_H_ */
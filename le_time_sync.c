@@ -0,0 +1,405 @@
+/***************************************************************************//**
+* @file le_time_sync.c
+* @brief Align the sampling windows to a shared time base.
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_time_sync.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "sl_sleeptimer.h"
+#include "le_voltage_beacon.h"
+#include "le_relay.h"
+
+#if LE_TIME_SYNC_ENABLE
+
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_SINGLE_SHOT)
+#error "The time synchronization needs a continuous acquisition mode"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Time source advertisements, see le_voltage_beacon.h.
+ ******************************************************************************/
+#define AD_TYPE_MANUFACTURER_DATA      0xFF
+#define PACKET_TYPE_EXTENDED           0x80
+
+// Scan timing in units of 0.625 ms, only until a source is found
+#define SCAN_INTERVAL                  160
+#define SCAN_WINDOW                    160
+
+// Synchronization timeout in units of 10 ms, every event is received
+#define SYNC_TIMEOUT                   (LE_TIME_SYNC_TIMEOUT_MS / 10)
+#define SYNC_SKIP                      0
+
+/***************************************************************************//**
+ * @brief
+ *    Time base arithmetic, in sleeptimer ticks with 8 fractional bits. The
+ *    sleeptimer and LETIMER0 both count the LF clock.
+ ******************************************************************************/
+#define FRAC_BITS                      8
+#define FRAC_ONE                       (1 << FRAC_BITS)
+#define MS_TO_FRAC(ms) \
+  (((int64_t)(ms) * sl_sleeptimer_get_timer_frequency() * FRAC_ONE) / 1000)
+
+// The time base takes a quarter of an event's deviation, the train interval
+// a sixteenth of it per elapsed interval
+#define BASE_PHASE_DIV                 4
+#define BASE_INTERVAL_DIV              16
+
+// A window's phase is trimmed by half, its drift learned by a sixteenth
+#define WINDOW_PHASE_DIV               2
+#define WINDOW_DRIFT_DIV               16
+
+// LF clock deviation of the source from the local one
+#define MAX_DRIFT_PPM                  1000
+
+// Deviating events in a row after which the time base is set again
+#define RELOCK_EVENTS                  8
+
+/***************************************************************************//**
+ * @brief
+ *    Synchronization states.
+ ******************************************************************************/
+#define STATE_IDLE                     0
+#define STATE_SEARCHING                1
+#define STATE_OPENING                  2
+#define STATE_SYNCED                   3
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint8_t state = STATE_IDLE;
+static uint16_t syncHandle;
+
+// Time base: tick of the latest train event and its fraction, the nominal
+// and the measured train interval
+static bool anchored = false;
+static uint32_t anchorTick;
+static int32_t anchorFrac;
+static int64_t nominalInterval;
+static int64_t interval;
+static uint8_t deviating = 0;
+
+// Window loop: drift per window, the trim fraction carried to the next
+// window, and when the last trim was applied
+static int32_t drift = 0;
+static int32_t trimRest = 0;
+static bool trimmed = false;
+static uint32_t trimTick;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether the advertising data holds the time source frame.
+ ******************************************************************************/
+static bool is_time_source(const uint8_t *data, uint8_t len)
+{
+  uint8_t i = 0;
+
+  while((i + 1) < len) {
+    uint8_t ad_len = data[i];
+
+    if((ad_len == 0) || ((i + 1 + ad_len) > len)) {
+      return false;
+    }
+
+    // Company identifier, then the frame type
+    if((data[i + 1] == AD_TYPE_MANUFACTURER_DATA)
+       && (ad_len > 3)
+       && (data[i + 2] == (LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF))
+       && (data[i + 3] == ((LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF))) {
+      return data[i + 4] == LE_VOLTAGE_BEACON_FRAME_TIME;
+    }
+    i += 1 + ad_len;
+  }
+  return false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Scan for a time source.
+ ******************************************************************************/
+static sl_status_t start_scanner(void)
+{
+#if LE_RELAY_ENABLE
+  // The relay scans all the time
+  return SL_STATUS_OK;
+#else
+  sl_status_t sc;
+
+  sc = sl_bt_scanner_set_mode(sl_bt_gap_1m_phy, sl_bt_scanner_scan_mode_passive);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = sl_bt_scanner_set_timing(sl_bt_gap_1m_phy, SCAN_INTERVAL, SCAN_WINDOW);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_scanner_start(sl_bt_gap_1m_phy, sl_bt_scanner_discover_observation);
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Forget the time base, the windows run free until the next one.
+ ******************************************************************************/
+static void drop_time_base(void)
+{
+  anchored = false;
+  deviating = 0;
+  drift = 0;
+  trimRest = 0;
+  trimmed = false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start looking for a time source.
+ ******************************************************************************/
+sl_status_t le_time_sync_start(void)
+{
+  sl_status_t sc;
+
+  sc = sl_bt_sync_set_parameters(SYNC_SKIP, SYNC_TIMEOUT, 0);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  state = STATE_SEARCHING;
+  return start_scanner();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Open the synchronization to the first time source heard.
+ ******************************************************************************/
+void le_time_sync_on_scan_report(const sl_bt_evt_scanner_scan_report_t *report)
+{
+  if((state != STATE_SEARCHING)
+     || ((report->packet_type & PACKET_TYPE_EXTENDED) == 0)
+     || (report->periodic_interval == 0)
+     || !is_time_source(report->data.data, report->data.len)) {
+    return;
+  }
+
+  if(sl_bt_sync_open(report->address,
+                     report->address_type,
+                     report->adv_sid,
+                     &syncHandle) == SL_STATUS_OK) {
+    state = STATE_OPENING;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in the interval of the train.
+ ******************************************************************************/
+void le_time_sync_on_opened(const sl_bt_evt_sync_opened_t *opened)
+{
+  if((state != STATE_OPENING) || (opened->sync != syncHandle)) {
+    return;
+  }
+
+  // Periodic advertising interval in units of 1.25 ms
+  nominalInterval = MS_TO_FRAC(opened->adv_interval * 5) / 4;
+  interval = nominalInterval;
+  drop_time_base();
+  state = STATE_SYNCED;
+
+#if !LE_RELAY_ENABLE
+  // The controller follows the train on its own
+  (void)sl_bt_scanner_stop();
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Move the time base towards an event of the train.
+ ******************************************************************************/
+void le_time_sync_on_data(const sl_bt_evt_sync_data_t *data)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  int64_t max_drift = (nominalInterval * MAX_DRIFT_PPM) / 1000000;
+  int64_t elapsed;
+  int64_t events;
+  int64_t deviation;
+  int64_t next;
+
+  if((state != STATE_SYNCED) || (data->sync != syncHandle)) {
+    return;
+  }
+
+  if(!anchored) {
+    anchorTick = now;
+    anchorFrac = 0;
+    anchored = true;
+    return;
+  }
+
+  // Whole train intervals since the last event taken in, none for the
+  // chained packets of the same event
+  elapsed = ((int64_t)(uint32_t)(now - anchorTick) * FRAC_ONE) - anchorFrac;
+  events = (elapsed + (interval / 2)) / interval;
+  if(events == 0) {
+    return;
+  }
+
+  // Handled late, e.g. after a long NVM3 operation
+  deviation = elapsed - (events * interval);
+  if(llabs(deviation) > MS_TO_FRAC(LE_TIME_SYNC_MAX_LATENCY_MS)) {
+    if(++deviating >= RELOCK_EVENTS) {
+      drop_time_base();
+    }
+    return;
+  }
+  deviating = 0;
+
+  next = anchorFrac + (events * interval) + (deviation / BASE_PHASE_DIV);
+  anchorTick += (uint32_t)(next / FRAC_ONE);
+  anchorFrac = (int32_t)(next % FRAC_ONE);
+
+  interval += deviation / (BASE_INTERVAL_DIV * events);
+  if(interval > (nominalInterval + max_drift)) {
+    interval = nominalInterval + max_drift;
+  } else if(interval < (nominalInterval - max_drift)) {
+    interval = nominalInterval - max_drift;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Look for a time source again.
+ ******************************************************************************/
+void le_time_sync_on_closed(const sl_bt_evt_sync_closed_t *closed)
+{
+  if(((state != STATE_OPENING) && (state != STATE_SYNCED))
+     || (closed->sync != syncHandle)) {
+    return;
+  }
+
+  drop_time_base();
+  state = STATE_SEARCHING;
+  (void)start_scanner();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Trim the window in progress towards the time base.
+ ******************************************************************************/
+void le_time_sync_on_window(const le_voltage_monitor_summary_t *summary)
+{
+  uint32_t trigger_ticks;
+  uint32_t window_ticks;
+  int64_t window;
+  int64_t grid;
+  int64_t reach;
+  int64_t phase;
+  int32_t correction;
+  int32_t ticks;
+  int32_t applied;
+
+  if(!anchored) {
+    return;
+  }
+
+  // Completed before the last trim, its phase does not show it
+  if(trimmed && ((int32_t)(summary->tick - trimTick) < 0)) {
+    return;
+  }
+
+  le_voltage_monitor_get_ticks(&trigger_ticks, &window_ticks);
+  window = (int64_t)window_ticks * FRAC_ONE;
+  reach = ((int64_t)trigger_ticks * FRAC_ONE) / 4;
+
+  // Windows per train interval, or train intervals per window
+  if(window < interval) {
+    grid = interval / ((interval + (window / 2)) / window);
+  } else {
+    grid = interval * ((window + (interval / 2)) / interval);
+  }
+  if(llabs(grid - window) > reach) {
+    // The window does not fit the train
+    return;
+  }
+
+  // Phase of the completion on the grid, within half a window
+  phase = (((int64_t)(int32_t)(summary->tick - anchorTick) * FRAC_ONE) - anchorFrac) % grid;
+  if(phase < 0) {
+    phase += grid;
+  }
+  if(phase > (grid / 2)) {
+    phase -= grid;
+  }
+
+  // The drift is learned once the windows are close, it is the difference
+  // between the local window and the grid
+  if(llabs(phase) < reach) {
+    drift -= (int32_t)(phase / WINDOW_DRIFT_DIV);
+    if(drift > reach) {
+      drift = (int32_t)reach;
+    } else if(drift < -reach) {
+      drift = -(int32_t)reach;
+    }
+  }
+
+  correction = drift - (int32_t)(phase / WINDOW_PHASE_DIV) + trimRest;
+  ticks = correction / FRAC_ONE;
+  trimRest = correction - (ticks * FRAC_ONE);
+
+  applied = le_voltage_monitor_trim(ticks);
+  if(applied != ticks) {
+    // The phase of the next window shows what is left
+    trimRest = 0;
+  }
+  if(applied != 0) {
+    trimmed = true;
+    trimTick = sl_sleeptimer_get_tick_count();
+  }
+}
+
+#endif
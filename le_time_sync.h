@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file le_time_sync.h
+ * @brief Align the sampling windows to a shared time base.
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_TIME_SYNC_H_
+#define LE_TIME_SYNC_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+#include "le_voltage_monitor.h"
+#include "le_time_sync_config.h"
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start looking for a time source.
+ *
+ * @details
+ *    A time source is a periodic advertising train whose extended
+ *    advertisements carry the manufacturer specific data of
+ *    LE_VOLTAGE_BEACON_COMPANY_ID with frame type
+ *    LE_VOLTAGE_BEACON_FRAME_TIME. The node synchronizes to the first one
+ *    heard, and looks again once the synchronization is lost. The scanner is
+ *    stopped while synchronized, unless the relay runs it. Only available
+ *    with LE_TIME_SYNC_ENABLE, as all functions of this module.
+ *
+ * @return
+ *    Status of the scanner and synchronization commands.
+ ******************************************************************************/
+sl_status_t le_time_sync_start(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in a scan report, an extended advertisement of a time source opens
+ *    the synchronization.
+ *
+ * @param[in] report
+ *    Scan report event data.
+ ******************************************************************************/
+void le_time_sync_on_scan_report(const sl_bt_evt_scanner_scan_report_t *report);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in the interval of the train once synchronized.
+ *
+ * @param[in] opened
+ *    Synchronization opened event data.
+ ******************************************************************************/
+void le_time_sync_on_opened(const sl_bt_evt_sync_opened_t *opened);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Take in an event of the train, timestamped on arrival.
+ *
+ * @param[in] data
+ *    Periodic advertising data event data.
+ ******************************************************************************/
+void le_time_sync_on_data(const sl_bt_evt_sync_data_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Drop the time base and look for a time source again.
+ *
+ * @param[in] closed
+ *    Synchronization closed event data.
+ ******************************************************************************/
+void le_time_sync_on_closed(const sl_bt_evt_sync_closed_t *closed);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Trim the window in progress by the phase of a completed window on the
+ *    time base, and by the drift between the local and the source clocks.
+ *
+ * @note
+ *    To be called for every window right after it completed, before it is
+ *    filtered or queued.
+ *
+ * @param[in] summary
+ *    Summary of the completed window.
+ ******************************************************************************/
+void le_time_sync_on_window(const le_voltage_monitor_summary_t *summary);
+
+#endif /* LE_TIME_SYNC_H_ */
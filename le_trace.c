@@ -0,0 +1,186 @@
+/***************************************************************************//**
+* @file le_trace.c
+* @brief Cycle stamps and latency histograms along the path of a window.
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_trace.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_core.h"
+#include "em_cmu.h"
+#include "le_byte_order.h"
+#include "le_cycle_counter.h"
+
+#if LE_TRACE_ENABLE
+
+/***************************************************************************//**
+ * @brief
+ *    Stamp of a trace point.
+ ******************************************************************************/
+typedef struct {
+  uint32_t cycles;
+  uint8_t point;
+} trace_entry_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Latest stamps, oldest first from ringHead - ringCount
+static trace_entry_t ring[LE_TRACE_RING_SIZE];
+static uint16_t ringHead = 0;
+static uint16_t ringCount = 0;
+
+// Stamp of every point, and the points whose span is not counted yet
+static uint32_t lastCycles[LE_TRACE_NUM_POINTS];
+static uint8_t pendingPoints = 0;
+
+static uint16_t histograms[LE_TRACE_NUM_SPANS][LE_TRACE_BINS];
+
+
+/***************************************************************************//**
+ * @brief
+ *    Histogram bin of a span.
+ ******************************************************************************/
+static uint32_t span_bin(uint32_t cycles)
+{
+  uint32_t scaled = cycles >> LE_TRACE_BIN_SHIFT;
+  uint32_t bin;
+
+  if(scaled == 0) {
+    return 0;
+  }
+  bin = 31 - __CLZ(scaled);
+  return (bin < LE_TRACE_BINS) ? bin : (LE_TRACE_BINS - 1);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start the DWT cycle counter.
+ ******************************************************************************/
+void le_trace_init(void)
+{
+  le_cycle_counter_init();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stamp a trace point.
+ ******************************************************************************/
+void le_trace_record(uint8_t point)
+{
+  uint32_t cycles = DWT->CYCCNT;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  ring[ringHead].cycles = cycles;
+  ring[ringHead].point = point;
+  ringHead = (ringHead + 1) % LE_TRACE_RING_SIZE;
+  if(ringCount < LE_TRACE_RING_SIZE) {
+    ringCount++;
+  }
+
+  if((point > 0) && ((pendingPoints & (1 << (point - 1))) != 0)) {
+    uint16_t *bin = &histograms[point - 1][span_bin(cycles - lastCycles[point - 1])];
+
+    // Saturates instead of wrapping
+    if(*bin < UINT16_MAX) {
+      (*bin)++;
+    }
+    pendingPoints &= ~(1 << (point - 1));
+  }
+  lastCycles[point] = cycles;
+  pendingPoints |= 1 << point;
+  CORE_EXIT_ATOMIC();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Trace value.
+ ******************************************************************************/
+size_t le_trace_build(uint8_t *buf)
+{
+  uint32_t clock_hz = CMU_ClockFreqGet(cmuClock_HCLK);
+  uint8_t *p = buf;
+  CORE_DECLARE_IRQ_STATE;
+
+  p = le_byte_order_put_u32(p, clock_hz);
+  *p++ = LE_TRACE_BIN_SHIFT;
+
+  // A consistent copy, the LDMA interrupt stamps too
+  CORE_ENTER_ATOMIC();
+  for(uint32_t span = 0; span < LE_TRACE_NUM_SPANS; span++) {
+    for(uint32_t bin = 0; bin < LE_TRACE_BINS; bin++) {
+      p = le_byte_order_put_u16(p, histograms[span][bin]);
+    }
+  }
+
+  *p++ = (uint8_t)ringCount;
+  for(uint16_t i = 0; i < ringCount; i++) {
+    const trace_entry_t *entry =
+      &ring[(ringHead + LE_TRACE_RING_SIZE - ringCount + i) % LE_TRACE_RING_SIZE];
+
+    *p++ = entry->point;
+    p = le_byte_order_put_u32(p, entry->cycles);
+  }
+  CORE_EXIT_ATOMIC();
+
+  return (size_t)(p - buf);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the histograms and the stamps.
+ ******************************************************************************/
+void le_trace_reset(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  memset(histograms, 0, sizeof(histograms));
+  ringHead = 0;
+  ringCount = 0;
+  pendingPoints = 0;
+  CORE_EXIT_ATOMIC();
+}
+
+#endif
@@ -0,0 +1,118 @@
+/***************************************************************************//**
+ * @file le_trace.h
+ * @brief Cycle stamps and latency histograms along the path of a window.
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_TRACE_H_
+#define LE_TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "le_trace_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Trace points, in the order a window passes them. Span n lasts from
+ *    point n to point n + 1.
+ ******************************************************************************/
+#define LE_TRACE_ISR_ENTRY     0   ///< LDMA interrupt handing a window over
+#define LE_TRACE_SIGNAL        1   ///< Main loop dispatching the monitor signal
+#define LE_TRACE_REDUCED       2   ///< Window reduced to its summary
+#define LE_TRACE_NOTIFIED      3   ///< Window data notification accepted
+#define LE_TRACE_NUM_POINTS    4
+#define LE_TRACE_NUM_SPANS     (LE_TRACE_NUM_POINTS - 1)
+
+/***************************************************************************//**
+ * @brief
+ *    Histogram bins per span, and the Trace value: core clock in Hz as
+ *    big-endian uint32, LE_TRACE_BIN_SHIFT, the bins of every span as
+ *    big-endian uint16, then the number of stamps followed by the stamps,
+ *    oldest first, as the trace point and the big-endian uint32 cycle count.
+ ******************************************************************************/
+#define LE_TRACE_BINS          16
+#define LE_TRACE_ENTRY_SIZE    5
+#define LE_TRACE_VALUE_SIZE \
+  (4 + 1 + (2 * LE_TRACE_NUM_SPANS * LE_TRACE_BINS) + 1              \
+   + (LE_TRACE_ENTRY_SIZE * LE_TRACE_RING_SIZE))
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start the DWT cycle counter.
+ *
+ * @note
+ *    Only available with LE_TRACE_ENABLE, as all functions of this module.
+ ******************************************************************************/
+void le_trace_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stamp a trace point, and add the span since the previous point of the
+ *    window to its histogram.
+ *
+ * @details
+ *    A span is counted once its start point was passed since the span was
+ *    last counted, e.g. the notification of a batch counts from the latest
+ *    reduction. May be called from interrupt handlers.
+ *
+ * @param[in] point
+ *    LE_TRACE_ISR_ENTRY to LE_TRACE_NOTIFIED.
+ ******************************************************************************/
+void le_trace_record(uint8_t point);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Trace value.
+ *
+ * @param[out] buf
+ *    Value buffer of LE_TRACE_VALUE_SIZE bytes.
+ *
+ * @return
+ *    Length of the value.
+ ******************************************************************************/
+size_t le_trace_build(uint8_t *buf);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the histograms and the stamps.
+ ******************************************************************************/
+void le_trace_reset(void);
+
+#endif /* LE_TRACE_H_ */
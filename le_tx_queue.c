@@ -0,0 +1,240 @@
+/***************************************************************************//**
+* @file le_tx_queue.c
+* @brief Notification transmit queue definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_tx_queue.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sl_simple_timer.h"
+#include "sl_bluetooth.h"
+#include "le_energy_stats.h"
+
+#if LE_TX_QUEUE_CONGESTION_DEPTH > LE_TX_QUEUE_DEPTH
+#error "LE_TX_QUEUE_CONGESTION_DEPTH exceeds LE_TX_QUEUE_DEPTH"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Queued notification.
+ ******************************************************************************/
+typedef struct {
+  uint8_t connection;
+  uint16_t characteristic;
+  uint8_t len;
+  uint8_t data[LE_TX_QUEUE_MAX_PAYLOAD];
+} tx_entry_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Ring of queued notifications, the oldest at queueTail
+static tx_entry_t queue[LE_TX_QUEUE_DEPTH];
+static uint16_t queueTail = 0;
+static uint16_t queueCount = 0;
+static uint32_t dropped = 0;
+
+static sl_simple_timer_t retryTimer;
+static bool retrying = false;
+
+
+static void retry_timer_cb(sl_simple_timer_t *timer, void *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send queued notifications until the stack runs out of buffers.
+ ******************************************************************************/
+static void drain(void)
+{
+  sl_status_t sc;
+
+  while(queueCount > 0) {
+    tx_entry_t *entry = &queue[queueTail];
+
+    sc = sl_bt_gatt_server_send_notification(entry->connection,
+                                             entry->characteristic,
+                                             entry->len,
+                                             entry->data);
+    if(sc == SL_STATUS_NO_MORE_RESOURCE) {
+      // Retried once the stack had time to release buffers
+      if(!retrying) {
+        retrying = (sl_simple_timer_start(&retryTimer,
+                                          LE_TX_QUEUE_RETRY_INTERVAL_MS,
+                                          retry_timer_cb,
+                                          NULL,
+                                          false) == SL_STATUS_OK);
+      }
+      return;
+    }
+
+    if(sc == SL_STATUS_OK) {
+#if LE_ENERGY_STATS_ENABLE
+      le_energy_stats_record_notification();
+#endif
+    } else {
+      // Not going to succeed on a retry either
+      dropped++;
+    }
+    queueTail = (queueTail + 1) % LE_TX_QUEUE_DEPTH;
+    queueCount--;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Retry timer callback, called from the main loop.
+ ******************************************************************************/
+static void retry_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  retrying = false;
+  drain();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard the notifications queued for a closed connection.
+ ******************************************************************************/
+void le_tx_queue_close(uint8_t connection)
+{
+  uint16_t kept = 0;
+
+  // Close the gaps, keeping the order of the others
+  for(uint16_t i = 0; i < queueCount; i++) {
+    const tx_entry_t *entry = &queue[(queueTail + i) % LE_TX_QUEUE_DEPTH];
+
+    if(entry->connection != connection) {
+      if(kept != i) {
+        queue[(queueTail + kept) % LE_TX_QUEUE_DEPTH] = *entry;
+      }
+      kept++;
+    }
+  }
+  queueCount = kept;
+
+  if((queueCount == 0) && retrying) {
+    (void)sl_simple_timer_stop(&retryTimer);
+    retrying = false;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send a notification, or queue it if the stack is out of buffers.
+ ******************************************************************************/
+sl_status_t le_tx_queue_send(uint8_t connection,
+                             uint16_t characteristic,
+                             size_t len,
+                             const uint8_t *data)
+{
+  sl_status_t sc;
+  tx_entry_t *entry;
+
+  if(len > LE_TX_QUEUE_MAX_PAYLOAD) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if(queueCount == 0) {
+    // Nothing to keep the order of, try the stack first
+    sc = sl_bt_gatt_server_send_notification(connection,
+                                             characteristic,
+                                             len,
+                                             data);
+    if(sc != SL_STATUS_NO_MORE_RESOURCE) {
+#if LE_ENERGY_STATS_ENABLE
+      if(sc == SL_STATUS_OK) {
+        le_energy_stats_record_notification();
+      }
+#endif
+      return sc;
+    }
+  }
+
+  if(queueCount == LE_TX_QUEUE_DEPTH) {
+    // Drop the oldest notification
+    queueTail = (queueTail + 1) % LE_TX_QUEUE_DEPTH;
+    queueCount--;
+    dropped++;
+  }
+
+  entry = &queue[(queueTail + queueCount) % LE_TX_QUEUE_DEPTH];
+  entry->connection = connection;
+  entry->characteristic = characteristic;
+  entry->len = (uint8_t)len;
+  memcpy(entry->data, data, len);
+  queueCount++;
+
+  drain();
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the backpressure signal.
+ ******************************************************************************/
+bool le_tx_queue_is_congested(void)
+{
+  return queueCount >= LE_TX_QUEUE_CONGESTION_DEPTH;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of queued notifications.
+ ******************************************************************************/
+uint16_t le_tx_queue_get_pending(void)
+{
+  return queueCount;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of dropped notifications.
+ ******************************************************************************/
+uint32_t le_tx_queue_get_dropped(void)
+{
+  return dropped;
+}
@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file le_tx_queue.h
+ * @brief Notification transmit queue interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_TX_QUEUE_H_
+#define LE_TX_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sl_status.h"
+#include "le_tx_queue_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Largest queued notification payload (ATT MTU of 247 bytes).
+ ******************************************************************************/
+#define LE_TX_QUEUE_MAX_PAYLOAD   244
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard the notifications queued for a closed connection.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_tx_queue_close(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send a notification, or queue it if the stack is out of buffers.
+ *
+ * @details
+ *    Notifications leave in the order they were passed, whatever their
+ *    connection, since the stack buffers are shared. While some are queued
+ *    a new one is queued behind them, and the queue is drained until
+ *    the stack refuses one. Refused notifications are retried every
+ *    LE_TX_QUEUE_RETRY_INTERVAL_MS. If the queue is full the oldest entry is
+ *    dropped.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ *
+ * @param[in] characteristic
+ *    GATT database handle of the characteristic.
+ *
+ * @param[in] len
+ *    Payload length, at most LE_TX_QUEUE_MAX_PAYLOAD.
+ *
+ * @param[in] data
+ *    Payload, copied if queued.
+ *
+ * @return
+ *    SL_STATUS_OK if sent or queued, SL_STATUS_INVALID_PARAMETER if too
+ *    long, or the error of the stack.
+ ******************************************************************************/
+sl_status_t le_tx_queue_send(uint8_t connection,
+                             uint16_t characteristic,
+                             size_t len,
+                             const uint8_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the backpressure signal.
+ *
+ * @return
+ *    True if at least LE_TX_QUEUE_CONGESTION_DEPTH notifications are queued.
+ *    New windows should then be held back and batched.
+ ******************************************************************************/
+bool le_tx_queue_is_congested(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of queued notifications.
+ ******************************************************************************/
+uint16_t le_tx_queue_get_pending(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of notifications dropped since boot.
+ ******************************************************************************/
+uint32_t le_tx_queue_get_dropped(void);
+
+#endif /* LE_TX_QUEUE_H_ */
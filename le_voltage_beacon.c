@@ -0,0 +1,374 @@
+/***************************************************************************//**
+* @file le_voltage_beacon.c
+* @brief Voltage beacon definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_voltage_beacon.h"
+#include <stdint.h>
+#include <string.h>
+#include "sl_bluetooth.h"
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+#include "em_system.h"
+#include "nvm3_default.h"
+#include "sl_se_manager.h"
+#include "sl_se_manager_cipher.h"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Advertising data layout.
+ ******************************************************************************/
+#define AD_TYPE_FLAGS                  0x01
+#define AD_TYPE_MANUFACTURER_DATA      0xFF
+#define AD_FLAGS_LE_GENERAL_NO_BREDR   0x06
+
+// Company identifier, frame type, sequence counter, average and, if sealed,
+// the tag
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+#define MANUFACTURER_DATA_SIZE         (2 + 1 + 4 + 2 + LE_VOLTAGE_BEACON_TAG_SIZE)
+#else
+#define MANUFACTURER_DATA_SIZE         (2 + 1 + 2 + 2)
+#endif
+#define ADV_DATA_SIZE                  (3 + 2 + MANUFACTURER_DATA_SIZE)
+
+// Advertising interval in units of 0.625 ms
+#define BEACON_INTERVAL                ((LE_VOLTAGE_BEACON_INTERVAL_MS * 8) / 5)
+
+
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Sealed frame layout. The header up to the frame counter is the
+ *    additional authenticated data, the nonce is the device unique ID, the
+ *    frame counter and the frame type.
+ ******************************************************************************/
+#define SEAL_KEY_SIZE                  16
+#define SEAL_HEADER_SIZE               (2 + 1 + 4)
+#define SEAL_PAYLOAD_SIZE              2
+#define SEAL_NONCE_SIZE                13
+
+#if (ADV_DATA_SIZE > 31)
+#error "Sealed beacon exceeds the legacy advertising data"
+#endif
+
+#if (LE_VOLTAGE_BEACON_TAG_SIZE < 4) || (LE_VOLTAGE_BEACON_TAG_SIZE > 16) \
+  || ((LE_VOLTAGE_BEACON_TAG_SIZE % 2) != 0)
+#error "AES-CCM tags are 4 to 16 bytes, in steps of two"
+#endif
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+static uint32_t sequence = 0;
+
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+// Frame counters from reservedSequence on are not stored as used yet
+static uint32_t reservedSequence = 0;
+
+// The key is loaded once, the accelerator reads it from here
+static uint8_t sealKey[SEAL_KEY_SIZE];
+static bool sealReady = false;
+static uint8_t sealNonce[SEAL_NONCE_SIZE];
+static sl_se_command_context_t sealContext;
+static const sl_se_key_descriptor_t sealKeyDescriptor = {
+  .type = SL_SE_KEY_TYPE_AES_128,
+  .flags = 0,
+  .storage.method = SL_SE_KEY_STORAGE_EXTERNAL_PLAINTEXT,
+  .storage.location.buffer.pointer = sealKey,
+  .storage.location.buffer.size = sizeof(sealKey),
+};
+#endif
+
+
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Reserve frame counters in NVM3 before the next one is used, so none is
+ *    ever sealed twice, not even across a reset.
+ ******************************************************************************/
+static sl_status_t reserve_sequence(uint32_t next)
+{
+  uint8_t reserved[4];
+  uint32_t value;
+
+  if(next < reservedSequence) {
+    return SL_STATUS_OK;
+  }
+
+  value = next + LE_VOLTAGE_BEACON_COUNTER_RESERVE;
+  if(value < next) {
+    // Counter space exhausted, a new key is due
+    return SL_STATUS_FAIL;
+  }
+
+  reserved[0] = (value >> 24) & 0x00FF;
+  reserved[1] = (value >> 16) & 0x00FF;
+  reserved[2] = (value >> 8) & 0x00FF;
+  reserved[3] = value & 0x00FF;
+  if(nvm3_writeData(nvm3_defaultHandle,
+                    LE_VOLTAGE_BEACON_COUNTER_NVM3_KEY,
+                    reserved,
+                    sizeof(reserved)) != ECODE_NVM3_OK) {
+    return SL_STATUS_FAIL;
+  }
+
+  reservedSequence = value;
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Read an NVM3 data object of an exact size.
+ ******************************************************************************/
+static bool read_object(nvm3_ObjectKey_t key, uint8_t *data, size_t size)
+{
+  uint32_t type;
+  size_t len;
+
+  return (nvm3_getObjectInfo(nvm3_defaultHandle, key, &type, &len) == ECODE_NVM3_OK)
+         && (type == NVM3_OBJECTTYPE_DATA)
+         && (len == size)
+         && (nvm3_readData(nvm3_defaultHandle, key, data, size) == ECODE_NVM3_OK);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encrypt the average and append the tag over the header and the average.
+ *    Runs on the accelerator while the LDMA fills the next window.
+ ******************************************************************************/
+static sl_status_t seal(const uint8_t *header, uint8_t *payload, uint8_t *tag)
+{
+  uint8_t plain[SEAL_PAYLOAD_SIZE];
+
+  // Frame counter and type of the nonce, the unique ID is set once
+  memcpy(&sealNonce[8], &header[3], 4);
+  sealNonce[12] = header[2];
+
+  memcpy(plain, payload, sizeof(plain));
+  return sl_se_ccm_encrypt_and_tag(&sealContext,
+                                   &sealKeyDescriptor,
+                                   sizeof(plain),
+                                   sealNonce,
+                                   sizeof(sealNonce),
+                                   header,
+                                   SEAL_HEADER_SIZE,
+                                   plain,
+                                   payload,
+                                   tag,
+                                   LE_VOLTAGE_BEACON_TAG_SIZE);
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Write the advertising data of the latest average.
+ ******************************************************************************/
+static sl_status_t set_adv_data(uint8_t advertising_set, uint16_t avg_mv)
+{
+  uint8_t adv_data[ADV_DATA_SIZE];
+  uint8_t *p = adv_data;
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+  uint8_t *header;
+  sl_status_t sc;
+#endif
+
+  *p++ = 2;
+  *p++ = AD_TYPE_FLAGS;
+  *p++ = AD_FLAGS_LE_GENERAL_NO_BREDR;
+
+  *p++ = 1 + MANUFACTURER_DATA_SIZE;
+  *p++ = AD_TYPE_MANUFACTURER_DATA;
+  // Company identifier is little-endian, as every Bluetooth assigned number
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+  header = p;
+  *p++ = LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF;
+  *p++ = (LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF;
+  *p++ = LE_VOLTAGE_BEACON_FRAME_SEALED;
+  *p++ = (sequence >> 24) & 0x00FF;
+  *p++ = (sequence >> 16) & 0x00FF;
+  *p++ = (sequence >> 8) & 0x00FF;
+  *p++ = sequence & 0x00FF;
+  *p++ = (avg_mv >> 8) & 0x00FF;
+  *p++ = avg_mv & 0x00FF;
+
+  if(!sealReady) {
+    return SL_STATUS_NOT_INITIALIZED;
+  }
+  sc = reserve_sequence(sequence);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+  sc = seal(header, &header[SEAL_HEADER_SIZE], p);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+#else
+  *p++ = LE_VOLTAGE_BEACON_COMPANY_ID & 0x00FF;
+  *p++ = (LE_VOLTAGE_BEACON_COMPANY_ID >> 8) & 0x00FF;
+  *p++ = LE_VOLTAGE_BEACON_FRAME_PLAIN;
+  *p++ = (sequence >> 8) & 0x00FF;
+  *p++ = sequence & 0x00FF;
+  *p++ = (avg_mv >> 8) & 0x00FF;
+  *p++ = avg_mv & 0x00FF;
+#endif
+
+  return sl_bt_advertiser_set_data(advertising_set,
+                                   sl_bt_advertiser_advertising_data_packet,
+                                   sizeof(adv_data),
+                                   adv_data);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Load the key and the frame counter reservation of sealed frames.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_init(void)
+{
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+  uint8_t reserved[4];
+  uint64_t unique = SYSTEM_GetUnique();
+  sl_status_t sc;
+
+  // Counters below the stored reservation may have been used before
+  if(read_object(LE_VOLTAGE_BEACON_COUNTER_NVM3_KEY, reserved, sizeof(reserved))) {
+    reservedSequence = ((uint32_t)reserved[0] << 24) | ((uint32_t)reserved[1] << 16)
+                       | ((uint32_t)reserved[2] << 8) | reserved[3];
+    sequence = reservedSequence;
+  }
+
+  if(!read_object(LE_VOLTAGE_BEACON_KEY_NVM3_KEY, sealKey, sizeof(sealKey))) {
+#if LE_VOLTAGE_BEACON_DEV_KEY_ENABLE
+    static const uint8_t dev_key[SEAL_KEY_SIZE] = LE_VOLTAGE_BEACON_DEV_KEY;
+
+    memcpy(sealKey, dev_key, sizeof(sealKey));
+#else
+    return SL_STATUS_NOT_FOUND;
+#endif
+  }
+
+  // Unique per device, so devices sharing a key never share a nonce
+  for(uint32_t i = 0; i < 8; i++) {
+    sealNonce[i] = (unique >> (56 - (8 * i))) & 0x00FF;
+  }
+
+  sc = sl_se_init();
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+  sc = sl_se_init_command_context(&sealContext);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+  sealReady = true;
+#endif
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start broadcasting non-connectable advertisements.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_start(uint8_t advertising_set)
+{
+  sl_status_t sc;
+
+  sc = sl_bt_advertiser_set_timing(advertising_set,
+                                   BEACON_INTERVAL,
+                                   BEACON_INTERVAL,
+                                   0,
+                                   0);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  sc = set_adv_data(advertising_set, 0);
+  if(sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  return sl_bt_advertiser_start(advertising_set,
+                                advertiser_user_data,
+                                advertiser_non_connectable);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Publish the average of a completed window.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_update(uint8_t advertising_set,
+                                     const le_voltage_monitor_summary_t *summary)
+{
+  // Lets scanners tell a new reading from a repeated advertisement
+  sequence++;
+
+  return set_adv_data(advertising_set, summary->avg_mv);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the sequence counter of the latest published window.
+ ******************************************************************************/
+uint32_t le_voltage_beacon_get_sequence(void)
+{
+  return sequence;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Continue the sequence counter of an earlier run.
+ ******************************************************************************/
+void le_voltage_beacon_set_sequence(uint32_t value)
+{
+#if LE_VOLTAGE_BEACON_SEAL_ENABLE
+  // Counters retained over EM4 are still in the stored reservation, anything
+  // older could have been used by an earlier reservation
+  if((value < reservedSequence)
+     && ((reservedSequence - value) > LE_VOLTAGE_BEACON_COUNTER_RESERVE)) {
+    return;
+  }
+#endif
+  sequence = value;
+}
@@ -0,0 +1,153 @@
+/***************************************************************************//**
+ * @file le_voltage_beacon.h
+ * @brief Voltage beacon interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_VOLTAGE_BEACON_H_
+#define LE_VOLTAGE_BEACON_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "le_voltage_monitor.h"
+#include "le_voltage_beacon_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Beacon frame types, first byte after the company identifier.
+ *
+ *    - PLAIN:  big-endian uint16 sequence counter and big-endian uint16
+ *              average in millivolts
+ *    - SEALED: big-endian uint32 frame counter, AES-CCM encrypted big-endian
+ *              uint16 average in millivolts and a tag of
+ *              LE_VOLTAGE_BEACON_TAG_SIZE bytes. The company identifier,
+ *              frame type and frame counter are authenticated, the nonce is
+ *              the 8-byte device unique ID, the frame counter and the frame
+ *              type.
+ *    - BATCH:  big-endian uint32 counter of the newest window, number of
+ *              windows, then the average, minimum and maximum of each window,
+ *              newest first, as big-endian uint16 millivolts. Carried by the
+ *              periodic advertising train, the extended advertisements
+ *              leading to it end after the frame type.
+ *    - TIME:   nothing. Ends the extended advertisements of a time
+ *              source, whose periodic advertising train sets the window
+ *              grid of the nodes following it, see le_time_sync.h.
+ ******************************************************************************/
+#define LE_VOLTAGE_BEACON_FRAME_PLAIN   0x01
+#define LE_VOLTAGE_BEACON_FRAME_SEALED  0x02
+#define LE_VOLTAGE_BEACON_FRAME_BATCH   0x03
+#define LE_VOLTAGE_BEACON_FRAME_TIME    0x04
+
+
+/***************************************************************************//**
+ * @brief
+ *    Prepare the sealed frames: load the key and continue the frame counter
+ *    after the last reservation stored in NVM3.
+ *
+ * @details
+ *    The key is read once from LE_VOLTAGE_BEACON_KEY_NVM3_KEY, or taken from
+ *    LE_VOLTAGE_BEACON_DEV_KEY during development. Does nothing with plain
+ *    frames.
+ *
+ * @return
+ *    SL_STATUS_NOT_FOUND if no key is provisioned, or status of the crypto
+ *    accelerator.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start broadcasting non-connectable advertisements on an advertising set.
+ *
+ * @details
+ *    Until the first window completes the beacon carries sequence counter 0
+ *    and an average of 0 mV.
+ *
+ * @param[in] advertising_set
+ *    Advertising set handle.
+ *
+ * @return
+ *    Status of the advertiser commands.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_start(uint8_t advertising_set);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Publish the average of a completed window and advance the sequence
+ *    counter.
+ *
+ * @param[in] advertising_set
+ *    Advertising set handle.
+ *
+ * @param[in] summary
+ *    Window summary.
+ *
+ * @details
+ *    A sealed frame is never published with an unreserved frame counter: if
+ *    the NVM3 reservation fails the beacon keeps the previous frame.
+ *
+ * @return
+ *    Status of the reservation, the crypto accelerator or the advertiser
+ *    command.
+ ******************************************************************************/
+sl_status_t le_voltage_beacon_update(uint8_t advertising_set,
+                                     const le_voltage_monitor_summary_t *summary);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the sequence counter of the latest published window.
+ *
+ * @return
+ *    Sequence counter.
+ ******************************************************************************/
+uint32_t le_voltage_beacon_get_sequence(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Continue the sequence counter of an earlier run, e.g. after a reset.
+ *
+ * @param[in] value
+ *    Sequence counter of the latest window published before, the next one
+ *    gets the following value. Sealed frame counters
+ *    are only taken from the current NVM3 reservation.
+ ******************************************************************************/
+void le_voltage_beacon_set_sequence(uint32_t value);
+
+#endif /* LE_VOLTAGE_BEACON_H_ */
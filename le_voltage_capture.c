@@ -0,0 +1,418 @@
+/***************************************************************************//**
+* @file le_voltage_capture.c
+* @brief Transient capture control and upload definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_voltage_capture.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_simple_timer.h"
+#include "sl_bluetooth.h"
+#include "gatt_db.h"
+#include "le_ota.h"
+#include "le_channel.h"
+
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+
+#if SL_BT_CONFIG_USER_L2CAP_COC_CHANNELS == 0
+#error "LE_VOLTAGE_MONITOR_CAPTURE_ENABLE needs SL_BT_CONFIG_USER_L2CAP_COC_CHANNELS"
+#endif
+
+#if LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU < LE_VOLTAGE_CAPTURE_STATUS_SIZE
+#error "LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU does not hold the capture header"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Samples converted per call into the monitor.
+ ******************************************************************************/
+#define READ_BATCH                          16
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Connection that armed the capture and gets its completion notified
+static uint8_t armConnection = 0;
+
+// Upload channel, cid 0 if none, and its SDU size in whole samples
+static le_channel_t uploadChannel;
+static uint16_t sduLimit = LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU;
+
+// Upload progress: the header is sent first, then the samples from
+// sampleOffset on
+static bool uploading = false;
+static bool headerSent = false;
+static uint32_t sampleOffset = 0;
+static sl_simple_timer_t drainTimer;
+
+// SDU waiting for credits or stack buffers, and the samples it holds
+static uint8_t sdu[LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU];
+static uint16_t sduLen = 0;
+static uint16_t sduSamples = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private static functions.
+ ******************************************************************************/
+static void stop_upload(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the next SDU, the header or as many samples as fit.
+ ******************************************************************************/
+static void fill_sdu(void)
+{
+  uint16_t mv[READ_BATCH];
+  size_t count;
+
+  sduLen = 0;
+  sduSamples = 0;
+
+  if(!headerSent) {
+    le_voltage_capture_build_status(sdu);
+    sduLen = LE_VOLTAGE_CAPTURE_STATUS_SIZE;
+    return;
+  }
+
+  while((sduLen + (2 * READ_BATCH)) <= sduLimit) {
+    count = le_voltage_monitor_capture_read(sampleOffset + sduSamples, mv, READ_BATCH);
+    for(size_t i = 0; i < count; i++) {
+      sdu[sduLen++] = (mv[i] >> 8) & 0x00FF;
+      sdu[sduLen++] = mv[i] & 0x00FF;
+    }
+    sduSamples += count;
+    if(count < READ_BATCH) {
+      return;
+    }
+  }
+
+  // Fill up the rest one sample at a time
+  while((sduLen + 2) <= sduLimit) {
+    if(le_voltage_monitor_capture_read(sampleOffset + sduSamples, mv, 1) == 0) {
+      return;
+    }
+    sdu[sduLen++] = (mv[0] >> 8) & 0x00FF;
+    sdu[sduLen++] = mv[0] & 0x00FF;
+    sduSamples++;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Send SDUs until the credits or the stack buffers run out, close the
+ *    channel and release the capture after the last one.
+ ******************************************************************************/
+static void drain_step(void)
+{
+  sl_status_t sc;
+
+  while(uploading) {
+    if(sduLen == 0) {
+      fill_sdu();
+      if(sduLen == 0) {
+        // All samples sent
+        le_channel_close(&uploadChannel);
+        le_voltage_capture_abort();
+        return;
+      }
+    }
+
+    sc = le_channel_send_sdu(&uploadChannel, sduLen, sdu);
+    if(sc == SL_STATUS_NO_MORE_RESOURCE) {
+      // Retried on more credits or from the drain timer
+      return;
+    }
+    if(sc != SL_STATUS_OK) {
+      stop_upload();
+      return;
+    }
+
+    headerSent = true;
+    sampleOffset += sduSamples;
+    sduLen = 0;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Drain timer callback, called from the main loop.
+ ******************************************************************************/
+static void drain_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  drain_step();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start sending the completed capture on the open channel.
+ ******************************************************************************/
+static void start_upload(void)
+{
+  le_voltage_monitor_capture_t capture;
+
+  if(uploading
+     || (uploadChannel.cid == 0)
+     || (le_voltage_monitor_capture_get_state(&capture) != LE_VOLTAGE_MONITOR_CAPTURE_DONE)) {
+    return;
+  }
+
+  headerSent = false;
+  sampleOffset = 0;
+  sduLen = 0;
+  if(sl_simple_timer_start(&drainTimer,
+                           LE_VOLTAGE_CAPTURE_DRAIN_INTERVAL_MS,
+                           drain_timer_cb,
+                           NULL,
+                           true) != SL_STATUS_OK) {
+    stop_upload();
+    return;
+  }
+  uploading = true;
+  drain_step();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the upload and close its channel, the capture is kept.
+ ******************************************************************************/
+static void stop_upload(void)
+{
+  (void)sl_simple_timer_stop(&drainTimer);
+  le_channel_close(&uploadChannel);
+  uploading = false;
+  sduLen = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Arm the transient capture on behalf of a connection.
+ ******************************************************************************/
+sl_status_t le_voltage_capture_arm(uint8_t connection)
+{
+  sl_status_t sc;
+
+  // Sampling stays suspended for the whole of an OTA update
+  if(le_ota_in_progress()) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  sc = le_voltage_monitor_capture_arm();
+  if(sc == SL_STATUS_OK) {
+    armConnection = connection;
+  }
+  return sc;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the upload and release the capture.
+ ******************************************************************************/
+void le_voltage_capture_abort(void)
+{
+  if(!le_voltage_capture_in_progress()) {
+    return;
+  }
+
+  stop_upload();
+  le_voltage_monitor_capture_release();
+
+  // Window sampling resumes from the main loop
+  sl_bt_external_signal(LE_MONITOR_CAPTURE_SIGNAL);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the capture of a connection.
+ ******************************************************************************/
+void le_voltage_capture_release(uint8_t connection)
+{
+  if(uploading && (uploadChannel.connection == connection)) {
+    // Nothing left to close
+    uploadChannel.cid = 0;
+    le_voltage_capture_abort();
+  } else if(uploadChannel.cid != 0) {
+    // Another central waits for the capture
+    return;
+  } else if(armConnection == connection) {
+    le_voltage_capture_abort();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a capture holds window sampling off.
+ ******************************************************************************/
+bool le_voltage_capture_in_progress(void)
+{
+  le_voltage_monitor_capture_t capture;
+
+  return le_voltage_monitor_capture_get_state(&capture) != LE_VOLTAGE_MONITOR_CAPTURE_IDLE;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of SDUs still to be sent by the running upload.
+ ******************************************************************************/
+uint16_t le_voltage_capture_get_backlog(void)
+{
+  le_voltage_monitor_capture_t capture;
+  uint32_t per_sdu = sduLimit / 2;
+
+  if(!uploading) {
+    return 0;
+  }
+
+  (void)le_voltage_monitor_capture_get_state(&capture);
+  return (uint16_t)(((capture.length - sampleOffset) + per_sdu - 1) / per_sdu) + (headerSent ? 0 : 1);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Capture Control value.
+ ******************************************************************************/
+void le_voltage_capture_build_status(uint8_t *buf)
+{
+  le_voltage_monitor_capture_t capture;
+
+  buf[0] = le_voltage_monitor_capture_get_state(&capture);
+  buf[1] = (capture.sampling_freq_hz >> 8) & 0x00FF;
+  buf[2] = capture.sampling_freq_hz & 0x00FF;
+  buf[3] = (capture.pre_trigger >> 8) & 0x00FF;
+  buf[4] = capture.pre_trigger & 0x00FF;
+  buf[5] = (capture.length >> 8) & 0x00FF;
+  buf[6] = capture.length & 0x00FF;
+  buf[7] = (capture.tick >> 24) & 0x00FF;
+  buf[8] = (capture.tick >> 16) & 0x00FF;
+  buf[9] = (capture.tick >> 8) & 0x00FF;
+  buf[10] = capture.tick & 0x00FF;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Notify a completed capture and start its upload.
+ ******************************************************************************/
+void le_voltage_capture_on_signal(void)
+{
+  le_voltage_monitor_capture_t capture;
+  uint8_t status_buf[LE_VOLTAGE_CAPTURE_STATUS_SIZE];
+
+  if(uploading
+     || (le_voltage_monitor_capture_get_state(&capture) != LE_VOLTAGE_MONITOR_CAPTURE_DONE)) {
+    return;
+  }
+
+  // Fails harmlessly unless the client enabled notifications
+  le_voltage_capture_build_status(status_buf);
+  (void)sl_bt_gatt_server_send_notification(armConnection,
+                                            gattdb_capture_control,
+                                            sizeof(status_buf),
+                                            status_buf);
+  start_upload();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Accept a channel on the capture SPSM.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_open_request(const sl_bt_evt_l2cap_le_channel_open_request_t *request)
+{
+  if(!le_channel_accept(&uploadChannel,
+                        request,
+                        LE_VOLTAGE_CAPTURE_CHANNEL_SPSM,
+                        (uploadChannel.cid == 0) && le_voltage_capture_in_progress(),
+                        LE_VOLTAGE_CAPTURE_CHANNEL_MAX_SDU)) {
+    return;
+  }
+
+  // Whole samples per SDU
+  sduLimit = uploadChannel.max_sdu & ~1;
+
+  // Right away if the capture is complete, otherwise on its signal
+  start_upload();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add the credits granted by the central, and send right away.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_credit(const sl_bt_evt_l2cap_channel_credit_t *credit)
+{
+  if(le_channel_on_credit(&uploadChannel, credit)) {
+    drain_step();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard data received on the upload channel.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_data(const sl_bt_evt_l2cap_channel_data_t *data)
+{
+  le_channel_on_data(&uploadChannel, data);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the upload once its channel closed, the capture is kept.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_closed(const sl_bt_evt_l2cap_channel_closed_t *closed)
+{
+  if(le_channel_on_closed(&uploadChannel, closed)) {
+    stop_upload();
+  }
+}
+#endif
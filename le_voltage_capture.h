@@ -0,0 +1,197 @@
+/***************************************************************************//**
+ * @file le_voltage_capture.h
+ * @brief Transient capture control and upload interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_VOLTAGE_CAPTURE_H_
+#define LE_VOLTAGE_CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+#include "le_voltage_monitor.h"
+#include "le_voltage_capture_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Capture Control value: state, big-endian uint16 sampling frequency in
+ *    Hz, pre-trigger samples and capture length, and the big-endian uint32
+ *    sleeptimer tick count of the trigger.
+ ******************************************************************************/
+#define LE_VOLTAGE_CAPTURE_STATUS_SIZE   11
+
+/***************************************************************************//**
+ * @brief
+ *    Capture Control commands.
+ ******************************************************************************/
+#define LE_VOLTAGE_CAPTURE_CMD_RELEASE   0x00
+#define LE_VOLTAGE_CAPTURE_CMD_ARM       0x01
+#define LE_VOLTAGE_CAPTURE_CMD_TRIGGER   0x02
+
+
+/***************************************************************************//**
+ * @brief
+ *    Arm the transient capture on behalf of a connection.
+ *
+ * @details
+ *    Window sampling is suspended until the capture is released. The
+ *    completed capture is notified on the Capture Control characteristic of
+ *    the arming connection.
+ *
+ * @note
+ *    Only available with LE_VOLTAGE_MONITOR_CAPTURE_ENABLE, as all functions
+ *    of this module.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_STATE while a capture or an OTA update
+ *    is in progress, or the error of le_voltage_monitor_capture_arm().
+ ******************************************************************************/
+sl_status_t le_voltage_capture_arm(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the upload and release the capture, armed or completed.
+ *
+ * @details
+ *    LE_MONITOR_CAPTURE_SIGNAL is raised once window sampling may resume.
+ ******************************************************************************/
+void le_voltage_capture_abort(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the capture armed by or uploaded on a connection, e.g. when the
+ *    connection closed.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_voltage_capture_release(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a capture holds window sampling off.
+ *
+ * @return
+ *    True from arming until the capture is released.
+ ******************************************************************************/
+bool le_voltage_capture_in_progress(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of SDUs still to be sent by the running upload.
+ *
+ * @return
+ *    SDUs left, 0 if no upload is running.
+ ******************************************************************************/
+uint16_t le_voltage_capture_get_backlog(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Build the Capture Control value.
+ *
+ * @param[out] buf
+ *    Buffer of LE_VOLTAGE_CAPTURE_STATUS_SIZE bytes.
+ ******************************************************************************/
+void le_voltage_capture_build_status(uint8_t *buf);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Handle LE_MONITOR_CAPTURE_SIGNAL: notify a completed capture and start
+ *    its upload on an open channel.
+ ******************************************************************************/
+void le_voltage_capture_on_signal(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Accept a channel on the capture SPSM while a capture is in progress.
+ *
+ * @details
+ *    The channel carries the Capture Control value of the completed capture
+ *    as the first SDU, followed by its samples as big-endian uint16 values
+ *    in millivolts, oldest first. It is closed by the peripheral after the
+ *    last sample, and the capture is released. A channel opened while the
+ *    capture is still armed waits for its completion. If the central closes
+ *    the channel the upload stops, the capture is kept and can be uploaded
+ *    again from the start.
+ *
+ * @param[in] request
+ *    Open request event.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_open_request(const sl_bt_evt_l2cap_le_channel_open_request_t *request);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add the credits granted by the central to the upload channel.
+ *
+ * @param[in] credit
+ *    Channel credit event.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_credit(const sl_bt_evt_l2cap_channel_credit_t *credit);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard data received on the upload channel.
+ *
+ * @param[in] data
+ *    Channel data event.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_data(const sl_bt_evt_l2cap_channel_data_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the upload once its channel closed.
+ *
+ * @param[in] closed
+ *    Channel closed event.
+ ******************************************************************************/
+void le_voltage_capture_on_channel_closed(const sl_bt_evt_l2cap_channel_closed_t *closed);
+
+#endif /* LE_VOLTAGE_CAPTURE_H_ */
@@ -0,0 +1,642 @@
+/***************************************************************************//**
+* @file le_voltage_log.c
+* @brief Offline voltage log definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_voltage_log.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nvm3_default.h"
+#include "nvm3_default_config.h"
+#include "sl_simple_timer.h"
+#include "sl_sleeptimer.h"
+#include "sl_bluetooth.h"
+#include "gatt_db.h"
+#include "le_voltage_report.h"
+#include "le_channel.h"
+#include "le_byte_order.h"
+#include "le_energy_stats.h"
+
+/***************************************************************************//**
+ * @brief
+ *    ATT notification header and the largest notification payload (ATT MTU
+ *    of 247 bytes).
+ ******************************************************************************/
+#define ATT_NOTIFICATION_HEADER_SIZE   3
+#define MAX_CHUNK_SIZE                 244
+
+/***************************************************************************//**
+ * @brief
+ *    NVM3 key of a record. Records are kept in a ring of keys, so once the
+ *    log is full a write replaces the oldest record.
+ ******************************************************************************/
+#define LOG_KEY(index) \
+  ((nvm3_ObjectKey_t)(LE_VOLTAGE_LOG_NVM3_KEY_BASE + ((index) % LE_VOLTAGE_LOG_MAX_RECORDS)))
+
+#if LE_VOLTAGE_LOG_WINDOWS_PER_RECORD > LE_VOLTAGE_REPORT_HDR_MAX_COUNT
+#error "LE_VOLTAGE_LOG_WINDOWS_PER_RECORD exceeds the compressed sample count"
+#endif
+
+#if LE_VOLTAGE_LOG_RECORD_MAX_SIZE > NVM3_DEFAULT_MAX_OBJECT_SIZE
+#error "Log record does not fit into an NVM3 object"
+#endif
+
+#if (LE_VOLTAGE_LOG_NVM3_KEY_BASE + LE_VOLTAGE_LOG_MAX_RECORDS - 1) > NVM3_KEY_MAX
+#error "Log keys exceed the NVM3 key range"
+#endif
+
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE && (SL_BT_CONFIG_USER_L2CAP_COC_CHANNELS == 0)
+#error "LE_VOLTAGE_LOG_CHANNEL_ENABLE needs SL_BT_CONFIG_USER_L2CAP_COC_CHANNELS"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Chunk buffer size, channel SDUs may be longer than notifications.
+ ******************************************************************************/
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE && (LE_VOLTAGE_LOG_CHANNEL_MAX_SDU > MAX_CHUNK_SIZE)
+#define CHUNK_BUFFER_SIZE   LE_VOLTAGE_LOG_CHANNEL_MAX_SDU
+#else
+#define CHUNK_BUFFER_SIZE   MAX_CHUNK_SIZE
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Record indices, deleteIndex <= tailIndex <= headIndex. Records before
+// tailIndex are downloaded, the ones from deleteIndex on still have to be
+// deleted from NVM3.
+static uint32_t deleteIndex = 0;
+static uint32_t tailIndex = 0;
+static uint32_t headIndex = 0;
+
+// Window averages not written yet
+static uint16_t stagedWindows = 0;
+static uint16_t staging[LE_VOLTAGE_LOG_WINDOWS_PER_RECORD];
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+static uint32_t stagingTicks[LE_VOLTAGE_LOG_WINDOWS_PER_RECORD];
+#endif
+
+// Closed record waiting for its NVM3 write, empty if pendingLen is 0
+static uint16_t pendingLen = 0;
+static uint8_t pendingRecord[LE_VOLTAGE_LOG_RECORD_MAX_SIZE];
+
+// Download state
+static bool downloading = false;
+static bool endQueued = false;
+static uint8_t downloadConnection;
+static sl_simple_timer_t drainTimer;
+static uint16_t chunkLimit = LE_VOLTAGE_REPORT_DEFAULT_MTU - ATT_NOTIFICATION_HEADER_SIZE;
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE
+// Channel of the download, cid 0 for Log Data notifications
+static le_channel_t downloadChannel;
+#endif
+
+// Record being sent, prefixed by its length byte
+static uint8_t sendRecord[1 + LE_VOLTAGE_LOG_RECORD_MAX_SIZE];
+static uint16_t sendLen = 0;
+static uint16_t sendOffset = 0;
+static uint32_t nextIndex = 0;
+
+// Notification payload or channel SDU, and the tailIndex once it is
+// accepted by the stack
+static uint8_t chunk[CHUNK_BUFFER_SIZE];
+static uint16_t chunkLen = 0;
+static uint32_t chunkTail = 0;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Write the pending record at the head of the log.
+ ******************************************************************************/
+static void write_record(void)
+{
+  Ecode_t ec;
+
+  // The key of the oldest record is about to be reused
+  if((headIndex - deleteIndex) == LE_VOLTAGE_LOG_MAX_RECORDS) {
+    deleteIndex++;
+    if(tailIndex < deleteIndex) {
+      tailIndex = deleteIndex;
+    }
+  }
+
+  le_byte_order_put_u32(pendingRecord, headIndex);
+  ec = nvm3_writeData(nvm3_defaultHandle, LOG_KEY(headIndex), pendingRecord, pendingLen);
+  if(ec == ECODE_NVM3_OK) {
+    headIndex++;
+  }
+
+  // A record that could not be written is dropped
+  pendingLen = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Compress the collected windows into the pending record.
+ ******************************************************************************/
+static void close_record(void)
+{
+  uint16_t encoded;
+  size_t len = LE_VOLTAGE_LOG_RECORD_HEADER_SIZE;
+
+  if(stagedWindows == 0) {
+    return;
+  }
+
+  // Only happens if the main loop did not run for a whole record
+  if(pendingLen != 0) {
+    write_record();
+  }
+
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  {
+    le_voltage_report_clock_t clock = {
+      sl_sleeptimer_get_tick_count64(), sl_sleeptimer_get_timer_frequency()
+    };
+
+    len += le_voltage_report_encode_timestamps(stagingTicks,
+                                               stagedWindows,
+                                               &clock,
+                                               &pendingRecord[len]);
+  }
+#endif
+
+  // The record is sized for the worst case, so all windows are encoded
+  len += le_voltage_report_encode(staging,
+                                  stagedWindows,
+                                  &pendingRecord[len],
+                                  sizeof(pendingRecord) - len,
+                                  &encoded);
+  pendingLen = (uint16_t)len;
+  stagedWindows = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Read the next record to send. Records that cannot be read are skipped.
+ *
+ * @return
+ *    True if a record was loaded.
+ ******************************************************************************/
+static bool load_record(void)
+{
+  if(nextIndex < tailIndex) {
+    nextIndex = tailIndex;
+  }
+
+  while(nextIndex < headIndex) {
+    nvm3_ObjectKey_t key = LOG_KEY(nextIndex);
+    uint32_t type;
+    size_t len;
+
+    if((nvm3_getObjectInfo(nvm3_defaultHandle, key, &type, &len) == ECODE_NVM3_OK)
+       && (len >= LE_VOLTAGE_LOG_RECORD_HEADER_SIZE)
+       && (len <= LE_VOLTAGE_LOG_RECORD_MAX_SIZE)
+       && (nvm3_readData(nvm3_defaultHandle, key, &sendRecord[1], len) == ECODE_NVM3_OK)
+       && (le_byte_order_get_u32(&sendRecord[1]) == nextIndex)) {
+      sendRecord[0] = (uint8_t)len;
+      sendLen = (uint16_t)(len + 1);
+      sendOffset = 0;
+      nextIndex++;
+      return true;
+    }
+    nextIndex++;
+  }
+
+  return false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Fill the notification payload with the record stream. Records may span
+ *    several notifications.
+ ******************************************************************************/
+static void fill_chunk(void)
+{
+  while(!endQueued && (chunkLen < chunkLimit)) {
+    uint16_t n;
+
+    if(sendOffset == sendLen) {
+      if(!load_record()) {
+        // A record still waiting for its write is sent before the end marker
+        if(pendingLen == 0) {
+          chunk[chunkLen++] = 0;
+          chunkTail = nextIndex;
+          endQueued = true;
+        }
+        return;
+      }
+    }
+
+    n = sendLen - sendOffset;
+    if(n > (chunkLimit - chunkLen)) {
+      n = chunkLimit - chunkLen;
+    }
+    memcpy(&chunk[chunkLen], &sendRecord[sendOffset], n);
+    chunkLen += n;
+    sendOffset += n;
+
+    if(sendOffset == sendLen) {
+      chunkTail = nextIndex;
+    }
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Hand the chunk to the stack, as a notification or as a channel SDU.
+ ******************************************************************************/
+static sl_status_t send_chunk(void)
+{
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE
+  if(downloadChannel.cid != 0) {
+    return le_channel_send_sdu(&downloadChannel, chunkLen, chunk);
+  }
+#endif
+
+  return sl_bt_gatt_server_send_notification(downloadConnection,
+                                             gattdb_log_data,
+                                             chunkLen,
+                                             chunk);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Queue notifications until the stack runs out of buffers.
+ ******************************************************************************/
+static void drain_step(void)
+{
+  sl_status_t sc;
+
+  while(downloading) {
+    if(chunkLen == 0) {
+      fill_chunk();
+      if(chunkLen == 0) {
+        return;
+      }
+    }
+
+    sc = send_chunk();
+    if(sc == SL_STATUS_NO_MORE_RESOURCE) {
+      // Retried from the drain timer
+      return;
+    }
+    if(sc != SL_STATUS_OK) {
+      le_voltage_log_stop_download();
+      return;
+    }
+
+#if LE_ENERGY_STATS_ENABLE
+    le_energy_stats_record_notification();
+#endif
+    chunkLen = 0;
+    if(chunkTail > tailIndex) {
+      tailIndex = chunkTail;
+    }
+    if(endQueued) {
+      le_voltage_log_stop_download();
+    }
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Drain timer callback, called from the main loop.
+ ******************************************************************************/
+static void drain_timer_cb(sl_simple_timer_t *timer, void *data)
+{
+  (void)timer;
+  (void)data;
+
+  drain_step();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Recover the log records left in NVM3.
+ ******************************************************************************/
+void le_voltage_log_init(void)
+{
+  bool found = false;
+  uint32_t lowest = 0;
+  uint32_t highest = 0;
+
+  for(uint32_t slot = 0; slot < LE_VOLTAGE_LOG_MAX_RECORDS; slot++) {
+    uint8_t header[LE_VOLTAGE_LOG_RECORD_HEADER_SIZE];
+    uint32_t index;
+
+    if(nvm3_readPartialData(nvm3_defaultHandle,
+                            LOG_KEY(slot),
+                            header,
+                            0,
+                            sizeof(header)) != ECODE_NVM3_OK) {
+      continue;
+    }
+
+    index = le_byte_order_get_u32(header);
+    if(LOG_KEY(index) != LOG_KEY(slot)) {
+      continue;
+    }
+    if(!found || (index < lowest)) {
+      lowest = index;
+    }
+    if(!found || (index > highest)) {
+      highest = index;
+    }
+    found = true;
+  }
+
+  if(found) {
+    headIndex = highest + 1;
+    if((headIndex - lowest) > LE_VOLTAGE_LOG_MAX_RECORDS) {
+      lowest = headIndex - LE_VOLTAGE_LOG_MAX_RECORDS;
+    }
+    tailIndex = lowest;
+    deleteIndex = lowest;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append the average of a completed window to the log.
+ ******************************************************************************/
+void le_voltage_log_push(const le_voltage_monitor_summary_t *summary)
+{
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  stagingTicks[stagedWindows] = summary->tick;
+#endif
+  staging[stagedWindows++] = summary->avg_mv;
+
+  if(stagedWindows == LE_VOLTAGE_LOG_WINDOWS_PER_RECORD) {
+    close_record();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Perform at most one pending NVM3 operation.
+ ******************************************************************************/
+void le_voltage_log_process_action(void)
+{
+  if(pendingLen != 0) {
+    write_record();
+  } else if(deleteIndex < tailIndex) {
+    (void)nvm3_deleteObject(nvm3_defaultHandle, LOG_KEY(deleteIndex));
+    deleteIndex++;
+  } else if(nvm3_repackNeeded(nvm3_defaultHandle)) {
+    // Repack a bit at a time here rather than as part of a record write
+    (void)nvm3_repack(nvm3_defaultHandle);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the ATT MTU of the connection used for downloading.
+ ******************************************************************************/
+void le_voltage_log_set_mtu(uint16_t mtu)
+{
+  chunkLimit = MAX_CHUNK_SIZE;
+  if((mtu > ATT_NOTIFICATION_HEADER_SIZE)
+     && ((mtu - ATT_NOTIFICATION_HEADER_SIZE) < chunkLimit)) {
+    chunkLimit = mtu - ATT_NOTIFICATION_HEADER_SIZE;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start sending the record stream from the tail.
+ ******************************************************************************/
+static sl_status_t start_download(uint8_t connection)
+{
+  sl_status_t sc;
+
+  if(downloading) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  // Written by the main loop before the first drain timeout
+  close_record();
+
+  downloadConnection = connection;
+  nextIndex = tailIndex;
+  chunkTail = tailIndex;
+  chunkLen = 0;
+  sendLen = 0;
+  sendOffset = 0;
+  endQueued = false;
+
+  sc = sl_simple_timer_start(&drainTimer,
+                             LE_VOLTAGE_LOG_DRAIN_INTERVAL_MS,
+                             drain_timer_cb,
+                             NULL,
+                             true);
+  if(sc == SL_STATUS_OK) {
+    downloading = true;
+  }
+  return sc;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start notifying the log records on the Log Data characteristic.
+ ******************************************************************************/
+sl_status_t le_voltage_log_start_download(uint8_t connection)
+{
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE
+  if(!downloading) {
+    downloadChannel.cid = 0;
+  }
+#endif
+  return start_download(connection);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download.
+ ******************************************************************************/
+void le_voltage_log_stop_download(void)
+{
+  if(!downloading) {
+    return;
+  }
+
+  // A partly sent record stays at the tail and is sent again next time
+  (void)sl_simple_timer_stop(&drainTimer);
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE
+  le_channel_close(&downloadChannel);
+#endif
+  downloading = false;
+  chunkLen = 0;
+  sendLen = 0;
+  sendOffset = 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download if it runs on a connection, e.g. when the connection
+ *    closed or its client unsubscribed.
+ ******************************************************************************/
+void le_voltage_log_release(uint8_t connection)
+{
+  if(downloading && (downloadConnection == connection)) {
+    le_voltage_log_stop_download();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard all log records and the windows collected so far.
+ ******************************************************************************/
+void le_voltage_log_erase(void)
+{
+  le_voltage_log_stop_download();
+
+  stagedWindows = 0;
+  pendingLen = 0;
+
+  // The records are deleted from NVM3 one by one by the main loop
+  tailIndex = headIndex;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the fill level of the log.
+ ******************************************************************************/
+void le_voltage_log_get_status(uint16_t *records, uint16_t *windows)
+{
+  *records = (uint16_t)(headIndex - tailIndex);
+  if(pendingLen != 0) {
+    (*records)++;
+  }
+  *windows = stagedWindows;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of records still to be sent by the running download.
+ ******************************************************************************/
+uint16_t le_voltage_log_get_backlog(void)
+{
+  uint16_t records;
+
+  if(!downloading) {
+    return 0;
+  }
+
+  records = (uint16_t)(headIndex - tailIndex);
+  if(pendingLen != 0) {
+    records++;
+  }
+  return records;
+}
+
+
+#if LE_VOLTAGE_LOG_CHANNEL_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Accept a channel on the log SPSM, and start the download on it.
+ ******************************************************************************/
+void le_voltage_log_on_channel_open_request(const sl_bt_evt_l2cap_le_channel_open_request_t *request)
+{
+  if(!le_channel_accept(&downloadChannel,
+                        request,
+                        LE_VOLTAGE_LOG_CHANNEL_SPSM,
+                        !downloading,
+                        CHUNK_BUFFER_SIZE)) {
+    return;
+  }
+
+  chunkLimit = downloadChannel.max_sdu;
+  if(start_download(request->connection) != SL_STATUS_OK) {
+    le_channel_close(&downloadChannel);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add the credits granted by the central, and send right away.
+ ******************************************************************************/
+void le_voltage_log_on_channel_credit(const sl_bt_evt_l2cap_channel_credit_t *credit)
+{
+  if(downloading && le_channel_on_credit(&downloadChannel, credit)) {
+    drain_step();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard data received on the download channel.
+ ******************************************************************************/
+void le_voltage_log_on_channel_data(const sl_bt_evt_l2cap_channel_data_t *data)
+{
+  if(downloading) {
+    le_channel_on_data(&downloadChannel, data);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download once its channel closed.
+ ******************************************************************************/
+void le_voltage_log_on_channel_closed(const sl_bt_evt_l2cap_channel_closed_t *closed)
+{
+  if(downloading && le_channel_on_closed(&downloadChannel, closed)) {
+    le_voltage_log_stop_download();
+  }
+}
+#endif
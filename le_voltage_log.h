@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @file le_voltage_log.h
+ * @brief Offline voltage log interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_VOLTAGE_LOG_H_
+#define LE_VOLTAGE_LOG_H_
+
+#include <stdint.h>
+#include "sl_status.h"
+#include "sl_bluetooth.h"
+#include "le_voltage_monitor.h"
+#include "le_voltage_log_config.h"
+#include "le_voltage_report.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Log record header: big-endian uint32 record index. The timestamp block
+ *    of le_voltage_report_encode_timestamps(), if enabled, and the compressed
+ *    payload of le_voltage_report_encode() follow.
+ ******************************************************************************/
+#define LE_VOLTAGE_LOG_RECORD_HEADER_SIZE   4
+
+/***************************************************************************//**
+ * @brief
+ *    Largest log record in bytes, the payload is compressed in the worst case
+ *    as absolute 16-bit values.
+ ******************************************************************************/
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+#define LE_VOLTAGE_LOG_RECORD_MAX_SIZE \
+  (LE_VOLTAGE_LOG_RECORD_HEADER_SIZE                                    \
+   + LE_VOLTAGE_REPORT_TIMESTAMP_MAX_SIZE(LE_VOLTAGE_LOG_WINDOWS_PER_RECORD) \
+   + 1 + (2 * LE_VOLTAGE_LOG_WINDOWS_PER_RECORD))
+#else
+#define LE_VOLTAGE_LOG_RECORD_MAX_SIZE \
+  (LE_VOLTAGE_LOG_RECORD_HEADER_SIZE + 1 + (2 * LE_VOLTAGE_LOG_WINDOWS_PER_RECORD))
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Log Control commands.
+ ******************************************************************************/
+#define LE_VOLTAGE_LOG_CMD_STOP_DOWNLOAD    0x00
+#define LE_VOLTAGE_LOG_CMD_START_DOWNLOAD   0x01
+#define LE_VOLTAGE_LOG_CMD_ERASE            0x02
+
+
+/***************************************************************************//**
+ * @brief
+ *    Recover the log records left in NVM3.
+ *
+ * @note
+ *    NVM3 must have been initialized.
+ ******************************************************************************/
+void le_voltage_log_init(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append the average of a completed window to the log.
+ *
+ * @details
+ *    Averages are collected in RAM. Once a record is complete its NVM3 write
+ *    is deferred to le_voltage_log_process_action().
+ *
+ * @param[in] summary
+ *    Window summary.
+ ******************************************************************************/
+void le_voltage_log_push(const le_voltage_monitor_summary_t *summary);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Perform at most one pending NVM3 operation: a record write, the deletion
+ *    of a downloaded record, or a step of the NVM3 repack.
+ *
+ * @note
+ *    To be called from the application main loop.
+ ******************************************************************************/
+void le_voltage_log_process_action(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the ATT MTU of the connection used for downloading.
+ *
+ * @param[in] mtu
+ *    Negotiated ATT MTU.
+ ******************************************************************************/
+void le_voltage_log_set_mtu(uint16_t mtu);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Start notifying the log records on the Log Data characteristic.
+ *
+ * @details
+ *    The windows collected so far are closed into a record first. Records
+ *    are deleted once they are sent, and the download ends with a zero
+ *    length byte when the log is empty.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ *
+ * @return
+ *    SL_STATUS_OK, or SL_STATUS_INVALID_STATE if already downloading.
+ ******************************************************************************/
+sl_status_t le_voltage_log_start_download(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download. Records not completely sent are kept.
+ ******************************************************************************/
+void le_voltage_log_stop_download(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download if it runs on a connection, e.g. when the connection
+ *    closed or its client unsubscribed.
+ *
+ * @param[in] connection
+ *    Connection handle.
+ ******************************************************************************/
+void le_voltage_log_release(uint8_t connection);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard all log records and the windows collected so far.
+ ******************************************************************************/
+void le_voltage_log_erase(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the fill level of the log.
+ *
+ * @param[out] records
+ *    Records stored in NVM3 and not downloaded yet.
+ *
+ * @param[out] windows
+ *    Windows collected in RAM and not written yet.
+ ******************************************************************************/
+void le_voltage_log_get_status(uint16_t *records, uint16_t *windows);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of records still to be sent by the running download.
+ *
+ * @return
+ *    Records left, 0 if not downloading.
+ ******************************************************************************/
+uint16_t le_voltage_log_get_backlog(void);
+
+/***************************************************************************//**
+ * @brief
+ *    Answer a request to open an L2CAP channel. A channel on
+ *    LE_VOLTAGE_LOG_CHANNEL_SPSM is accepted unless a download runs, and
+ *    carries the record stream of the Log Data characteristic as SDUs.
+ *
+ * @note
+ *    The channel functions are only available with
+ *    LE_VOLTAGE_LOG_CHANNEL_ENABLE. The download ends by closing the channel
+ *    after the end of the stream.
+ *
+ * @param[in] request
+ *    Channel open request event data.
+ ******************************************************************************/
+void le_voltage_log_on_channel_open_request(const sl_bt_evt_l2cap_le_channel_open_request_t *request);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Add credits granted by the central to the download channel.
+ *
+ * @param[in] credit
+ *    Channel credit event data.
+ ******************************************************************************/
+void le_voltage_log_on_channel_credit(const sl_bt_evt_l2cap_channel_credit_t *credit);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard data received on the download channel.
+ *
+ * @param[in] data
+ *    Channel data event data.
+ ******************************************************************************/
+void le_voltage_log_on_channel_data(const sl_bt_evt_l2cap_channel_data_t *data);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the download once its channel closed.
+ *
+ * @param[in] closed
+ *    Channel closed event data.
+ ******************************************************************************/
+void le_voltage_log_on_channel_closed(const sl_bt_evt_l2cap_channel_closed_t *closed);
+
+#endif /* LE_VOLTAGE_LOG_H_ */
@@ -36,9 +36,11 @@
 ******************************************************************************/
 
 #include "le_voltage_monitor.h"
+#include "le_voltage_monitor_variant_config.h"
 #include "sl_bluetooth.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include "em_core.h"
 #include "em_cmu.h"
 #include "em_gpio.h"
 #include "em_letimer.h"
@@ -46,71 +48,647 @@
 #include "em_iadc.h"
 #include "em_prs.h"
 #include "sl_sleeptimer.h"
+#include "nvm3_default.h"
+#include "sl_power_manager.h"
+#include "le_window_math.h"
+#include "le_trace.h"
+#include "le_cycle_counter.h"
 
 
 /***************************************************************************//**
  * @brief
  *    IADC Configuration Definitions.
  ******************************************************************************/
-// Set CLK_ADC to 10kHz (this corresponds to a sample rate of 1ksps)
-#define CLK_SRC_ADC_FREQ          5000000  // CLK_SRC_ADC; largest division is by 4
-#define CLK_ADC_FREQ              1000000  // CLK_ADC; IADC_SCHEDx PRESCALE has 10 valid bits
-
-// When changing GPIO port/pins above, make sure to change xBUSALLOC macro's
-// accordingly.
-#define IADC_INPUT_BUS            ABUSALLOC
-#define IADC_INPUT_BUSALLOC       GPIO_ABUSALLOC_AEVEN0_ADC0
-
-// IADC input GPIO port/pin configration
-#define IADC_INPUT_POS            iadcPosInputPortCPin2
+// Reference of configuration 0 and its voltage. AVDD is 3.3 V on the board.
+#define IADC_REFERENCE            iadcCfgReferenceVddx
+#define IADC_REFERENCE_MV         3300
+
+// Reference of configuration 1, used for the supply inputs
+#define IADC_SUPPLY_REFERENCE     iadcCfgReferenceInt1V2
+#define IADC_SUPPLY_REFERENCE_MV  1210
+
+// Oversampled results carry 16 bits, plain 2x OSR results carry 12 bits
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+#define IADC_ALIGNMENT            iadcAlignRight16
+#define IADC_RESOLUTION_BITS      16
+#else
+#define IADC_ALIGNMENT            iadcAlignRight12
+#define IADC_RESOLUTION_BITS      12
+#endif
+#define IADC_FULL_SCALE           ((1UL << IADC_RESOLUTION_BITS) - 1)
+
+// Run CLK_ADC at its normal mode maximum, a 2x OSR conversion takes 1 us. The
+// converting current hardly depends on CLK_ADC, so the shortest conversion
+// spends the least charge at every sampling rate and keeps the gated sensor
+// on for the least time. Only the warmup mode follows the rate.
+#define CLK_SRC_ADC_FREQ          20000000  // CLK_SRC_ADC; FSRCO undivided, at most 40 MHz
+#define CLK_ADC_FREQ              10000000  // CLK_ADC; at most 10 MHz in normal mode
+
+// All inputs are single ended, the channels are described by the table of
+// the product variant, see le_voltage_monitor_variant_config.h
 #define IADC_INPUT_NEG            iadcNegInputGnd
 
+// The AVDD and DVDD inputs are divided by 4 inside the IADC
+#define IADC_SUPPLY_DIVIDER       4
+
+// Number of entries of the channel table
+#define COUNT_CHANNEL(index, pos_input, bus, bus_alloc, config_id, divider)  + 1
+#define MAX_SCAN_CHANNELS         (0 LE_VOLTAGE_MONITOR_CHANNELS(COUNT_CHANNEL))
+
+#if (LE_VOLTAGE_MONITOR_NUM_CHANNELS < 1) \
+  || (LE_VOLTAGE_MONITOR_NUM_CHANNELS > MAX_SCAN_CHANNELS)
+#error "LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS out of range"
+#endif
+
+// Scan mode converts the whole channel table per trigger, the single mode
+// only the sensor input
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+#define IADC_FIFO_DATA            SCANFIFODATA
+#define IADC_CMD_START            iadcCmdStartScan
+#define IADC_CMD_STOP             iadcCmdStopScan
+#define IADC_PRS_CONSUMER         prsConsumerIADC0_SCANTRIGGER
+#define IADC_LDMA_SIGNAL          ldmaPeripheralSignal_IADC0_IADC_SCAN
+#else
+#define IADC_FIFO_DATA            SINGLEFIFODATA
+#define IADC_CMD_START            iadcCmdStartSingle
+#define IADC_CMD_STOP             iadcCmdStopSingle
+#define IADC_PRS_CONSUMER         prsConsumerIADC0_SINGLETRIGGER
+#define IADC_LDMA_SIGNAL          ldmaPeripheralSignal_IADC0_IADC_SINGLE
+#endif
+
 /***************************************************************************//**
  * @brief
  *    GPIO
  ******************************************************************************/
 
-#define SENSOR_POWER_PORT gpioPortC
-#define SENSOR_POWER_PIN  1
+#define SENSOR_POWER_PORT LE_VOLTAGE_MONITOR_SENSOR_POWER_PORT
+#define SENSOR_POWER_PIN  LE_VOLTAGE_MONITOR_SENSOR_POWER_PIN
 
 /***************************************************************************//**
  * @brief
  *    PRS Configuration Definitions.
  ******************************************************************************/
-// Note CH7 is used by the BLE stack.
-#define PRS_CHANNEL_LETIMER_IADC  1
-#define PRS_CHANNEL_LETIMER_GPIO  2
+#define PRS_CHANNEL_LETIMER_IADC  LE_VOLTAGE_MONITOR_PRS_CHANNEL_IADC
+#define PRS_CHANNEL_LETIMER_GPIO  LE_VOLTAGE_MONITOR_PRS_CHANNEL_GPIO
+
+// Note CH7 is used by the BLE stack
+#if (PRS_CHANNEL_LETIMER_IADC > 11) || (PRS_CHANNEL_LETIMER_IADC == 7) \
+  || (PRS_CHANNEL_LETIMER_GPIO > 11) || (PRS_CHANNEL_LETIMER_GPIO == 7) \
+  || (PRS_CHANNEL_LETIMER_IADC == PRS_CHANNEL_LETIMER_GPIO)
+#error "LE_VOLTAGE_MONITOR_PRS_CHANNEL_IADC or _GPIO not available"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Sensor Power Gating Definitions.
+ ******************************************************************************/
+// In gated mode both LETIMER0 outputs run in PWM mode: while the counter
+// runs down from TOP they go active on their compare match and back to idle
+// on underflow. Output 1 powers the sensor COMP1 ticks ahead of the
+// underflow, the rising edge of output 0 triggers the IADC COMP0 ticks ahead
+// of it. The sensor settles for COMP1 - COMP0 ticks and stays on for COMP0
+// ticks, long enough for the conversion.
+#define SENSOR_GATED \
+  (LE_VOLTAGE_MONITOR_SENSOR_POWER == LE_VOLTAGE_MONITOR_SENSOR_POWER_GATED)
+
+// IADC warmup on every trigger in normal warmup mode. The sensor hold covers
+// this longest warmup whatever the mode.
+#define IADC_WARMUP_US            5
+
+// IADC warmup on every trigger when kept in standby
+#define IADC_STANDBY_WARMUP_US    1
+
+#if (LE_VOLTAGE_MONITOR_WARMUP_POLICY > LE_VOLTAGE_MONITOR_WARMUP_AUTO)
+#error "LE_VOLTAGE_MONITOR_WARMUP_POLICY out of range"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Calibration Definitions.
+ ******************************************************************************/
+// Stored calibration: tag, AVDD in millivolts and the offset code, both
+// big-endian
+#define CAL_SIZE                  5
+
+// A calibration only holds for the resolution and the gain it was taken with
+#define CAL_TAG \
+  ((uint8_t)((IADC_RESOLUTION_BITS << 4) | LE_VOLTAGE_MONITOR_CFG0_ANALOG_GAIN))
+
+// Plausible AVDD, the supply range of the EFR32BG22
+#define CAL_MIN_REFERENCE_MV      1710
+#define CAL_MAX_REFERENCE_MV      3800
+
+// Largest plausible offset code
+#define CAL_MAX_OFFSET            (IADC_FULL_SCALE / 64)
+
+/***************************************************************************//**
+ * @brief
+ *    Alarm Definitions.
+ ******************************************************************************/
+// The window comparator works on the left-justified 16-bit result,
+// independent of the FIFO alignment
+#define IADC_COMPARE_FULL_SCALE   0xFFFF
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+#error "The alarm mode watches the single sensor input"
+#endif
 
+// Without window interrupts a single shot window would never be restarted
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_SINGLE_SHOT)
+#error "The alarm mode needs a continuous acquisition mode"
+#endif
+
+#if ((LE_VOLTAGE_MONITOR_ALARM_LOW_MV + LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV) \
+     >= (LE_VOLTAGE_MONITOR_ALARM_HIGH_MV - LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV))
+#error "Alarm band narrower than twice the hysteresis"
+#endif
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Transient Capture Definitions.
+ ******************************************************************************/
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+#define CAPTURE_COMPARATOR \
+  (LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER == LE_VOLTAGE_MONITOR_CAPTURE_TRIGGER_COMPARATOR)
+
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+#error "The transient capture samples the single sensor input"
+#endif
+
+#if CAPTURE_COMPARATOR && LE_VOLTAGE_MONITOR_ALARM_ENABLE
+#error "The alarm mode and the capture trigger both need the window comparator"
+#endif
+
+// The ring is filled by a circular chain of descriptors, each one
+// interrupts once its block is full
+#define CAPTURE_BLOCKS            4
+#define CAPTURE_BLOCK_SIZE        (LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES / CAPTURE_BLOCKS)
+#define CAPTURE_LENGTH \
+  (LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER + LE_VOLTAGE_MONITOR_CAPTURE_POST_TRIGGER)
+
+#if ((LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES % CAPTURE_BLOCKS) != 0) \
+  || (CAPTURE_BLOCK_SIZE > 2048)
+#error "Capture ring does not split into four LDMA transfers"
+#endif
+
+// The ring is frozen at the end of the block holding the last post-trigger
+// sample, by then the oldest pre-trigger sample must still be there
+#if ((CAPTURE_LENGTH + CAPTURE_BLOCK_SIZE) > LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES)
+#error "Pre- and post-trigger samples exceed three quarters of the capture ring"
+#endif
+
+#if !CAPTURE_COMPARATOR
+#if (LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN & 1)
+#define CAPTURE_GPIO_IRQn         GPIO_ODD_IRQn
+#define CAPTURE_GPIO_IRQHandler   GPIO_ODD_IRQHandler
+#else
+#define CAPTURE_GPIO_IRQn         GPIO_EVEN_IRQn
+#define CAPTURE_GPIO_IRQHandler   GPIO_EVEN_IRQHandler
+#endif
+#define CAPTURE_GPIO_MASK         (1UL << LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN)
+#endif
+#else
+#define CAPTURE_COMPARATOR        0
+#endif
 
 
 /***************************************************************************//**
  * @brief
  *    LDMA Configuration Definitions.
  ******************************************************************************/
-#define LDMA_CHANNEL              0
+#define LDMA_CHANNEL              LE_VOLTAGE_MONITOR_LDMA_CHANNEL
+
+#if (LDMA_CHANNEL > 7)
+#error "LE_VOLTAGE_MONITOR_LDMA_CHANNEL out of range"
+#endif
+
+// Continuous mode cycles through a ring of buffers. The LDMA refills the
+// buffer of a window once NUM_OF_BUFFERS - 1 later windows have completed, in
+// the other modes as soon as the next one has.
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_PING_PONG)
+#if (LE_VOLTAGE_MONITOR_NUM_BUFFERS < 2) || (LE_VOLTAGE_MONITOR_NUM_BUFFERS > 4)
+#error "LE_VOLTAGE_MONITOR_NUM_BUFFERS out of range"
+#endif
+#define NUM_OF_BUFFERS            LE_VOLTAGE_MONITOR_NUM_BUFFERS
+#define INTACT_WINDOWS            (NUM_OF_BUFFERS - 1)
+#else
+#define NUM_OF_BUFFERS            1
+#define INTACT_WINDOWS            1
+#endif
+
+// In hardware averaging mode the IADC delivers one averaged result per window,
+// otherwise every buffer is sized for the largest configurable window.
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+#define BUFFER_CAPACITY           1
+#else
+#define BUFFER_CAPACITY           LE_VOLTAGE_MONITOR_MAX_SAMPLES
+#endif
+
+// The scan results of one trigger are stored next to each other, so every
+// buffer interleaves the channels sample by sample
+#define BUFFER_SIZE               (BUFFER_CAPACITY * LE_VOLTAGE_MONITOR_NUM_CHANNELS)
+
+// The LDMA stores every result as a halfword. Buffers are padded to an even
+// number of samples so each one starts word aligned for the packed reduction.
+#define BUFFER_STRIDE             ((BUFFER_SIZE + 1) & ~1)
+
+// Packed reduction of two samples per 32-bit load with the DSP instructions.
+// The dual multiply-accumulates are signed, the codes have to stay below
+// 0x8000, and the samples of a single channel have to be adjacent.
+#if LE_WINDOW_MATH_PACKED_AVAILABLE \
+  && (IADC_RESOLUTION_BITS < 16) && (LE_VOLTAGE_MONITOR_NUM_CHANNELS == 1)
+#define PACKED_REDUCTION          1
+#else
+#define PACKED_REDUCTION          0
+#endif
+
+// XFERCNT is an 11-bit field
+#if (BUFFER_SIZE > 2048)
+#error "LE_VOLTAGE_MONITOR_MAX_SAMPLES exceeds the LDMA transfer count"
+#endif
+
+#if (NUM_OF_SAMPLES > LE_VOLTAGE_MONITOR_MAX_SAMPLES) \
+  || (SAMPLING_FREQ_HZ > LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ)
+#error "Default window exceeds the configured limits"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Synthetic Source Definitions.
+ ******************************************************************************/
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE) \
+  || LE_VOLTAGE_MONITOR_ALARM_ENABLE
+#error "The synthetic source fills the sample buffers of the windows"
+#endif
+#if (LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD < 4) || (LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD > 1024) \
+  || ((LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD % 2) != 0)
+#error "LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD out of range"
+#endif
+#if (LE_VOLTAGE_MONITOR_SYNTHETIC_LOW_MV > LE_VOLTAGE_MONITOR_SYNTHETIC_HIGH_MV)
+#error "LE_VOLTAGE_MONITOR_SYNTHETIC_LOW_MV above the high level"
+#endif
+
+// A window starts anywhere in the first period and reads at most a buffer
+#define SYNTHETIC_TABLE_SIZE      (LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD + BUFFER_STRIDE)
+
+// LETIMER0 paces the copies in place of the conversions
+#define WINDOW_LDMA_SIGNAL        ldmaPeripheralSignal_LETIMER0_UFOF
+#else
+#define WINDOW_LDMA_SIGNAL        IADC_LDMA_SIGNAL
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    LETIMER Configuration Definitions.
+ ******************************************************************************/
+// Largest value of the 24-bit LETIMER0 TOP register
+#define LETIMER_TOP_MAX           0xFFFFFF
+
+// LETIMER0 ticks a counter write may take to synchronize, see
+// le_voltage_monitor_trim()
+#define TRIM_SYNC_TICKS           3
+
+/***************************************************************************//**
+ * @brief
+ *    Conversion Definitions.
+ ******************************************************************************/
+// The raw code sum of one channel is turned directly into its average in
+// millivolts by a fixed-point factor, RANGE_MV / (FULL_SCALE * SAMPLES).
+// Replaces the per-sample multiply/divide. It is recomputed whenever the
+// window size changes.
+
+// The raw sum of a full buffer is accumulated in 32 bits
+#if ((BUFFER_CAPACITY * IADC_FULL_SCALE) > 0xFFFFFFFFUL)
+#error "Sampling buffer too large for a 32-bit raw code sum"
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Filter Definitions.
+ ******************************************************************************/
+#define FILTER_FIR  (LE_VOLTAGE_MONITOR_FILTER == LE_VOLTAGE_MONITOR_FILTER_FIR)
+
+// Fraction bits kept by the FIR outputs
+#define FIR_FRACTION_BITS         4
+
+// Parabolic (Welch) kernel, tap k of T weighs (k + 1) * (T - k). The taps are
+// integers, symmetric, and their sum is T * (T + 1) * (T + 2) / 6.
+#define FIR_MAX_TAPS              32
+#define FIR_TAP(k)                (((k) < LE_VOLTAGE_MONITOR_FIR_TAPS) \
+                                   ? (((k) + 1) * (LE_VOLTAGE_MONITOR_FIR_TAPS - (k))) : 0)
+#define FIR_GAIN                  ((LE_VOLTAGE_MONITOR_FIR_TAPS * (LE_VOLTAGE_MONITOR_FIR_TAPS + 1) \
+                                    * (LE_VOLTAGE_MONITOR_FIR_TAPS + 2)) / 6)
+
+#if FILTER_FIR
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+#error "The FIR filter needs the samples of the window, not a hardware average"
+#endif
+#if (LE_VOLTAGE_MONITOR_FIR_TAPS < 2) || (LE_VOLTAGE_MONITOR_FIR_TAPS > FIR_MAX_TAPS)
+#error "LE_VOLTAGE_MONITOR_FIR_TAPS out of range"
+#endif
+#if (LE_VOLTAGE_MONITOR_FIR_DECIMATION < 1) || (LE_VOLTAGE_MONITOR_FIR_DECIMATION > 32)
+#error "LE_VOLTAGE_MONITOR_FIR_DECIMATION out of range"
+#endif
+// The outputs are written back as halfwords
+#if (((IADC_FULL_SCALE << FIR_FRACTION_BITS) > 0xFFFF) \
+  || ((FIR_GAIN * IADC_FULL_SCALE) > (0xFFFFFFFFUL >> FIR_FRACTION_BITS)))
+#error "FIR outputs overflow"
+#endif
+#endif
+
+#if (LE_VOLTAGE_MONITOR_IIR_SHIFT > 8)
+#error "LE_VOLTAGE_MONITOR_IIR_SHIFT out of range"
+#endif
 
 
 /***************************************************************************//**
  * @brief
  *    Private general globals.
  ******************************************************************************/
-static uint32_t samplingBuffer[NUM_OF_SAMPLES];
+static volatile bool startedSampling = false;
+
+// The LETIMER0, IADC0 and LDMA clocks only run while sampling. Their
+// registers keep the configuration written once by the first bring-up.
+static bool chainConfigured = false;
+static bool chainClocked = false;
+
+// Active window configuration
+static uint16_t samplingFreqHz = SAMPLING_FREQ_HZ;
+static uint16_t numOfSamples = NUM_OF_SAMPLES;
+static uint16_t samplesPerBuffer;
+static uint32_t mvScaleFactor[LE_VOLTAGE_MONITOR_NUM_CHANNELS];
+
+// Same factor for a single raw code of the sensor input, used for the window
+// extremes
+static uint32_t mvCodeScaleFactor;
+
+// Full scale voltage of the sensor input, used for the RMS and deviation
+static uint32_t sensorRangeMv;
+
+// Configuration requested while sampling, applied between windows
+static bool configPending = false;
+static uint16_t pendingFreqHz;
+static uint16_t pendingNumOfSamples;
+
+// LETIMER0 ticks the sensor is powered ahead of every underflow
+static uint32_t gateOnTicks = 0;
+
+// Calibration of the sensor inputs: the AVDD reference measured against the
+// internal one and the code of a grounded input. Nominal until calibrated.
+static uint16_t calReferenceMv = IADC_REFERENCE_MV;
+static uint16_t calOffset = 0;
+
+// Buffer currently written by the LDMA
+static volatile uint8_t fillingBuffer = 0;
+
+// Buffer being reduced by the main loop
+static uint8_t readyBuffer = 0;
+
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+// Waveform sample following the last completed window, where sampling
+// resumes. Back at the start once the table is generated again.
+static uint32_t syntheticResume = 0;
+#endif
+
+// Summary of the most recently delivered window
+static le_voltage_monitor_summary_t readySummary;
+
+// Sequence number of the last window completed by the LDMA, and of the last
+// one delivered to the application
+static volatile uint32_t completedSequence = 0;
+static uint32_t deliveredSequence = 0;
+
+// Running estimate of the window averages
+static le_window_iir_t runningEstimate = { 0, false };
+
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+// DWT cycle counts of the window reduction
+static uint32_t reduceCycles = 0;
+static uint32_t reduceCyclesMax = 0;
+#endif
+
+#if FILTER_FIR
+static const uint16_t firTaps[FIR_MAX_TAPS] = {
+  FIR_TAP(0), FIR_TAP(1), FIR_TAP(2), FIR_TAP(3),
+  FIR_TAP(4), FIR_TAP(5), FIR_TAP(6), FIR_TAP(7),
+  FIR_TAP(8), FIR_TAP(9), FIR_TAP(10), FIR_TAP(11),
+  FIR_TAP(12), FIR_TAP(13), FIR_TAP(14), FIR_TAP(15),
+  FIR_TAP(16), FIR_TAP(17), FIR_TAP(18), FIR_TAP(19),
+  FIR_TAP(20), FIR_TAP(21), FIR_TAP(22), FIR_TAP(23),
+  FIR_TAP(24), FIR_TAP(25), FIR_TAP(26), FIR_TAP(27),
+  FIR_TAP(28), FIR_TAP(29), FIR_TAP(30), FIR_TAP(31),
+};
+#endif
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+// Alarm state and the conversion that changed it
+static volatile uint8_t alarmState = LE_VOLTAGE_MONITOR_ALARM_NONE;
+static volatile uint16_t alarmMv = 0;
+#endif
+
+// Transient capture state, the blocks the LDMA has completed since arming
+// and the number of samples in the ring when the trigger was accepted
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+static volatile uint8_t captureState = LE_VOLTAGE_MONITOR_CAPTURE_IDLE;
+static volatile uint32_t captureBlocks = 0;
+static volatile uint32_t captureTriggerCount = 0;
+static volatile uint32_t captureTriggerTick = 0;
+#endif
+
+
+
+/***************************************************************************//**
+ * @brief
+ *    Completed-window descriptors, pushed by the LDMA interrupt and popped by
+ *    the main loop. The interrupt only writes windowHead and the main loop
+ *    only windowTail, so neither side masks interrupts. The free running
+ *    indices wrap at 256, a multiple of the ring size. The ring holds every
+ *    window whose buffer is still intact.
+ ******************************************************************************/
+#define WINDOW_RING_SIZE          4
+
+#if (INTACT_WINDOWS > WINDOW_RING_SIZE)
+#error "More intact windows than descriptors in the window ring"
+#endif
+
+typedef struct {
+  uint32_t sequence;  ///< Counts every completed window
+  uint32_t tick;      ///< Sleeptimer tick count at completion
+  uint8_t buffer;     ///< Sampling buffer holding the window
+} monitor_window_t;
 
-static bool startedSampling = false;
+static volatile uint8_t windowHead = 0;
+static volatile uint8_t windowTail = 0;
 
 
 
 /***************************************************************************//**
  * @brief
- *    Private LDMA globals.
+ *    Acquisition arena. The buffers written by the LDMA and the window ring
+ *    share one statically sized block, so the RAM of the acquisition is set
+ *    in one place and an overcommit fails the build. The sampling buffers
+ *    come first, word aligned for the packed reduction, and every member is
+ *    a multiple of four bytes long.
+ ******************************************************************************/
+typedef struct {
+  uint16_t sampling[NUM_OF_BUFFERS][BUFFER_STRIDE];
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  // Ring of the transient capture, written around by its own descriptors
+  uint16_t capture[LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES];
+#endif
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  // Waveform copied into the sampling buffers
+  uint16_t synthetic[SYNTHETIC_TABLE_SIZE];
+#endif
+  monitor_window_t windows[WINDOW_RING_SIZE];
+} monitor_arena_t;
+
+_Static_assert(sizeof(monitor_arena_t) <= LE_VOLTAGE_MONITOR_ARENA_SIZE,
+               "The acquisition buffers exceed LE_VOLTAGE_MONITOR_ARENA_SIZE");
+
+static monitor_arena_t arena __ALIGNED(4);
+
+
+
+/***************************************************************************//**
+ * @brief
+ *    Input channels. Entry 0 is the sensor input used by the single mode, the
+ *    scan mode converts the first LE_VOLTAGE_MONITOR_NUM_CHANNELS entries.
+ ******************************************************************************/
+typedef struct {
+  IADC_PosInput_t pos_input;  ///< Positive input, the negative one is ground
+  uint8_t config_id;          ///< IADC configuration converting the input
+  uint8_t divider;            ///< Division of the input ahead of the IADC
+} monitor_channel_t;
+
+// Entries out of order or given twice are reported by -Woverride-init
+#define CHANNEL_ENTRY(index, pos_input, bus, bus_alloc, config_id, divider) \
+  [index] = { pos_input, config_id, divider },
+
+static const monitor_channel_t channels[MAX_SCAN_CHANNELS] = {
+  LE_VOLTAGE_MONITOR_CHANNELS(CHANNEL_ENTRY)
+};
+
+#if LE_VOLTAGE_MONITOR_CAL_ENABLE
+// AVDD, the reference of configuration 0, as measured by the calibration
+static const monitor_channel_t avddChannel = {
+  iadcPosInputAvdd, 1, IADC_SUPPLY_DIVIDER
+};
+#endif
+
+// Straight-line code per converted channel, the conditions are constant
+#define CHANNEL_BUS_ALLOC(index, pos_input, bus, bus_alloc, config_id, divider) \
+  if(((index) < LE_VOLTAGE_MONITOR_NUM_CHANNELS) && ((bus_alloc) != 0)) {      \
+    GPIO->bus |= (bus_alloc);                                                  \
+  }
+
+#define CHANNEL_SCAN_ENTRY(index, pos_input, bus, bus_alloc, config_id, divider) \
+  if((index) < LE_VOLTAGE_MONITOR_NUM_CHANNELS) {                               \
+    initScanTable.entries[index].posInput = (pos_input);                        \
+    initScanTable.entries[index].negInput = IADC_INPUT_NEG;                     \
+    initScanTable.entries[index].configId = (config_id);                        \
+    initScanTable.entries[index].includeInScan = true;                          \
+  }
+
+
+/***************************************************************************//**
+ * @brief
+ *    IADC warmup modes, indexed by LE_VOLTAGE_MONITOR_WARMUP_NORMAL, _STANDBY
+ *    and _KEEP_WARM.
  ******************************************************************************/
-// Configure LDMA to trigger from IADC peripheral
-static LDMA_TransferCfg_t xferCfg = LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_IADC0_IADC_SINGLE);
+typedef struct {
+  IADC_Warmup_t warmup;  ///< Warmup mode of the IADC
+  uint32_t warmup_us;    ///< Warmup ahead of the conversions of every trigger
+  uint32_t idle_ua;      ///< Current between two triggers
+} warmup_mode_t;
+
+static const warmup_mode_t warmupModes[] = {
+  { iadcWarmupNormal,        IADC_WARMUP_US,         0 },
+  { iadcWarmupKeepInStandby, IADC_STANDBY_WARMUP_US, LE_VOLTAGE_MONITOR_IADC_STANDBY_UA },
+  { iadcWarmupKeepWarm,      0,                      LE_VOLTAGE_MONITOR_IADC_KEEP_WARM_UA }
+};
+
+// IADC operating point of the active window configuration. The warmup mode
+// is written by init_iadc(), which runs again on the next bring-up whenever
+// a new configuration selects another mode.
+static uint8_t warmupMode = LE_VOLTAGE_MONITOR_WARMUP_NORMAL;
+static bool iadcConfigured = false;
+static uint8_t srcClkPrescale;
+static uint32_t adcClkPrescale;
+static uint32_t triggerChargePc;
+
 
-static LDMA_Descriptor_t descriptor = LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->SINGLEFIFODATA), // src
-                                                                      samplingBuffer,            // dest
-                                                                      NUM_OF_SAMPLES,      // number of samples to transfer
-                                                                      1);
+/***************************************************************************//**
+ * @brief
+ *    Private LDMA globals.
+ ******************************************************************************/
+// Configure LDMA to trigger from IADC peripheral, or from LETIMER0 when the
+// samples are generated
+static LDMA_TransferCfg_t xferCfg = LDMA_TRANSFER_CFG_PERIPHERAL(WINDOW_LDMA_SIGNAL);
+
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_PING_PONG)
+// Each descriptor links to the next one and the last back to the first, so
+// the LDMA never runs out of buffer space while LETIMER0 keeps triggering
+// conversions.
+#define RING_DESCRIPTOR(i)                                                    \
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),  /* src */       \
+                                   arena.sampling[i],        /* dest */      \
+                                   BUFFER_SIZE,              /* samples */   \
+                                   (((i) < (NUM_OF_BUFFERS - 1)) ? 1 : (1 - NUM_OF_BUFFERS)))
+
+static LDMA_Descriptor_t descriptor[NUM_OF_BUFFERS] = {
+  RING_DESCRIPTOR(0),
+  RING_DESCRIPTOR(1),
+#if (NUM_OF_BUFFERS > 2)
+  RING_DESCRIPTOR(2),
+#endif
+#if (NUM_OF_BUFFERS > 3)
+  RING_DESCRIPTOR(3),
+#endif
+};
+#elif (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+// A single word that the descriptor keeps rewriting, once per window
+static LDMA_Descriptor_t descriptor[NUM_OF_BUFFERS] = {
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),  // src
+                                   arena.sampling[0],        // dest
+                                   BUFFER_SIZE,              // one averaged result per channel
+                                   0)                        // link to itself
+};
+#else
+static LDMA_Descriptor_t descriptor[NUM_OF_BUFFERS] = {
+  LDMA_DESCRIPTOR_SINGLE_P2M_WORD(&(IADC0->IADC_FIFO_DATA),  // src
+                                  arena.sampling[0],        // dest
+                                  BUFFER_SIZE)              // number of samples to transfer
+};
+#endif
+
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+// The capture always converts
+static LDMA_TransferCfg_t captureXferCfg = LDMA_TRANSFER_CFG_PERIPHERAL(IADC_LDMA_SIGNAL);
+
+static LDMA_Descriptor_t captureDescriptor[CAPTURE_BLOCKS] = {
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),
+                                   &arena.capture[0 * CAPTURE_BLOCK_SIZE],
+                                   CAPTURE_BLOCK_SIZE,
+                                   1),
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),
+                                   &arena.capture[1 * CAPTURE_BLOCK_SIZE],
+                                   CAPTURE_BLOCK_SIZE,
+                                   1),
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),
+                                   &arena.capture[2 * CAPTURE_BLOCK_SIZE],
+                                   CAPTURE_BLOCK_SIZE,
+                                   1),
+  LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->IADC_FIFO_DATA),
+                                   &arena.capture[3 * CAPTURE_BLOCK_SIZE],
+                                   CAPTURE_BLOCK_SIZE,
+                                   -3)                       // link back to captureDescriptor[0]
+};
+#endif
 
 
 /***************************************************************************//**
@@ -118,268 +696,1178 @@ static LDMA_Descriptor_t descriptor = LDMA_DESCRIPTOR_LINKREL_P2M_WORD(&(IADC0->
  *    Private static init functions of different peripherals.
  ******************************************************************************/
 static void init_clocks(void);
+static void enable_chain_clocks(bool enable);
+static void bring_up(void);
+static void tear_down(void);
 static void init_letimer(void);
 static void init_iadc(void);
 static void init_prs(void);
 static void init_ldma(void);
 static void init_power_gpio(void);
-void my_timer_callback(sl_sleeptimer_timer_handle_t *handle, void *data);
-int start_Sensor_power_timer(void);
+static uint32_t calc_letimer_top(uint16_t freq_hz, uint16_t num_of_samples);
+static void apply_config(void);
+static void reduce_window(le_voltage_monitor_summary_t *summary, le_window_iir_t *estimate);
+#if LE_VOLTAGE_MONITOR_CAL_ENABLE
+static bool load_calibration(void);
+#endif
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+static void capture_block_done(void);
+#endif
 
 
-void my_timer_callback(sl_sleeptimer_timer_handle_t *handle, void *data)
+/***************************************************************************//**
+ * @brief
+ *    Switch the sensor off.
+ ******************************************************************************/
+static void sensor_power_off(void)
 {
+#if SENSOR_GATED
+  // LETIMER0 may have been stopped between a compare match and the
+  // underflow, return both outputs to idle.
+  LETIMER0->CMD = LETIMER_CMD_CTO0 | LETIMER_CMD_CTO1;
+#else
   GPIO_PinOutClear(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Time of the conversions of one trigger, without the warmup.
+ ******************************************************************************/
+static uint32_t calc_conversion_us(void)
+{
+  // Conversion Time = ((4 * OSR) + 2) * DIGAVG / fCLK_ADC
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  uint32_t osr = 2UL << LE_VOLTAGE_MONITOR_HW_AVG_OSR;
+#if defined(_IADC_CFG_DIGAVG_MASK)
+  uint32_t digavg = 1UL << LE_VOLTAGE_MONITOR_HW_AVG_DIGAVG;
+#else
+  uint32_t digavg = 1;
+#endif
+#else
+  uint32_t osr = 2;
+  uint32_t digavg = 1;
+#endif
+  uint32_t cycles = 0;
+
+  // A scan converts its channels back to back after a single warmup
+  for(uint32_t ch = 0; ch < LE_VOLTAGE_MONITOR_NUM_CHANNELS; ch++) {
+    if(channels[ch].config_id == 0) {
+      cycles += ((4 * osr) + 2) * digavg;
+    } else {
+      cycles += (4 * (2UL << LE_VOLTAGE_MONITOR_CFG1_OSR)) + 2;
+    }
+  }
+
+  return (uint32_t)(((uint64_t)cycles * 1000000 + CLK_ADC_FREQ - 1) / CLK_ADC_FREQ);
 }
 
-int start_Sensor_power_timer(void)
+
+#if SENSOR_GATED
+/***************************************************************************//**
+ * @brief
+ *    Round a time up to LETIMER0 ticks.
+ ******************************************************************************/
+static uint32_t calc_letimer_ticks(uint32_t us)
 {
-  sl_status_t status;
-  sl_sleeptimer_timer_handle_t my_timer;
-  uint32_t timer_timeout = 5;
+  return (uint32_t)(((uint64_t)us * CMU_ClockFreqGet(cmuClock_LETIMER0)
+                     + 999999) / 1000000);
+}
 
-  GPIO_PinOutSet(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
 
-  status = sl_sleeptimer_start_timer(&my_timer,
-                                     timer_timeout,
-                                     my_timer_callback,
-                                     (void *)NULL,
-                                     0,
-                                     0);
-  if(status != SL_STATUS_OK) {
-    return -1;
+/***************************************************************************//**
+ * @brief
+ *    LETIMER0 ticks from the IADC trigger to the underflow, the warmup and the
+ *    conversion fit before the sensor power goes off.
+ ******************************************************************************/
+static uint32_t calc_hold_ticks(void)
+{
+  return calc_letimer_ticks(IADC_WARMUP_US + calc_conversion_us()
+                            + LE_VOLTAGE_MONITOR_SENSOR_HOLD_US);
+}
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Input voltage of a channel at the full scale code: the reference divided
+ *    by the analog gain, times the input divider.
+ ******************************************************************************/
+static uint32_t calc_range_mv(const monitor_channel_t *channel)
+{
+  uint32_t ref_mv;
+  IADC_CfgAnalogGain_t gain;
+  uint32_t half_gain;
+
+  if(channel->config_id == 0) {
+    ref_mv = calReferenceMv;
+    gain = LE_VOLTAGE_MONITOR_CFG0_ANALOG_GAIN;
+  } else {
+    ref_mv = IADC_SUPPLY_REFERENCE_MV;
+    gain = LE_VOLTAGE_MONITOR_CFG1_ANALOG_GAIN;
+  }
+
+  // Gain in halves, keeps 0.5x integer
+  switch(gain) {
+    case iadcCfgAnalogGain0P5x:
+      half_gain = 1;
+      break;
+    case iadcCfgAnalogGain2x:
+      half_gain = 4;
+      break;
+    case iadcCfgAnalogGain3x:
+      half_gain = 6;
+      break;
+    case iadcCfgAnalogGain4x:
+      half_gain = 8;
+      break;
+    default:
+      half_gain = 2;
+      break;
   }
-  return 1;
+
+  return (ref_mv * channel->divider * 2) / half_gain;
 }
 
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE || LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
 /***************************************************************************//**
  * @brief
- *    Convert raw ADC data to millivolts.
+ *    Remove the calibrated offset from a single code of the sensor input.
  ******************************************************************************/
-static uint32_t convert_to_mv(uint32_t raw)
+static uint32_t remove_code_offset(uint32_t raw)
 {
-  return raw * 3300 / 0xFFF;  // 12 bit adc
+  return (raw > calOffset) ? (raw - calOffset) : 0;
 }
+#endif
 
 
 /***************************************************************************//**
  * @brief
- *    Initialize the low energy peripherals to measure the voltage of a pin.
- *
- * @details
- *    The LETIMER, PRS, IADC, and LDMA peripherals are initialized. The
- *    LETIMER's underflow event will be connected to the IADC start conversion
- *    trigger through PRS. The LDMA will transfer the data to a buffer when the
- *    IADC conversion is complete.
- *
- * @note
- *    The LDMA will not begin transferring the data after initialization. The
- *    le_voltage_monitor_start_next() function must be called to start
- *    measuring data.
+ *    Convert the offset corrected sum of the ADC codes of one channel of a
+ *    buffer to the average of the channel in millivolts, rounded to nearest.
  ******************************************************************************/
-void le_voltage_monitor_init(void)
+static uint16_t convert_sum_to_mv(uint32_t raw_sum, uint32_t channel)
 {
-  init_clocks();
-  init_letimer();
-  init_prs();
-  init_iadc();
-  init_ldma();
-  init_power_gpio();
+  return le_window_math_scale(raw_sum, mvScaleFactor[channel]);
 }
 
 
-void init_power_gpio(void)
+/***************************************************************************//**
+ * @brief
+ *    Convert a single offset corrected ADC code of the sensor input to
+ *    millivolts, rounded to nearest.
+ ******************************************************************************/
+static uint16_t convert_code_to_mv(uint32_t raw)
 {
-  GPIO_PinModeSet(SENSOR_POWER_PORT, SENSOR_POWER_PIN, gpioModePushPull, 0);
+  return le_window_math_scale(raw, mvCodeScaleFactor);
 }
 
 
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
 /***************************************************************************//**
  * @brief
- *    Gets the average millivoltage of the samples taken between complete LDMA
- *    transfers.
- *
- * @return
- *    Average voltage in millivolts
+ *    Sum the ADC codes of one channel of the last completed buffer, less the
+ *    calibrated offset of the sensor inputs.
  ******************************************************************************/
-uint16_t le_voltage_monitor_get_average_mv(void)
+static uint32_t sum_channel(uint32_t channel)
 {
-  uint32_t avg = 0;
-  for(int32_t i = 0; i < NUM_OF_SAMPLES; i++) {
-    avg += convert_to_mv(samplingBuffer[i]);
+  uint32_t sum = 0;
+  uint32_t offset = 0;
+  const uint16_t *buffer = arena.sampling[readyBuffer];
+
+  for(int32_t i = 0; i < samplesPerBuffer; i++) {
+    sum += buffer[(i * LE_VOLTAGE_MONITOR_NUM_CHANNELS) + channel];
+  }
+
+  // The supply inputs use the factory calibrated internal reference
+  if(channels[channel].config_id == 0) {
+    offset = (uint32_t)calOffset * samplesPerBuffer;
   }
-  return avg / NUM_OF_SAMPLES;
+  return (sum > offset) ? (sum - offset) : 0;
 }
+#endif
 
 
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE || CAPTURE_COMPARATOR
 /***************************************************************************//**
  * @brief
- *    Starts the peripherals to begin sampling until internal buffer is filled.
+ *    Convert a sensor input voltage to a window comparator threshold.
  ******************************************************************************/
-void le_voltage_monitor_start_next(void)
+static uint16_t calc_compare_code(uint32_t mv)
 {
+  uint32_t range_mv = calc_range_mv(&channels[0]);
+  uint32_t code;
 
-  if(!startedSampling) {
+  if(mv >= range_mv) {
+    return IADC_COMPARE_FULL_SCALE;
+  }
 
-    IADC_command(IADC0, iadcCmdStartSingle);
+  // The comparator sees the uncorrected result, add the offset back
+  code = ((mv * IADC_COMPARE_FULL_SCALE + (range_mv / 2)) / range_mv)
+         + ((uint32_t)calOffset << (16 - IADC_RESOLUTION_BITS));
+  return (code > IADC_COMPARE_FULL_SCALE) ? IADC_COMPARE_FULL_SCALE : (uint16_t)code;
+}
+#endif
 
-    // Start timer
-    LETIMER_Enable(LETIMER0, true);
 
-    // Start LDMA
-    LDMA_StartTransfer(LDMA_CHANNEL, &xferCfg, &descriptor);
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Set the window comparator thresholds. If gt_mv is above lt_mv a result
+ *    matches outside of the band, at or above gt_mv or at or below lt_mv.
+ *    Otherwise it matches inside of the band, from gt_mv to lt_mv.
+ ******************************************************************************/
+static void set_compare_window(uint32_t gt_mv, uint32_t lt_mv)
+{
+  IADC0->CMPTHR = ((uint32_t)calc_compare_code(gt_mv) << _IADC_CMPTHR_ADGT_SHIFT)
+                  | ((uint32_t)calc_compare_code(lt_mv) << _IADC_CMPTHR_ADLT_SHIFT);
+}
+#endif
 
-    //The GPIO will power the sensor, and it will be disbaled on the ADC IRQ
-    start_Sensor_power_timer();
 
-    // Set flag to indicate sampling is occuring.
-    startedSampling = true;
+/***************************************************************************//**
+ * @brief
+ *    Calculate the LETIMER0 top value for a sampling frequency. In hardware
+ *    averaging mode there is only one trigger per window, i.e. every
+ *    num_of_samples sampling periods.
+ ******************************************************************************/
+static uint32_t calc_letimer_top(uint16_t freq_hz, uint16_t num_of_samples)
+{
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  uint32_t periods = num_of_samples;
+#else
+  uint32_t periods = 1;
+  (void)num_of_samples;
+#endif
+
+  return CMU_ClockFreqGet(cmuClock_LETIMER0) * periods / freq_hz;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Estimated IADC charge of one trigger period in a warmup mode: the active
+ *    current over the warmup and the conversions, the idle current of the
+ *    mode for the rest of the period.
+ *
+ * @return
+ *    Charge in picocoulombs.
+ ******************************************************************************/
+static uint64_t calc_trigger_charge_pc(uint8_t mode)
+{
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  uint64_t period_us = ((uint64_t)numOfSamples * 1000000) / samplingFreqHz;
+#else
+  uint64_t period_us = 1000000 / samplingFreqHz;
+#endif
+  uint32_t active_us = warmupModes[mode].warmup_us + calc_conversion_us();
+  uint64_t charge_pc = (uint64_t)LE_VOLTAGE_MONITOR_IADC_ACTIVE_UA * active_us;
+
+  if(period_us > active_us) {
+    charge_pc += warmupModes[mode].idle_ua * (period_us - active_us);
   }
+  return charge_pc;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Stops the sampling.
+ *    Select the warmup mode of the active window configuration. The IADC is
+ *    configured again by the next bring-up if the mode changes.
  ******************************************************************************/
-void le_voltage_monitor_stop(void)
+static void select_warmup(void)
 {
+  uint8_t mode = LE_VOLTAGE_MONITOR_WARMUP_POLICY;
+  uint64_t charge_pc;
+
+#if (LE_VOLTAGE_MONITOR_WARMUP_POLICY == LE_VOLTAGE_MONITOR_WARMUP_AUTO)
+  // Least charge per trigger period, the lower mode on a tie
+  mode = LE_VOLTAGE_MONITOR_WARMUP_NORMAL;
+  for(uint8_t m = LE_VOLTAGE_MONITOR_WARMUP_STANDBY;
+      m <= LE_VOLTAGE_MONITOR_WARMUP_KEEP_WARM;
+      m++) {
+    if(calc_trigger_charge_pc(m) < calc_trigger_charge_pc(mode)) {
+      mode = m;
+    }
+  }
+#endif
 
-  //Disables the GPIO that powers the sensor
- // GPIO_PinOutClear(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+  charge_pc = calc_trigger_charge_pc(mode);
+  triggerChargePc = (charge_pc > UINT32_MAX) ? UINT32_MAX : (uint32_t)charge_pc;
 
-  // Stop timer
-  LETIMER_Enable(LETIMER0, false);
+  if(mode != warmupMode) {
+    warmupMode = mode;
+    iadcConfigured = false;
+  }
+}
 
-  // Stop IADC
-  IADC_command(IADC0, iadcCmdStopSingle);
 
-  // Reset flag
-  startedSampling = false;
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Convert a sensor input voltage to the code the reduction turns back into
+ *    that voltage.
+ ******************************************************************************/
+static uint16_t calc_synthetic_code(uint32_t mv)
+{
+  uint32_t range_mv = calc_range_mv(&channels[0]);
+  uint32_t code = IADC_FULL_SCALE;
 
-  // Stop LDMA
-  LDMA_StopTransfer(LDMA_CHANNEL);
+  if(mv < range_mv) {
+    code = (mv * IADC_FULL_SCALE + (range_mv / 2)) / range_mv;
+  }
+
+  // The calibrated offset is taken off again
+  code += calOffset;
+  return (code > IADC_FULL_SCALE) ? IADC_FULL_SCALE : (uint16_t)code;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Initialize all the clocks used for the peripherals.
+ *    Generate the first period of the waveform, repeated to the end of the
+ *    table.
  ******************************************************************************/
-static void init_clocks(void)
+static void fill_synthetic(void)
 {
-  // Enable GPIO clock
-  CMU_ClockEnable(cmuClock_GPIO, true);
+  uint32_t low = calc_synthetic_code(LE_VOLTAGE_MONITOR_SYNTHETIC_LOW_MV);
+  uint32_t span = calc_synthetic_code(LE_VOLTAGE_MONITOR_SYNTHETIC_HIGH_MV) - low;
+#if (LE_VOLTAGE_MONITOR_SYNTHETIC_WAVEFORM == LE_VOLTAGE_MONITOR_SYNTHETIC_NOISE)
+  uint16_t lfsr = 0xACE1;
+#endif
+
+  for(uint32_t i = 0; i < LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD; i++) {
+#if (LE_VOLTAGE_MONITOR_SYNTHETIC_WAVEFORM == LE_VOLTAGE_MONITOR_SYNTHETIC_NOISE)
+    // Galois LFSR of x^16 + x^14 + x^13 + x^11 + 1
+    lfsr = (lfsr >> 1) ^ ((lfsr & 1) ? 0xB400 : 0);
+    arena.synthetic[i] = (uint16_t)(low + (lfsr % (span + 1)));
+#else
+    arena.synthetic[i] = (uint16_t)(low + ((span * i) / (LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD - 1)));
+#endif
+  }
+  for(uint32_t i = LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD; i < SYNTHETIC_TABLE_SIZE; i++) {
+    arena.synthetic[i] = arena.synthetic[i - LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD];
+  }
+  syntheticResume = 0;
+}
 
-  // Select LETimer0 clock to run off LFXO
-  // Reference: EFR32xG22 RM, Figure 8.3
-  CMU_ClockSelectSet(cmuClock_EM23GRPACLK, cmuSelect_LFXO);
 
-  // Enable LETimer0 clock
-  CMU_ClockEnable(cmuClock_LETIMER0, true);
+/***************************************************************************//**
+ * @brief
+ *    Point the descriptors at consecutive stretches of the waveform, the
+ *    first one where the last completed window ended.
+ ******************************************************************************/
+static void restart_synthetic(void)
+{
+  uint32_t length = descriptor[0].xfer.xferCnt + 1;
 
-  // Enable PRS clock
-  CMU_ClockEnable(cmuClock_PRS, true);
+  for(uint32_t i = 0; i < NUM_OF_BUFFERS; i++) {
+    uint32_t offset = (syntheticResume + (i * length)) % LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD;
 
-  // Configure IADC clock source for use while in EM2
-  // Reference: EFR32xG22 RM, Figure 8.2
-  CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);  // FSRCO - 20MHz
+    descriptor[i].xfer.srcAddr = (uint32_t)&arena.synthetic[offset];
+  }
+}
 
-  // Enable IADC0 clock
-  CMU_ClockEnable(cmuClock_IADC0, true);
 
-  // Enable LDMA clock
-  CMU_ClockEnable(cmuClock_LDMA, true);
+/***************************************************************************//**
+ * @brief
+ *    Advance the waveform past a completed window, and point its descriptor
+ *    at the stretch it fills next, after the windows of the others.
+ ******************************************************************************/
+static void advance_synthetic(uint8_t buffer)
+{
+  uint32_t length = descriptor[buffer].xfer.xferCnt + 1;
+  uint32_t offset;
 
+  syntheticResume = (syntheticResume + length) % LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD;
+  offset = (syntheticResume + ((NUM_OF_BUFFERS - 1) * length))
+           % LE_VOLTAGE_MONITOR_SYNTHETIC_PERIOD;
+  descriptor[buffer].xfer.srcAddr = (uint32_t)&arena.synthetic[offset];
 }
+#endif
 
 
 /***************************************************************************//**
  * @brief
- *    Initialize LETimer.
+ *    Apply the active window configuration to the LDMA descriptors, the
+ *    conversion factor and the IADC warmup mode. Must only be called while
+ *    not sampling.
  ******************************************************************************/
-static void init_letimer(void)
+static void apply_config(void)
 {
-  // Declare init struct
-  LETIMER_Init_TypeDef init = LETIMER_INIT_DEFAULT;
-
-  // Initialize letimer to run in free running mode
-  // Reference: EFR32xG22 RM, Section 18.3.2
-  init.repMode = letimerRepeatFree;
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  samplesPerBuffer = 1;
+#else
+  samplesPerBuffer = numOfSamples;
+#endif
+
+  // LETIMER0 gets the top value when sampling starts, it may be unclocked
+  for(uint32_t i = 0; i < NUM_OF_BUFFERS; i++) {
+    descriptor[i].xfer.xferCnt = (samplesPerBuffer * LE_VOLTAGE_MONITOR_NUM_CHANNELS) - 1;
+  }
 
-  // Pulse output for PRS
-  init.ufoa0 = letimerUFOAPulse;
+  for(uint32_t ch = 0; ch < LE_VOLTAGE_MONITOR_NUM_CHANNELS; ch++) {
+    mvScaleFactor[ch] = le_window_math_scale_factor(calc_range_mv(&channels[ch]),
+                                                    IADC_FULL_SCALE,
+                                                    samplesPerBuffer);
+  }
 
-  // Set frequency
-  init.topValue = CMU_ClockFreqGet(cmuClock_LETIMER0) / SAMPLING_FREQ_HZ;
+  sensorRangeMv = calc_range_mv(&channels[0]);
+  mvCodeScaleFactor = le_window_math_scale_factor(sensorRangeMv, IADC_FULL_SCALE, 1);
 
-  // Disable letimer
-  init.enable = false;
-  init.debugRun = true;
+  select_warmup();
 
-  // Initialize free-running letimer
-  LETIMER_Init(LETIMER0, &init);
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  // Follows the calibration, which also ends here
+  fill_synthetic();
+#endif
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Initialize PRS.
+ *    Change the sampling frequency and the number of samples per window.
  ******************************************************************************/
-static void init_prs(void)
+sl_status_t le_voltage_monitor_set_config(uint16_t sampling_freq_hz,
+                                          uint16_t num_of_samples)
 {
-  // Producer
-  PRS_SourceAsyncSignalSet(PRS_CHANNEL_LETIMER_IADC,
-                           PRS_ASYNC_CH_CTRL_SOURCESEL_LETIMER0,
-                           PRS_ASYNC_CH_CTRL_SIGSEL_LETIMER0CH0);
+  uint32_t top;
 
-  // Consumer
-  PRS_ConnectConsumer(PRS_CHANNEL_LETIMER_IADC,
-                      prsTypeAsync,
-                      prsConsumerIADC0_SINGLETRIGGER);
+  if((sampling_freq_hz == 0)
+     || (sampling_freq_hz > LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ)
+     || (num_of_samples == 0)
+     || (num_of_samples > LE_VOLTAGE_MONITOR_MAX_SAMPLES)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
 
+  // The sensor power gate has to fit into one trigger period
+  top = calc_letimer_top(sampling_freq_hz, num_of_samples);
+  if((top == 0) || (top > LETIMER_TOP_MAX) || (top <= gateOnTicks)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  if(startedSampling) {
+    // Picked up by le_voltage_monitor_start_next() after the current window
+    pendingFreqHz = sampling_freq_hz;
+    pendingNumOfSamples = num_of_samples;
+    configPending = true;
+  } else {
+    samplingFreqHz = sampling_freq_hz;
+    numOfSamples = num_of_samples;
+    configPending = false;
+    apply_config();
+  }
 
-//  PRS_SourceAsyncSignalSet(PRS_CHANNEL_LETIMER_GPIO,
-//                            PRS_ASYNC_CH_CTRL_SOURCESEL_LETIMER0,
-//                            PRS_ASYNC_CH_CTRL_SIGSEL_LETIMER0CH0);
-//
-//  PRS_PinOutput(PRS_CHANNEL_LETIMER_GPIO,prsTypeAsync, SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+  return SL_STATUS_OK;
 }
 
 
 /***************************************************************************//**
  * @brief
- *    Initialize IADC.
+ *    Get the window configuration.
  ******************************************************************************/
-static void init_iadc(void)
+void le_voltage_monitor_get_config(uint16_t *sampling_freq_hz,
+                                   uint16_t *num_of_samples)
 {
-  // Declare init structs
-  IADC_Init_t init = IADC_INIT_DEFAULT;
-  IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
-  IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
-  IADC_SingleInput_t initSingleInput = IADC_SINGLEINPUT_DEFAULT;
+  // Report what the next window will use
+  *sampling_freq_hz = configPending ? pendingFreqHz : samplingFreqHz;
+  *num_of_samples = configPending ? pendingNumOfSamples : numOfSamples;
+}
 
-  // Reset IADC to reset configuration in case it has been modified
-  IADC_reset(IADC0);
 
-  // Reference: EFR32xG22 RM, Section 24.3.3.1
-  init.warmup = iadcWarmupNormal;
+/***************************************************************************//**
+ * @brief
+ *    Get how long the sensor is powered during one window.
+ ******************************************************************************/
+uint32_t le_voltage_monitor_get_sensor_on_us(void)
+{
+#if SENSOR_GATED
+  // Powered for the gate ahead of every trigger
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  uint32_t triggers = 1;
+#else
+  uint32_t triggers = numOfSamples;
+#endif
+
+  return (uint32_t)(((uint64_t)gateOnTicks * triggers * 1000000)
+                    / CMU_ClockFreqGet(cmuClock_LETIMER0));
+#else
+  // Powered for the whole window
+  return (uint32_t)(((uint64_t)numOfSamples * 1000000) / samplingFreqHz);
+#endif
+}
 
-  // Set the HFSCLK prescale value here
-  init.srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, CLK_SRC_ADC_FREQ, 0);
+
+/***************************************************************************//**
+ * @brief
+ *    Get the IADC operating point of the active window configuration.
+ ******************************************************************************/
+void le_voltage_monitor_get_operating_point(le_voltage_monitor_operating_point_t *point)
+{
+  point->warmup = warmupMode;
+  point->src_clk_prescale = srcClkPrescale;
+  point->adc_clk_prescale = (uint16_t)adcClkPrescale;
+  point->clk_adc_hz = CMU_ClockFreqGet(cmuClock_IADCCLK)
+                      / (srcClkPrescale + 1UL) / (adcClkPrescale + 1);
+  point->trigger_us = warmupModes[warmupMode].warmup_us + calc_conversion_us();
+  point->charge_pc = triggerChargePc;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the LETIMER0 ticks of one trigger period and of one window.
+ ******************************************************************************/
+void le_voltage_monitor_get_ticks(uint32_t *trigger_ticks, uint32_t *window_ticks)
+{
+  // The counter runs down from TOP to zero and is reloaded on underflow
+  *trigger_ticks = calc_letimer_top(samplingFreqHz, numOfSamples) + 1;
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  *window_ticks = *trigger_ticks;
+#else
+  *window_ticks = *trigger_ticks * numOfSamples;
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the bytes of the acquisition arena in use.
+ ******************************************************************************/
+size_t le_voltage_monitor_get_arena_usage(void)
+{
+  return sizeof(arena);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Lengthen or shorten the trigger period in progress.
+ ******************************************************************************/
+int32_t le_voltage_monitor_trim(int32_t ticks)
+{
+  uint32_t top = calc_letimer_top(samplingFreqHz, numOfSamples);
+  // Compare matches ahead of the underflow must not be crossed, see the
+  // sensor gate, and the write takes a few ticks to synchronize
+  uint32_t guard = gateOnTicks + TRIM_SYNC_TICKS;
+  int32_t limit = (int32_t)((top + 1) / 2);
+  uint32_t count;
+  CORE_DECLARE_IRQ_STATE;
+
+  if(ticks > limit) {
+    ticks = limit;
+  } else if(ticks < -limit) {
+    ticks = -limit;
+  }
+
+  if(!startedSampling || (ticks == 0)) {
+    return 0;
+  }
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    return 0;
+  }
+#endif
+
+  CORE_ENTER_ATOMIC();
+  count = LETIMER_CounterGet(LETIMER0);
+  if(count <= guard) {
+    // Past the compare matches, try again the next window
+    ticks = 0;
+  } else {
+    if((ticks < 0) && ((uint32_t)-ticks >= (count - guard))) {
+      ticks = -(int32_t)(count - guard - 1);
+    }
+    LETIMER_CounterSet(LETIMER0, (uint32_t)((int32_t)count + ticks));
+  }
+  CORE_EXIT_ATOMIC();
+
+  return ticks;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize the low energy peripherals to measure the voltage of a pin.
+ *
+ * @details
+ *    The LETIMER, PRS, IADC, and LDMA peripherals are initialized. The
+ *    LETIMER's underflow event will be connected to the IADC start conversion
+ *    trigger through PRS. The LDMA will transfer the data to a buffer when the
+ *    IADC conversion is complete. Only the clock selection and the PRS are
+ *    set up here, the LETIMER, IADC and LDMA are configured when sampling
+ *    starts for the first time.
+ *
+ * @note
+ *    The LDMA will not begin transferring the data after initialization. The
+ *    le_voltage_monitor_start_next() function must be called to start
+ *    measuring data.
+ ******************************************************************************/
+void le_voltage_monitor_init(void)
+{
+  // The rest of the chain is configured by the first start, see bring_up()
+  init_clocks();
+  init_prs();
+  init_power_gpio();
+
+  // Divide the FSRCO down to CLK_ADC, both configurations share the clock
+  srcClkPrescale = IADC_calcSrcClkPrescale(IADC0, CLK_SRC_ADC_FREQ, 0);
+  adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
+                                           CLK_ADC_FREQ,
+                                           0,
+                                           iadcCfgModeNormal,
+                                           srcClkPrescale);
+
+#if LE_VOLTAGE_MONITOR_CAL_ENABLE
+  // Calibrate once per device, every later boot loads the stored result
+  if(!load_calibration()) {
+    (void)le_voltage_monitor_calibrate();
+  }
+#endif
+#if SENSOR_GATED
+  gateOnTicks = calc_hold_ticks() + calc_letimer_ticks(LE_VOLTAGE_MONITOR_SENSOR_SETTLE_US);
+#endif
+  apply_config();
+
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+  le_cycle_counter_init();
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize the sensor power pin. In gated mode it is driven by PRS.
+ ******************************************************************************/
+static void init_power_gpio(void)
+{
+  GPIO_PinModeSet(SENSOR_POWER_PORT, SENSOR_POWER_PIN, gpioModePushPull, 0);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Gets the average millivoltage of the samples taken between complete LDMA
+ *    transfers.
+ *
+ * @return
+ *    Average voltage in millivolts
+ ******************************************************************************/
+uint16_t le_voltage_monitor_get_average_mv(void)
+{
+  return readySummary.avg_mv;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Gets the statistics of the most recently delivered window.
+ ******************************************************************************/
+void le_voltage_monitor_get_summary(le_voltage_monitor_summary_t *summary)
+{
+  *summary = readySummary;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether the buffer of a completed window has not been refilled.
+ ******************************************************************************/
+static bool window_intact(uint32_t sequence)
+{
+  return (completedSequence - sequence) < INTACT_WINDOWS;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reduce the next completed window still held by its buffer.
+ ******************************************************************************/
+bool le_voltage_monitor_next_summary(le_voltage_monitor_summary_t *summary)
+{
+  while(windowTail != windowHead) {
+    uint8_t tail = windowTail;
+    monitor_window_t window;
+    le_voltage_monitor_summary_t reduced;
+    le_window_iir_t estimate = runningEstimate;
+    uint32_t lost;
+
+    // Read the descriptor only after seeing the index that published it
+    __DMB();
+    window = arena.windows[tail % WINDOW_RING_SIZE];
+    windowTail = tail + 1;
+
+    // Late windows are reduced as long as the LDMA has not come round to
+    // their buffer again, checked before and after reducing
+    if(!window_intact(window.sequence)) {
+      continue;
+    }
+
+    readyBuffer = window.buffer;
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+    uint32_t start = DWT->CYCCNT;
+
+    reduce_window(&reduced, &estimate);
+    reduceCycles = DWT->CYCCNT - start;
+    if(reduceCycles > reduceCyclesMax) {
+      reduceCyclesMax = reduceCycles;
+    }
+#else
+    reduce_window(&reduced, &estimate);
+#endif
+#if LE_TRACE_ENABLE
+    le_trace_record(LE_TRACE_REDUCED);
+#endif
+
+    // A torn window is dropped before it reaches the delivered summary or
+    // the running estimate
+    if(!window_intact(window.sequence)) {
+      continue;
+    }
+
+    lost = window.sequence - deliveredSequence - 1;
+    deliveredSequence = window.sequence;
+
+    reduced.tick = window.tick;
+    reduced.overruns = (lost > UINT16_MAX) ? UINT16_MAX : (uint16_t)lost;
+    reduced.sequence = window.sequence;
+    runningEstimate = estimate;
+    readySummary = reduced;
+    *summary = readySummary;
+    return true;
+  }
+
+  return false;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reduce the last completed buffer: statistics of the raw samples, then
+ *    the optional FIR average and the running estimate, advanced in
+ *    estimate. Leaves the tick, overruns and sequence to the caller.
+ ******************************************************************************/
+static void reduce_window(le_voltage_monitor_summary_t *summary, le_window_iir_t *estimate)
+{
+  le_window_stats_t stats;
+  uint16_t *buffer = arena.sampling[readyBuffer];
+
+#if PACKED_REDUCTION
+  le_window_math_reduce_packed(buffer, samplesPerBuffer, &stats);
+#else
+  le_window_math_reduce(buffer, samplesPerBuffer, LE_VOLTAGE_MONITOR_NUM_CHANNELS, &stats);
+#endif
+  le_window_math_remove_offset(&stats, calOffset);
+
+  summary->avg_mv = convert_sum_to_mv(stats.sum, 0);
+  summary->min_mv = convert_code_to_mv(stats.min);
+  summary->max_mv = convert_code_to_mv(stats.max);
+  summary->rms_mv = le_window_math_rms_mv(&stats, sensorRangeMv, IADC_FULL_SCALE);
+  summary->stddev_uv = le_window_math_stddev_uv(&stats, sensorRangeMv, IADC_FULL_SCALE);
+
+#if FILTER_FIR
+  // The raw samples are not needed any more, replace the plain average by the
+  // one of the filtered outputs
+  {
+    uint32_t filtered_sum = 0;
+    uint64_t outputs = le_window_math_fir_decimate(buffer,
+                                                   samplesPerBuffer,
+                                                   LE_VOLTAGE_MONITOR_NUM_CHANNELS,
+                                                   firTaps,
+                                                   LE_VOLTAGE_MONITOR_FIR_TAPS,
+                                                   FIR_GAIN,
+                                                   LE_VOLTAGE_MONITOR_FIR_DECIMATION,
+                                                   FIR_FRACTION_BITS,
+                                                   &filtered_sum);
+
+    if(outputs > 0) {
+      uint64_t filtered_scale = (outputs * IADC_FULL_SCALE) << FIR_FRACTION_BITS;
+      uint64_t filtered_offset = (outputs * calOffset) << FIR_FRACTION_BITS;
+
+      // Unity DC gain, every output carries the offset once
+      filtered_sum = (filtered_sum > filtered_offset)
+                     ? (uint32_t)(filtered_sum - filtered_offset) : 0;
+
+      summary->avg_mv = (uint16_t)(((uint64_t)filtered_sum * sensorRangeMv
+                                    + (filtered_scale / 2)) / filtered_scale);
+    }
+  }
+#endif
+
+  summary->running_mv = le_window_math_iir_update(estimate,
+                                                  summary->avg_mv,
+                                                  LE_VOLTAGE_MONITOR_IIR_SHIFT);
+
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+  summary->channel_mv[0] = summary->avg_mv;
+  for(uint32_t ch = 1; ch < LE_VOLTAGE_MONITOR_NUM_CHANNELS; ch++) {
+    summary->channel_mv[ch] = convert_sum_to_mv(sum_channel(ch), ch);
+  }
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Starts the peripherals to begin sampling until internal buffer is filled.
+ *
+ * @note
+ *    In continuous and hardware averaging modes the peripherals keep running
+ *    once started, so calling this function again after every window has no
+ *    effect.
+ ******************************************************************************/
+void le_voltage_monitor_start_next(void)
+{
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  // Window sampling resumes once the capture is released
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    return;
+  }
+#endif
+
+  // Window configuration changed while sampling. The previous window has been
+  // consumed already, restart with the new settings.
+  if(configPending) {
+    if(startedSampling) {
+      le_voltage_monitor_stop();
+    }
+    samplingFreqHz = pendingFreqHz;
+    numOfSamples = pendingNumOfSamples;
+    configPending = false;
+    apply_config();
+  }
+
+  if(!startedSampling) {
+
+    // Clock the chain, configured once, and apply the window period
+    bring_up();
+    LETIMER_TopSet(LETIMER0, calc_letimer_top(samplingFreqHz, numOfSamples));
+
+    // The LDMA always restarts on the first buffer
+    fillingBuffer = 0;
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+    // The waveform runs on from the previous window, also in single shot mode
+    restart_synthetic();
+#endif
+
+#if !SENSOR_GATED
+    // Power the sensor for as long as sampling runs
+    GPIO_PinOutSet(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+#endif
+
+#if !LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+    IADC_command(IADC0, IADC_CMD_START);
+#endif
+
+    // Start timer
+    LETIMER_Enable(LETIMER0, true);
+
+    // Start LDMA
+    LDMA_StartTransfer(LDMA_CHANNEL, &xferCfg, &descriptor[0]);
+
+    // Set flag to indicate sampling is occuring.
+    startedSampling = true;
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stops the sampling.
+ ******************************************************************************/
+void le_voltage_monitor_stop(void)
+{
+
+  // Nothing runs before the first start or after the last stop
+  if(!chainClocked) {
+    return;
+  }
+
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  // The chain belongs to the capture, see le_voltage_monitor_capture_release()
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    return;
+  }
+#endif
+
+  // Stop timer
+  LETIMER_Enable(LETIMER0, false);
+
+  // Disable the GPIO that powers the sensor
+  sensor_power_off();
+
+  // Stop IADC
+  IADC_command(IADC0, IADC_CMD_STOP);
+
+  // Reset flag
+  startedSampling = false;
+
+  // Stop LDMA
+  LDMA_StopTransfer(LDMA_CHANNEL);
+
+  // Windows not delivered yet are discarded, not counted as lost
+  windowTail = windowHead;
+  deliveredSequence = completedSequence;
+
+  // Unclock the chain until the next start
+  tear_down();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize all the clocks used for the peripherals.
+ ******************************************************************************/
+static void init_clocks(void)
+{
+  // Enable GPIO clock
+  CMU_ClockEnable(cmuClock_GPIO, true);
+
+  // Select LETimer0 clock to run off LFXO
+  // Reference: EFR32xG22 RM, Figure 8.3
+  CMU_ClockSelectSet(cmuClock_EM23GRPACLK, cmuSelect_LFXO);
+
+  // Enable PRS clock, it keeps routing the sensor power pin
+  CMU_ClockEnable(cmuClock_PRS, true);
+
+  // Configure IADC clock source for use while in EM2
+  // Reference: EFR32xG22 RM, Figure 8.2
+  CMU_ClockSelectSet(cmuClock_IADCCLK, cmuSelect_FSRCO);  // FSRCO - 20MHz
+
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Enable or disable the clocks of the LETIMER0, IADC0 and LDMA.
+ ******************************************************************************/
+static void enable_chain_clocks(bool enable)
+{
+  CMU_ClockEnable(cmuClock_LETIMER0, enable);
+  CMU_ClockEnable(cmuClock_IADC0, enable);
+  CMU_ClockEnable(cmuClock_LDMA, enable);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clock the acquisition chain. The peripherals are configured on the first
+ *    call only, their registers are retained while unclocked.
+ ******************************************************************************/
+static void bring_up(void)
+{
+  if(chainClocked) {
+    return;
+  }
+
+  enable_chain_clocks(true);
+  chainClocked = true;
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  // Only the IADC wakes the LDMA out of EM2, LETIMER0 requests need EM1
+  sl_power_manager_add_em_requirement(SL_POWER_MANAGER_EM1);
+#endif
+
+  if(!chainConfigured) {
+    init_letimer();
+    init_iadc();
+    init_ldma();
+    chainConfigured = true;
+  } else if(!iadcConfigured) {
+    // Another warmup mode has been selected since
+    init_iadc();
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Unclock the stopped acquisition chain.
+ ******************************************************************************/
+static void tear_down(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  // Let a conversion end before its clock goes
+  while(IADC0->STATUS & IADC_STATUS_CONVERTING) {
+  }
+
+  // No handler may run on an unclocked peripheral
+  CORE_ENTER_ATOMIC();
+  LDMA_IntClear(_LDMA_IF_MASK);
+  NVIC_ClearPendingIRQ(LDMA_IRQn);
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE || CAPTURE_COMPARATOR
+  IADC_clearInt(IADC0, _IADC_IF_MASK);
+  NVIC_ClearPendingIRQ(IADC_IRQn);
+#endif
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  if(chainClocked) {
+    sl_power_manager_remove_em_requirement(SL_POWER_MANAGER_EM1);
+  }
+#endif
+  enable_chain_clocks(false);
+  chainClocked = false;
+  CORE_EXIT_ATOMIC();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize LETimer.
+ ******************************************************************************/
+static void init_letimer(void)
+{
+  // Declare init struct
+  LETIMER_Init_TypeDef init = LETIMER_INIT_DEFAULT;
+
+  // Initialize letimer to run in free running mode
+  // Reference: EFR32xG22 RM, Section 18.3.2
+  init.repMode = letimerRepeatFree;
+
+#if SENSOR_GATED
+  // PWM outputs for the IADC trigger and the sensor power, see above
+  init.ufoa0 = letimerUFOAPwm;
+  init.ufoa1 = letimerUFOAPwm;
+#else
+  // Pulse output for PRS
+  init.ufoa0 = letimerUFOAPulse;
+#endif
+
+  // Set frequency
+  init.topValue = calc_letimer_top(samplingFreqHz, numOfSamples);
+
+  // Disable letimer
+  init.enable = false;
+  init.debugRun = true;
+
+  // Initialize free-running letimer
+  LETIMER_Init(LETIMER0, &init);
+
+#if SENSOR_GATED
+  // Trigger once the conversion fits before the underflow, power the sensor
+  // the settle time before that, see le_voltage_monitor_init()
+  LETIMER_CompareSet(LETIMER0, 0, calc_hold_ticks());
+  LETIMER_CompareSet(LETIMER0, 1, gateOnTicks);
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize PRS.
+ ******************************************************************************/
+static void init_prs(void)
+{
+  // Producer
+  PRS_SourceAsyncSignalSet(PRS_CHANNEL_LETIMER_IADC,
+                           PRS_ASYNC_CH_CTRL_SOURCESEL_LETIMER0,
+                           PRS_ASYNC_CH_CTRL_SIGSEL_LETIMER0CH0);
+
+  // Consumer
+  PRS_ConnectConsumer(PRS_CHANNEL_LETIMER_IADC,
+                      prsTypeAsync,
+                      IADC_PRS_CONSUMER);
+
+#if SENSOR_GATED
+  // LETIMER0 output 1 drives the sensor power pin
+  PRS_SourceAsyncSignalSet(PRS_CHANNEL_LETIMER_GPIO,
+                           PRS_ASYNC_CH_CTRL_SOURCESEL_LETIMER0,
+                           PRS_ASYNC_CH_CTRL_SIGSEL_LETIMER0CH1);
+
+  PRS_PinOutput(PRS_CHANNEL_LETIMER_GPIO, prsTypeAsync, SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+#endif
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Initialize IADC.
+ ******************************************************************************/
+static void init_iadc(void)
+{
+  // Declare init structs
+  IADC_Init_t init = IADC_INIT_DEFAULT;
+  IADC_AllConfigs_t initAllConfigs = IADC_ALLCONFIGS_DEFAULT;
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+  IADC_InitScan_t initScan = IADC_INITSCAN_DEFAULT;
+  IADC_ScanTable_t initScanTable = IADC_SCANTABLE_DEFAULT;
+#else
+  IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t initSingleInput = IADC_SINGLEINPUT_DEFAULT;
+#endif
+
+  // Reset IADC to reset configuration in case it has been modified
+  IADC_reset(IADC0);
+
+  // Warmup mode selected for the window configuration, see select_warmup()
+  // Reference: EFR32xG22 RM, Section 24.3.3.1
+  init.warmup = warmupModes[warmupMode].warmup;
+  iadcConfigured = true;
+
+  // Set the HFSCLK prescale value here
+  init.srcClkPrescale = srcClkPrescale;
 
   // Configuration 0 is used by both scan and single conversions by default
   // Use unbuffered AVDD as reference
-  initAllConfigs.configs[0].reference = iadcCfgReferenceVddx;
-
-  // Divides CLK_SRC_ADC to set the CLK_ADC frequency for desired sample rate
+  initAllConfigs.configs[0].reference = IADC_REFERENCE;
+  initAllConfigs.configs[0].vRef = IADC_REFERENCE_MV;
+  initAllConfigs.configs[0].analogGain = LE_VOLTAGE_MONITOR_CFG0_ANALOG_GAIN;
+
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  // Let the IADC accumulate the window: every trigger produces one result
+  // averaged over OSR * DIGAVG internal samples.
+  // Conversion Time = ((4 * OSR) + 2) * DIGAVG / fCLK_ADC, about 0.4 ms for
+  // the defaults, well below the window period.
+  initAllConfigs.configs[0].osrHighSpeed = LE_VOLTAGE_MONITOR_HW_AVG_OSR;
+#if defined(_IADC_CFG_DIGAVG_MASK)
+  initAllConfigs.configs[0].digAvg = LE_VOLTAGE_MONITOR_HW_AVG_DIGAVG;
+#endif
+#endif
+
+  // Divides CLK_SRC_ADC to set the CLK_ADC frequency, see CLK_ADC_FREQ
   // Default oversampling (OSR) is 2x, and Conversion Time = ((4 * OSR) + 2) / fCLK_ADC
-  initAllConfigs.configs[0].adcClkPrescale = IADC_calcAdcClkPrescale(IADC0,
-                                                                    CLK_ADC_FREQ,
-                                                                    0,
-                                                                    iadcCfgModeNormal,
-                                                                    init.srcClkPrescale);
+  initAllConfigs.configs[0].adcClkPrescale = adcClkPrescale;
+
+  // Configuration 1 measures the supplies against the internal reference,
+  // the divided AVDD would not fit below an AVDD reference
+  initAllConfigs.configs[1].reference = IADC_SUPPLY_REFERENCE;
+  initAllConfigs.configs[1].vRef = IADC_SUPPLY_REFERENCE_MV;
+  initAllConfigs.configs[1].osrHighSpeed = LE_VOLTAGE_MONITOR_CFG1_OSR;
+  initAllConfigs.configs[1].analogGain = LE_VOLTAGE_MONITOR_CFG1_ANALOG_GAIN;
+  initAllConfigs.configs[1].adcClkPrescale = initAllConfigs.configs[0].adcClkPrescale;
+
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+  // === PRS Connection Config =======
+  // On every trigger, convert the whole scan table once
+  initScan.triggerAction = iadcTriggerActionOnce;
 
+  // Set conversions to trigger from letimer/PRS
+  initScan.triggerSelect = iadcTriggerSelPrs0PosEdge;
+
+  // Oversampled results are read with 16-bit resolution
+  initScan.alignment = IADC_ALIGNMENT;
+
+  // === LDMA Connection Config ======
+  // Wake up the DMA when FIFO is filled
+  initScan.fifoDmaWakeup = true;
+
+  // Set how many elements in FIFO will generate DMA request. The results of a
+  // scan are moved one by one, in table order.
+  initScan.dataValidLevel = iadcFifoCfgDvl1;
+
+  // === Pin Input Config ============
+  // One single ended entry per channel
+  LE_VOLTAGE_MONITOR_CHANNELS(CHANNEL_SCAN_ENTRY)
+
+  // Allocate the analog bus for IADC0 inputs
+  LE_VOLTAGE_MONITOR_CHANNELS(CHANNEL_BUS_ALLOC)
+
+  // Initialize IADC
+  IADC_init(IADC0, &init, &initAllConfigs);
+
+  // Initialize Scan
+  IADC_initScan(IADC0, &initScan, &initScanTable);
+#else
   // === PRS Connection Config =======
   // On every trigger, start conversion
   initSingle.triggerAction = iadcTriggerActionOnce;
@@ -387,6 +1875,9 @@ static void init_iadc(void)
   // Set conversions to trigger from letimer/PRS
   initSingle.triggerSelect = iadcTriggerSelPrs0PosEdge;
 
+  // Oversampled results are read with 16-bit resolution
+  initSingle.alignment = IADC_ALIGNMENT;
+
   // === LDMA Connection Config ======
   // Wake up the DMA when FIFO is filled
   initSingle.fifoDmaWakeup = true;
@@ -396,17 +1887,51 @@ static void init_iadc(void)
 
   // === Pin Input Config ============
   // Configure Input sources for single ended conversion
-  initSingleInput.posInput = IADC_INPUT_POS;
+  initSingleInput.posInput = channels[0].pos_input;
   initSingleInput.negInput = IADC_INPUT_NEG;
 
-  // Allocate the analog bus for IADC0 input
-  GPIO->IADC_INPUT_BUS |= IADC_INPUT_BUSALLOC;
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  // === Window Comparator Config ====
+  // Match outside of the band, i.e. on leaving it
+  initSingleInput.compare = true;
+  init.greaterThanEqualThres = calc_compare_code(LE_VOLTAGE_MONITOR_ALARM_HIGH_MV);
+  init.lessThanEqualThres = calc_compare_code(LE_VOLTAGE_MONITOR_ALARM_LOW_MV);
+#elif CAPTURE_COMPARATOR
+  // An armed capture is triggered by the input leaving the capture band
+  if(captureState == LE_VOLTAGE_MONITOR_CAPTURE_ARMED) {
+    initSingleInput.compare = true;
+    init.greaterThanEqualThres = calc_compare_code(LE_VOLTAGE_MONITOR_CAPTURE_HIGH_MV);
+    init.lessThanEqualThres = calc_compare_code(LE_VOLTAGE_MONITOR_CAPTURE_LOW_MV);
+  }
+#endif
+
+  // Allocate the analog bus for IADC0 input, entry 0 only
+  LE_VOLTAGE_MONITOR_CHANNELS(CHANNEL_BUS_ALLOC)
 
   // Initialize IADC
   IADC_init(IADC0, &init, &initAllConfigs);
 
   // Initialize Single
   IADC_initSingle(IADC0, &initSingle, &initSingleInput);
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+  // Interrupt on every comparator match, the LDMA keeps draining the FIFO
+  IADC_clearInt(IADC0, _IADC_IF_MASK);
+  IADC_enableInt(IADC0, IADC_IEN_SINGLECMP);
+
+  NVIC_ClearPendingIRQ(IADC_IRQn);
+  NVIC_EnableIRQ(IADC_IRQn);
+#elif CAPTURE_COMPARATOR
+  // Only the first match counts, see capture_trigger()
+  if(captureState == LE_VOLTAGE_MONITOR_CAPTURE_ARMED) {
+    IADC_clearInt(IADC0, _IADC_IF_MASK);
+    IADC_enableInt(IADC0, IADC_IEN_SINGLECMP);
+
+    NVIC_ClearPendingIRQ(IADC_IRQn);
+    NVIC_EnableIRQ(IADC_IRQn);
+  }
+#endif
+#endif
 }
 
 
@@ -422,11 +1947,36 @@ static void init_ldma(void)
   // Initialize LDMA
   LDMA_Init(&init);
 
-  // Number of DMA transfers
-  descriptor.xfer.xferCnt = NUM_OF_SAMPLES;
+  // Every result is stored as a halfword, the FIFO read pops it all the same
+  for(uint32_t i = 0; i < NUM_OF_BUFFERS; i++) {
+    descriptor[i].xfer.size = ldmaCtrlSizeHalf;
+  }
+
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  // The waveform is read sample after sample instead of the FIFO, from
+  // where restart_synthetic() points each descriptor, a whole scan per
+  // LETIMER0 period
+  for(uint32_t i = 0; i < NUM_OF_BUFFERS; i++) {
+    descriptor[i].xfer.srcInc = ldmaCtrlSrcIncOne;
+    descriptor[i].xfer.blockSize = LE_VOLTAGE_MONITOR_NUM_CHANNELS - 1;
+  }
+#endif
+
+  // Trigger interrupt whenever one of the sampling buffers is filled, unless
+  // only the comparator is meant to wake the CPU.
+  // The transfer count is set by apply_config() (xferCnt holds the number of
+  // transfers minus one).
+  for(uint32_t i = 0; i < NUM_OF_BUFFERS; i++) {
+    descriptor[i].xfer.doneIfs = !LE_VOLTAGE_MONITOR_ALARM_ENABLE;
+  }
 
-  // Trigger interrupt when samplingBuffer is filled
-  descriptor.xfer.doneIfs = true;
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  // The capture blocks interrupt to track the position of the ring
+  for(uint32_t i = 0; i < CAPTURE_BLOCKS; i++) {
+    captureDescriptor[i].xfer.size = ldmaCtrlSizeHalf;
+    captureDescriptor[i].xfer.doneIfs = true;
+  }
+#endif
 
   // Enable LDMA Interrupt
   NVIC_ClearPendingIRQ(LDMA_IRQn);
@@ -445,15 +1995,544 @@ void LDMA_IRQHandler(void)
   // Clear interrupts
   LDMA_IntClear(LDMA_IntGet());
 
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  // The channel fills the capture ring instead of windows
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    capture_block_done();
+    return;
+  }
+#endif
+
+#if LE_TRACE_ENABLE
+  le_trace_record(LE_TRACE_ISR_ENTRY);
+#endif
+
+  // Hand the filled buffer over to the application. When the main loop is so
+  // late that the ring is full the window is dropped, and it shows up as a
+  // gap in the sequence numbers.
+  {
+    uint32_t sequence = completedSequence + 1;
+    uint8_t head = windowHead;
+
+    if((uint8_t)(head - windowTail) < WINDOW_RING_SIZE) {
+      monitor_window_t *window = &arena.windows[head % WINDOW_RING_SIZE];
+
+      window->sequence = sequence;
+      window->tick = sl_sleeptimer_get_tick_count();
+      window->buffer = fillingBuffer;
+
+      // Publish the descriptor before the index
+      __DMB();
+      windowHead = head + 1;
+    }
+    completedSequence = sequence;
+  }
+
+#if LE_VOLTAGE_MONITOR_SYNTHETIC_ENABLE
+  advance_synthetic(fillingBuffer);
+#endif
+
+#if (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_PING_PONG)
+  // The LDMA has already linked to the next buffer, keep LETIMER0 and the
+  // IADC running so no samples are lost between windows.
+  fillingBuffer = (fillingBuffer + 1) % NUM_OF_BUFFERS;
+#elif (LE_VOLTAGE_MONITOR_ACQ_MODE == LE_VOLTAGE_MONITOR_ACQ_HW_AVERAGE)
+  // The descriptor links to itself, the next window's trigger simply delivers
+  // the next averaged result.
+#else
   // Stop timer
   LETIMER_Enable(LETIMER0, false);
 
   // Stop ADC
-  IADC_command(IADC0, iadcCmdStopSingle);
+  IADC_command(IADC0, IADC_CMD_STOP);
 
-  // Signal ble stack that LDMA has finished
-  sl_bt_external_signal(LE_MONITOR_SIGNAL);
+  // The window is complete, the sensor is not needed until the next one
+  sensor_power_off();
 
   // Set flag to indicate sampling finished
   startedSampling = false;
+#endif
+
+  // Signal ble stack that LDMA has finished
+  sl_bt_external_signal(LE_MONITOR_SIGNAL);
+}
+
+
+#if LE_VOLTAGE_MONITOR_ALARM_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Get the alarm state.
+ ******************************************************************************/
+uint8_t le_voltage_monitor_get_alarm(uint16_t *mv)
+{
+  uint8_t state;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  state = alarmState;
+  *mv = alarmMv;
+  CORE_EXIT_ATOMIC();
+
+  return state;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    IADC Interrupt Handler, raised by window comparator matches.
+ ******************************************************************************/
+void IADC_IRQHandler(void)
+{
+  IADC_clearInt(IADC0, IADC_IF_SINGLECMP);
+
+  // The most recent result, the FIFO itself belongs to the LDMA
+  alarmMv = convert_code_to_mv(remove_code_offset(IADC_readSingleData(IADC0)));
+
+  if(alarmState == LE_VOLTAGE_MONITOR_ALARM_NONE) {
+    alarmState = (alarmMv < ((LE_VOLTAGE_MONITOR_ALARM_LOW_MV + LE_VOLTAGE_MONITOR_ALARM_HIGH_MV) / 2))
+                 ? LE_VOLTAGE_MONITOR_ALARM_LOW : LE_VOLTAGE_MONITOR_ALARM_HIGH;
+
+    // Wait for the return into the band, less the hysteresis
+    set_compare_window(LE_VOLTAGE_MONITOR_ALARM_LOW_MV + LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV,
+                       LE_VOLTAGE_MONITOR_ALARM_HIGH_MV - LE_VOLTAGE_MONITOR_ALARM_HYSTERESIS_MV);
+  } else {
+    alarmState = LE_VOLTAGE_MONITOR_ALARM_NONE;
+
+    // Wait for leaving the band again
+    set_compare_window(LE_VOLTAGE_MONITOR_ALARM_HIGH_MV, LE_VOLTAGE_MONITOR_ALARM_LOW_MV);
+  }
+
+  // Signal ble stack that the alarm state changed
+  sl_bt_external_signal(LE_MONITOR_ALARM_SIGNAL);
+}
+#endif
+
+
+#if LE_VOLTAGE_MONITOR_PROFILE_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Get the CPU cycles spent reducing a window.
+ ******************************************************************************/
+void le_voltage_monitor_get_profile(uint32_t *last_cycles, uint32_t *max_cycles)
+{
+  *last_cycles = reduceCycles;
+  *max_cycles = reduceCyclesMax;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the largest cycle count.
+ ******************************************************************************/
+void le_voltage_monitor_reset_profile(void)
+{
+  reduceCyclesMax = 0;
+}
+#endif
+
+
+#if LE_VOLTAGE_MONITOR_CAL_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Load the stored calibration if it was taken with the same settings.
+ ******************************************************************************/
+static bool load_calibration(void)
+{
+  uint8_t cal[CAL_SIZE];
+  uint32_t type;
+  size_t len;
+  uint16_t reference_mv;
+  uint16_t offset;
+
+  if((nvm3_getObjectInfo(nvm3_defaultHandle, LE_VOLTAGE_MONITOR_CAL_NVM3_KEY, &type, &len) != ECODE_NVM3_OK)
+     || (type != NVM3_OBJECTTYPE_DATA)
+     || (len != sizeof(cal))
+     || (nvm3_readData(nvm3_defaultHandle, LE_VOLTAGE_MONITOR_CAL_NVM3_KEY, cal, len) != ECODE_NVM3_OK)
+     || (cal[0] != CAL_TAG)) {
+    return false;
+  }
+
+  reference_mv = (cal[1] << 8) | cal[2];
+  offset = (cal[3] << 8) | cal[4];
+  if((reference_mv < CAL_MIN_REFERENCE_MV)
+     || (reference_mv > CAL_MAX_REFERENCE_MV)
+     || (offset > CAL_MAX_OFFSET)) {
+    return false;
+  }
+
+  calReferenceMv = reference_mv;
+  calOffset = offset;
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Average software triggered conversions of one input.
+ ******************************************************************************/
+static uint32_t convert_calibration_input(IADC_PosInput_t pos_input,
+                                          IADC_CfgSelect_t config)
+{
+  IADC_InitSingle_t initSingle = IADC_INITSINGLE_DEFAULT;
+  IADC_SingleInput_t initSingleInput = IADC_SINGLEINPUT_DEFAULT;
+  uint32_t sum = 0;
+
+  // Same alignment as the sampled results, polled instead of moved by LDMA
+  initSingle.alignment = IADC_ALIGNMENT;
+  initSingle.triggerSelect = iadcTriggerSelImmediate;
+  initSingleInput.posInput = pos_input;
+  initSingleInput.negInput = iadcNegInputGnd;
+  initSingleInput.configId = config;
+  IADC_initSingle(IADC0, &initSingle, &initSingleInput);
+
+  for(uint32_t i = 0; i < LE_VOLTAGE_MONITOR_CAL_CONVERSIONS; i++) {
+    IADC_command(IADC0, iadcCmdStartSingle);
+    while(!(IADC0->STATUS & IADC_STATUS_SINGLEFIFODV)) {
+    }
+    sum += IADC_pullSingleFifoResult(IADC0).data;
+  }
+
+  return (sum + (LE_VOLTAGE_MONITOR_CAL_CONVERSIONS / 2)) / LE_VOLTAGE_MONITOR_CAL_CONVERSIONS;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Calibrate the sensor inputs and store the result.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_calibrate(void)
+{
+  uint8_t cal[CAL_SIZE];
+  uint32_t avdd_code;
+  uint32_t reference_mv;
+  uint32_t offset;
+
+  if(startedSampling) {
+    return SL_STATUS_INVALID_STATE;
+  }
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    return SL_STATUS_INVALID_STATE;
+  }
+#endif
+
+  // AVDD, the reference of configuration 0, through configuration 1 and the
+  // internal 1.21 V reference. Then the offset of configuration 0.
+  bring_up();
+  avdd_code = convert_calibration_input(avddChannel.pos_input, iadcCfgSelectCfg1);
+  offset = convert_calibration_input(iadcPosInputGnd, iadcCfgSelectCfg0);
+
+  // The PRS triggered conversions are set up again by the next bring-up
+  iadcConfigured = false;
+  tear_down();
+
+  reference_mv = (avdd_code * calc_range_mv(&avddChannel) + (IADC_FULL_SCALE / 2))
+                 / IADC_FULL_SCALE;
+  if((reference_mv < CAL_MIN_REFERENCE_MV)
+     || (reference_mv > CAL_MAX_REFERENCE_MV)
+     || (offset > CAL_MAX_OFFSET)) {
+    return SL_STATUS_FAIL;
+  }
+
+  calReferenceMv = (uint16_t)reference_mv;
+  calOffset = (uint16_t)offset;
+  apply_config();
+
+  cal[0] = CAL_TAG;
+  cal[1] = (calReferenceMv >> 8) & 0x00FF;
+  cal[2] = calReferenceMv & 0x00FF;
+  cal[3] = (calOffset >> 8) & 0x00FF;
+  cal[4] = calOffset & 0x00FF;
+
+  if(nvm3_writeData(nvm3_defaultHandle, LE_VOLTAGE_MONITOR_CAL_NVM3_KEY, cal, sizeof(cal)) != ECODE_NVM3_OK) {
+    return SL_STATUS_FAIL;
+  }
+  return SL_STATUS_OK;
+}
+#endif
+
+
+#if LE_VOLTAGE_MONITOR_CAPTURE_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Initialize LETimer for the capture: a conversion on every underflow and,
+ *    in gated mode, the sensor powered throughout.
+ ******************************************************************************/
+static void init_capture_letimer(void)
+{
+  LETIMER_Init_TypeDef init = LETIMER_INIT_DEFAULT;
+
+  init.repMode = letimerRepeatFree;
+  init.ufoa0 = letimerUFOAPulse;
+#if SENSOR_GATED
+  // Output 1 stays at its idle level, inverted it keeps the sensor on
+  init.ufoa1 = letimerUFOANone;
+  init.out1Pol = 1;
+#endif
+  init.topValue = calc_letimer_top(LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ, 1);
+  init.enable = false;
+  init.debugRun = true;
+
+  LETIMER_Init(LETIMER0, &init);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Stop the capture conversions and unclock the chain. Window sampling
+ *    configures it again on its next start.
+ ******************************************************************************/
+static void stop_capture(void)
+{
+  LETIMER_Enable(LETIMER0, false);
+  IADC_command(IADC0, iadcCmdStopSingle);
+  LDMA_StopTransfer(LDMA_CHANNEL);
+
+#if CAPTURE_COMPARATOR
+  IADC_disableInt(IADC0, IADC_IEN_SINGLECMP);
+#else
+  GPIO_IntDisable(CAPTURE_GPIO_MASK);
+#endif
+
+#if SENSOR_GATED
+  // Back to the window outputs, which leave the sensor off while stopped
+  init_letimer();
+#else
+  GPIO_PinOutClear(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+#endif
+
+  chainConfigured = false;
+  tear_down();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Number of samples written to the ring since arming. Called with
+ *    interrupts disabled or from an interrupt of the LDMA priority.
+ ******************************************************************************/
+static uint32_t capture_count(void)
+{
+  uint32_t blocks = captureBlocks;
+  uint32_t remaining = LDMA_TransferRemainingCount(LDMA_CHANNEL);
+
+  // A block completed but not handled yet. Unless the remaining count still
+  // shows its end, the channel has already linked to the next block.
+  if((LDMA_IntGet() & (1UL << LDMA_CHANNEL)) && (remaining != 0)) {
+    blocks++;
+  }
+  return (blocks * CAPTURE_BLOCK_SIZE) + (CAPTURE_BLOCK_SIZE - remaining);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Accept a trigger once the ring holds the pre-trigger samples.
+ *
+ * @return
+ *    True if the trigger has been accepted.
+ ******************************************************************************/
+static bool capture_trigger(void)
+{
+  uint32_t count;
+
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_ARMED) {
+    return false;
+  }
+
+  count = capture_count();
+  if(count < LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER) {
+    return false;
+  }
+
+  captureTriggerCount = count;
+  captureTriggerTick = sl_sleeptimer_get_tick_count();
+  captureState = LE_VOLTAGE_MONITOR_CAPTURE_TRIGGERED;
+
+  // Later matches or edges are of no interest
+#if CAPTURE_COMPARATOR
+  IADC_disableInt(IADC0, IADC_IEN_SINGLECMP);
+#else
+  GPIO_IntDisable(CAPTURE_GPIO_MASK);
+#endif
+  return true;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Account a completed block of the ring, freeze the ring once the
+ *    post-trigger samples are in.
+ ******************************************************************************/
+static void capture_block_done(void)
+{
+  captureBlocks++;
+
+  if((captureState == LE_VOLTAGE_MONITOR_CAPTURE_TRIGGERED)
+     && ((captureBlocks * CAPTURE_BLOCK_SIZE)
+         >= (captureTriggerCount + LE_VOLTAGE_MONITOR_CAPTURE_POST_TRIGGER))) {
+    stop_capture();
+    captureState = LE_VOLTAGE_MONITOR_CAPTURE_DONE;
+
+    // Signal ble stack that the capture can be read
+    sl_bt_external_signal(LE_MONITOR_CAPTURE_SIGNAL);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Suspend window sampling and arm the transient capture.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_capture_arm(void)
+{
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_IDLE) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  // Every sample has to be converted within its period
+  if((IADC_WARMUP_US + calc_conversion_us()) >= (1000000UL / LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ)) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+
+  le_voltage_monitor_stop();
+
+  captureBlocks = 0;
+  captureState = LE_VOLTAGE_MONITOR_CAPTURE_ARMED;
+
+  // The window configuration of the chain is replaced until the release
+  bring_up();
+  init_capture_letimer();
+  init_iadc();
+
+#if !CAPTURE_COMPARATOR
+#if LE_VOLTAGE_MONITOR_CAPTURE_GPIO_FALLING
+  GPIO_PinModeSet(LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PORT, LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN, gpioModeInputPull, 1);
+#else
+  GPIO_PinModeSet(LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PORT, LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN, gpioModeInputPull, 0);
+#endif
+  GPIO_ExtIntConfig(LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PORT,
+                    LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN,
+                    LE_VOLTAGE_MONITOR_CAPTURE_GPIO_PIN,
+                    !LE_VOLTAGE_MONITOR_CAPTURE_GPIO_FALLING,
+                    LE_VOLTAGE_MONITOR_CAPTURE_GPIO_FALLING,
+                    true);
+  NVIC_ClearPendingIRQ(CAPTURE_GPIO_IRQn);
+  NVIC_EnableIRQ(CAPTURE_GPIO_IRQn);
+#endif
+
+#if !SENSOR_GATED
+  GPIO_PinOutSet(SENSOR_POWER_PORT, SENSOR_POWER_PIN);
+#endif
+
+  IADC_command(IADC0, iadcCmdStartSingle);
+  LETIMER_Enable(LETIMER0, true);
+  LDMA_StartTransfer(LDMA_CHANNEL, &captureXferCfg, &captureDescriptor[0]);
+
+  return SL_STATUS_OK;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Trigger the armed capture from software.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_capture_trigger(void)
+{
+  sl_status_t status = SL_STATUS_OK;
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if(captureState != LE_VOLTAGE_MONITOR_CAPTURE_ARMED) {
+    status = SL_STATUS_INVALID_STATE;
+  } else if(!capture_trigger()) {
+    status = SL_STATUS_NOT_READY;
+  }
+  CORE_EXIT_ATOMIC();
+
+  return status;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the state of the transient capture.
+ ******************************************************************************/
+uint8_t le_voltage_monitor_capture_get_state(le_voltage_monitor_capture_t *capture)
+{
+  capture->sampling_freq_hz = LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ;
+  capture->pre_trigger = LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER;
+  capture->length = CAPTURE_LENGTH;
+  capture->tick = captureTriggerTick;
+
+  return captureState;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Read samples of the completed capture in millivolts.
+ ******************************************************************************/
+size_t le_voltage_monitor_capture_read(uint32_t offset, uint16_t *mv, size_t count)
+{
+  // Sample count of the oldest pre-trigger sample, its ring index modulo
+  // the ring size
+  uint32_t first = captureTriggerCount - LE_VOLTAGE_MONITOR_CAPTURE_PRE_TRIGGER;
+
+  if((captureState != LE_VOLTAGE_MONITOR_CAPTURE_DONE) || (offset >= CAPTURE_LENGTH)) {
+    return 0;
+  }
+
+  if(count > (CAPTURE_LENGTH - offset)) {
+    count = CAPTURE_LENGTH - offset;
+  }
+  for(size_t i = 0; i < count; i++) {
+    uint16_t raw = arena.capture[(first + offset + i) % LE_VOLTAGE_MONITOR_CAPTURE_SAMPLES];
+
+    mv[i] = convert_code_to_mv(remove_code_offset(raw));
+  }
+  return count;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort or release the capture, window sampling may start again.
+ ******************************************************************************/
+void le_voltage_monitor_capture_release(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  CORE_ENTER_ATOMIC();
+  if((captureState == LE_VOLTAGE_MONITOR_CAPTURE_ARMED)
+     || (captureState == LE_VOLTAGE_MONITOR_CAPTURE_TRIGGERED)) {
+    stop_capture();
+  }
+  captureState = LE_VOLTAGE_MONITOR_CAPTURE_IDLE;
+  CORE_EXIT_ATOMIC();
+}
+
+
+#if CAPTURE_COMPARATOR
+/***************************************************************************//**
+ * @brief
+ *    IADC Interrupt Handler, raised by window comparator matches of an armed
+ *    capture.
+ ******************************************************************************/
+void IADC_IRQHandler(void)
+{
+  IADC_clearInt(IADC0, IADC_IF_SINGLECMP);
+  (void)capture_trigger();
+}
+#else
+/***************************************************************************//**
+ * @brief
+ *    GPIO Interrupt Handler of the capture trigger pin.
+ ******************************************************************************/
+void CAPTURE_GPIO_IRQHandler(void)
+{
+  GPIO_IntClear(GPIO_IntGet() & CAPTURE_GPIO_MASK);
+  (void)capture_trigger();
 }
+#endif
+#endif
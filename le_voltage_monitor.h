@@ -39,6 +39,10 @@
 #define LE_VOLTAGE_MONITOR_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sl_status.h"
+#include "le_voltage_monitor_config.h"
 
 /***************************************************************************//**
  * @brief
@@ -48,18 +52,103 @@
 
 /***************************************************************************//**
  * @brief
- *    Number of samples to measure before calculating the average and notifying
- *    the connected device.
+ *    External signal bit mask of alarm state changes.
+ ******************************************************************************/
+#define LE_MONITOR_ALARM_SIGNAL   0x02
+
+/***************************************************************************//**
+ * @brief
+ *    Alarm states of the sensor input.
+ ******************************************************************************/
+#define LE_VOLTAGE_MONITOR_ALARM_NONE   0x00  ///< Inside the band
+#define LE_VOLTAGE_MONITOR_ALARM_LOW    0x01  ///< Below the low threshold
+#define LE_VOLTAGE_MONITOR_ALARM_HIGH   0x02  ///< Above the high threshold
+
+/***************************************************************************//**
+ * @brief
+ *    External signal bit mask of a completed transient capture.
+ ******************************************************************************/
+#define LE_MONITOR_CAPTURE_SIGNAL   0x04
+
+/***************************************************************************//**
+ * @brief
+ *    Transient capture states.
+ ******************************************************************************/
+#define LE_VOLTAGE_MONITOR_CAPTURE_IDLE       0x00  ///< Window sampling
+#define LE_VOLTAGE_MONITOR_CAPTURE_ARMED      0x01  ///< Filling the ring, waiting for a trigger
+#define LE_VOLTAGE_MONITOR_CAPTURE_TRIGGERED  0x02  ///< Recording the post-trigger samples
+#define LE_VOLTAGE_MONITOR_CAPTURE_DONE       0x03  ///< Frozen until released
+
+/***************************************************************************//**
+ * @brief
+ *    Default number of samples to measure before calculating the average and
+ *    notifying the connected device.
  ******************************************************************************/
 #define NUM_OF_SAMPLES        128
 
 /***************************************************************************//**
  * @brief
- *    Sampling frequency of the voltage reading. (Frequency that device will be
- *    notified)
+ *    Default sampling frequency of the voltage reading.
  ******************************************************************************/
 #define SAMPLING_FREQ_HZ      50
 
+/***************************************************************************//**
+ * @brief
+ *    Number of inputs converted per trigger.
+ ******************************************************************************/
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+#define LE_VOLTAGE_MONITOR_NUM_CHANNELS   LE_VOLTAGE_MONITOR_SCAN_NUM_CHANNELS
+#else
+#define LE_VOLTAGE_MONITOR_NUM_CHANNELS   1
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Summary of one completed window. The statistics are the ones of the
+ *    sensor input, channel 0.
+ ******************************************************************************/
+typedef struct {
+  uint16_t avg_mv;  ///< Average voltage in millivolts
+  uint16_t min_mv;  ///< Lowest sample in millivolts
+  uint16_t max_mv;  ///< Highest sample in millivolts
+  uint16_t rms_mv;  ///< Root mean square of the samples in millivolts
+  uint32_t stddev_uv;  ///< Standard deviation (square root of the variance) in microvolts
+  uint16_t running_mv;  ///< Single-pole IIR estimate over the window averages in millivolts
+  uint32_t tick;        ///< Sleeptimer tick count when the window completed
+  uint16_t overruns;    ///< Windows lost since the previously delivered one
+  uint32_t sequence;    ///< Counts every completed window since boot
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+  uint16_t channel_mv[LE_VOLTAGE_MONITOR_NUM_CHANNELS];  ///< Average of every scan channel
+#endif
+} le_voltage_monitor_summary_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    IADC operating point: warmup mode, clock prescalers and the estimated
+ *    charge of one trigger period.
+ ******************************************************************************/
+typedef struct {
+  uint8_t warmup;             ///< LE_VOLTAGE_MONITOR_WARMUP_NORMAL, _STANDBY or _KEEP_WARM
+  uint8_t src_clk_prescale;   ///< CLK_SRC_ADC is the IADC clock divided by this plus one
+  uint16_t adc_clk_prescale;  ///< CLK_ADC is CLK_SRC_ADC divided by this plus one
+  uint32_t clk_adc_hz;        ///< CLK_ADC frequency
+  uint32_t trigger_us;        ///< Warmup and conversions of one trigger
+  uint32_t charge_pc;         ///< Estimated IADC charge per trigger period in picocoulombs
+} le_voltage_monitor_operating_point_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Layout of a transient capture.
+ ******************************************************************************/
+typedef struct {
+  uint16_t sampling_freq_hz;  ///< Capture sampling frequency
+  uint16_t pre_trigger;       ///< Samples ahead of the trigger
+  uint16_t length;            ///< Samples of a completed capture
+  uint32_t tick;              ///< Sleeptimer tick count of the trigger
+} le_voltage_monitor_capture_t;
+
 
 /***************************************************************************//**
  * @brief
@@ -81,8 +170,7 @@ void le_voltage_monitor_init(void);
 
 /***************************************************************************//**
  * @brief
- *    Gets the average millivoltage of the samples taken between complete LDMA
- *    transfers.
+ *    Gets the average millivoltage of the most recently delivered window.
  *
  * @return
  *    Average voltage in millivolts
@@ -90,9 +178,54 @@ void le_voltage_monitor_init(void);
 uint16_t le_voltage_monitor_get_average_mv(void);
 
 
+/***************************************************************************//**
+ * @brief
+ *    Gets the summary of the most recently delivered window again.
+ *
+ * @param[out] summary
+ *    Summary returned by the last successful le_voltage_monitor_next_summary().
+ ******************************************************************************/
+void le_voltage_monitor_get_summary(le_voltage_monitor_summary_t *summary);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Reduce the next completed window: average, minimum, maximum, RMS and
+ *    standard deviation of its samples, in a single pass.
+ *
+ * @details
+ *    The LDMA interrupt queues a descriptor of every completed window and
+ *    raises LE_MONITOR_SIGNAL. Windows whose buffer has been refilled in the
+ *    meantime are skipped and counted in the overruns of the next delivered
+ *    summary, so no window is ever reduced twice or from torn data.
+ *
+ * @note
+ *    Call it until it returns false on every LE_MONITOR_SIGNAL. In continuous
+ *    mode the buffer of a window is refilled once
+ *    LE_VOLTAGE_MONITOR_NUM_BUFFERS - 1 later windows have completed, in the
+ *    other modes once the next one has.
+ *
+ * @note
+ *    In hardware averaging mode every window holds a single result, so the
+ *    minimum, maximum and RMS equal the average and the deviation is 0.
+ *
+ * @param[out] summary
+ *    Summary of the window, possibly filtered in place.
+ *
+ * @return
+ *    True if a window was delivered, false if none is pending.
+ ******************************************************************************/
+bool le_voltage_monitor_next_summary(le_voltage_monitor_summary_t *summary);
+
+
 /***************************************************************************//**
  * @brief
  *    Starts the peripherals to begin sampling until internal buffer is filled.
+ *
+ * @note
+ *    In continuous and hardware averaging modes the peripherals keep running
+ *    once started, so calling this function again after every window has no
+ *    effect.
  ******************************************************************************/
 void le_voltage_monitor_start_next(void);
 
@@ -100,7 +233,258 @@ void le_voltage_monitor_start_next(void);
 /***************************************************************************//**
  * @brief
  *    Stops the sampling.
+ *
+ * @details
+ *    The LETIMER0, IADC0 and LDMA clocks are disabled until the next
+ *    le_voltage_monitor_start_next(). Their configuration is kept, restarting
+ *    only enables the clocks again.
  ******************************************************************************/
 void le_voltage_monitor_stop(void);
 
+
+/***************************************************************************//**
+ * @brief
+ *    Change the sampling frequency and the number of samples per window.
+ *
+ * @details
+ *    When called while sampling, the new configuration is applied by the next
+ *    le_voltage_monitor_start_next() call, i.e. between two windows.
+ *
+ * @param[in] sampling_freq_hz
+ *    Sampling frequency, 1 to LE_VOLTAGE_MONITOR_MAX_SAMPLING_FREQ_HZ.
+ *
+ * @param[in] num_of_samples
+ *    Samples per window, 1 to LE_VOLTAGE_MONITOR_MAX_SAMPLES.
+ *
+ * @return
+ *    SL_STATUS_OK, or SL_STATUS_INVALID_PARAMETER if out of range.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_set_config(uint16_t sampling_freq_hz,
+                                          uint16_t num_of_samples);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the window configuration, including a pending one.
+ *
+ * @param[out] sampling_freq_hz
+ *    Sampling frequency.
+ *
+ * @param[out] num_of_samples
+ *    Samples per window.
+ ******************************************************************************/
+void le_voltage_monitor_get_config(uint16_t *sampling_freq_hz,
+                                   uint16_t *num_of_samples);
+
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get how long the sensor is powered during one window of the active
+ *    configuration.
+ *
+ * @return
+ *    Sensor power-on time per window in microseconds.
+ ******************************************************************************/
+uint32_t le_voltage_monitor_get_sensor_on_us(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the IADC operating point of the active window configuration.
+ *
+ * @details
+ *    The CLK_ADC runs at its maximum, the shortest conversion spends the
+ *    least charge. With LE_VOLTAGE_MONITOR_WARMUP_AUTO the warmup mode with
+ *    the least estimated charge per trigger period is selected whenever the
+ *    window configuration is applied.
+ *
+ * @param[out] point
+ *    Operating point, valid after le_voltage_monitor_init().
+ ******************************************************************************/
+void le_voltage_monitor_get_operating_point(le_voltage_monitor_operating_point_t *point);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the timing of the active window configuration in LETIMER0 ticks.
+ *
+ * @param[out] trigger_ticks
+ *    Ticks from one IADC trigger to the next.
+ *
+ * @param[out] window_ticks
+ *    Ticks from the completion of one window to the next while sampling
+ *    continues.
+ ******************************************************************************/
+void le_voltage_monitor_get_ticks(uint32_t *trigger_ticks, uint32_t *window_ticks);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the bytes of the acquisition arena taken by the buffers of this
+ *    build, at most LE_VOLTAGE_MONITOR_ARENA_SIZE.
+ ******************************************************************************/
+size_t le_voltage_monitor_get_arena_usage(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Lengthen or shorten the trigger period in progress, which moves all
+ *    following triggers and window completions, e.g. to align the windows to
+ *    a time base.
+ *
+ * @details
+ *    The LETIMER0 counter is moved by at most half a trigger period, and
+ *    never past the compare matches ahead of the underflow. Best called
+ *    right after a window completed. The top value is left as is.
+ *
+ * @param[in] ticks
+ *    LETIMER0 ticks to add to the period, negative to shorten it.
+ *
+ * @return
+ *    Ticks added, 0 if not sampling windows or too late in the period.
+ ******************************************************************************/
+int32_t le_voltage_monitor_trim(int32_t ticks);
+
+
+
+/***************************************************************************//**
+ * @brief
+ *    Calibrate the sensor inputs and store the result in NVM3.
+ *
+ * @details
+ *    AVDD, the reference of the sensor inputs, is measured against the
+ *    internal 1.21 V reference and the offset on a grounded input. The
+ *    millivolt scaling of the sensor inputs uses both from then on.
+ *    le_voltage_monitor_init() calls it on the first boot only, later boots
+ *    load the stored result.
+ *
+ * @note
+ *    Only available with LE_VOLTAGE_MONITOR_CAL_ENABLE. Must not be called
+ *    while sampling.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_STATE while sampling, or SL_STATUS_FAIL
+ *    if the result is implausible or could not be stored.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_calibrate(void);
+
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the alarm state and the conversion that caused its last change.
+ *
+ * @note
+ *    Only available with LE_VOLTAGE_MONITOR_ALARM_ENABLE. State changes are
+ *    signalled with LE_MONITOR_ALARM_SIGNAL.
+ *
+ * @param[out] mv
+ *    Sensor input voltage in millivolts.
+ *
+ * @return
+ *    LE_VOLTAGE_MONITOR_ALARM_NONE, _LOW or _HIGH.
+ ******************************************************************************/
+uint8_t le_voltage_monitor_get_alarm(uint16_t *mv);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Arm the transient capture.
+ *
+ * @details
+ *    Window sampling is stopped and the sensor input is sampled at
+ *    LE_VOLTAGE_MONITOR_CAPTURE_FREQ_HZ into a ring by a circular LDMA
+ *    descriptor chain. The first trigger once the ring holds the pre-trigger
+ *    samples is accepted, the window comparator or the GPIO edge wakes the
+ *    CPU for it. The ring is frozen once the post-trigger samples are in,
+ *    which is signalled with LE_MONITOR_CAPTURE_SIGNAL.
+ *    le_voltage_monitor_start_next() has no effect until the capture is
+ *    released.
+ *
+ * @note
+ *    Only available with LE_VOLTAGE_MONITOR_CAPTURE_ENABLE.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_STATE if not idle, or
+ *    SL_STATUS_NOT_SUPPORTED if a conversion takes longer than a capture
+ *    sampling period.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_capture_arm(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Trigger the armed capture from software.
+ *
+ * @return
+ *    SL_STATUS_OK, SL_STATUS_INVALID_STATE if not armed, or
+ *    SL_STATUS_NOT_READY while the ring does not hold the pre-trigger samples
+ *    yet.
+ ******************************************************************************/
+sl_status_t le_voltage_monitor_capture_trigger(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the state and the layout of the transient capture.
+ *
+ * @param[out] capture
+ *    Layout, the tick is valid once triggered.
+ *
+ * @return
+ *    LE_VOLTAGE_MONITOR_CAPTURE_IDLE, _ARMED, _TRIGGERED or _DONE.
+ ******************************************************************************/
+uint8_t le_voltage_monitor_capture_get_state(le_voltage_monitor_capture_t *capture);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Read samples of the completed capture.
+ *
+ * @param[in] offset
+ *    First sample, counted from the oldest pre-trigger sample.
+ *
+ * @param[out] mv
+ *    Samples in millivolts.
+ *
+ * @param[in] count
+ *    Samples to read at most.
+ *
+ * @return
+ *    Samples read, 0 past the end or unless the capture is done.
+ ******************************************************************************/
+size_t le_voltage_monitor_capture_read(uint32_t offset, uint16_t *mv, size_t count);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Abort the capture or release the completed one. Window sampling resumes
+ *    on the next le_voltage_monitor_start_next().
+ ******************************************************************************/
+void le_voltage_monitor_capture_release(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the CPU cycles spent reducing a window.
+ *
+ * @note
+ *    Only available with LE_VOLTAGE_MONITOR_PROFILE_ENABLE.
+ *
+ * @param[out] last_cycles
+ *    Cycles of the most recent window.
+ *
+ * @param[out] max_cycles
+ *    Largest cycle count since the last reset.
+ ******************************************************************************/
+void le_voltage_monitor_get_profile(uint32_t *last_cycles, uint32_t *max_cycles);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Clear the largest cycle count.
+ ******************************************************************************/
+void le_voltage_monitor_reset_profile(void);
+
 #endif /* LE_VOLTAGE_MONITOR_H_ */
@@ -0,0 +1,653 @@
+/***************************************************************************//**
+* @file le_voltage_report.c
+* @brief Voltage report batching definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_voltage_report.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "le_byte_order.h"
+
+/***************************************************************************//**
+ * @brief
+ *    ATT notification header: opcode and attribute handle.
+ ******************************************************************************/
+#define ATT_NOTIFICATION_HEADER_SIZE   3
+
+#if LE_VOLTAGE_REPORT_BATCHING_ENABLE
+#define RING_SIZE                      LE_VOLTAGE_REPORT_MAX_BATCH
+#else
+#define RING_SIZE                      1
+#endif
+
+// The compressed format is only used for batches
+#if LE_VOLTAGE_REPORT_BATCHING_ENABLE \
+  && (LE_VOLTAGE_REPORT_FORMAT == LE_VOLTAGE_REPORT_FORMAT_COMPRESSED)
+#define COMPRESSED                     1
+#else
+#define COMPRESSED                     0
+#endif
+
+#if COMPRESSED && LE_VOLTAGE_REPORT_MIN_MAX_ENABLE
+#error "The compressed payload format carries averages only"
+#endif
+
+#if COMPRESSED && LE_VOLTAGE_MONITOR_SCAN_ENABLE
+#error "The compressed payload format carries a single channel only"
+#endif
+
+#if COMPRESSED && (LE_VOLTAGE_REPORT_MAX_BATCH > LE_VOLTAGE_REPORT_HDR_MAX_COUNT)
+#error "LE_VOLTAGE_REPORT_MAX_BATCH exceeds the compressed sample count"
+#endif
+
+// Typical size of a timestamp delta, windows of 128 ms to 16 s. Only used to
+// size the batches.
+#define TIMESTAMP_TYPICAL_DELTA_SIZE   2
+
+
+/***************************************************************************//**
+ * @brief
+ *    Private globals.
+ ******************************************************************************/
+// Queued window summaries, oldest at ringTail
+static le_voltage_monitor_summary_t ring[RING_SIZE];
+static uint16_t ringTail = 0;
+static uint16_t ringCount = 0;
+
+// Number of entries that make a batch ready on the current connection
+static uint16_t batchDepth = 1;
+
+// Largest notification payload on the current connection
+static uint16_t payloadLimit = LE_VOLTAGE_REPORT_ENTRY_SIZE;
+
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+// Completion ticks of the queued summaries being encoded, oldest first
+static uint32_t batchTicks[RING_SIZE];
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Convert a number of sleeptimer ticks to a timestamp delta in
+ *    milliseconds, saturated to the varint range.
+ ******************************************************************************/
+static uint32_t ticks_to_delta_ms(uint32_t ticks, uint32_t freq_hz)
+{
+  uint64_t ms = ((uint64_t)ticks * 1000) / freq_hz;
+
+  if(ms > LE_VOLTAGE_REPORT_TIMESTAMP_MAX_DELTA_MS) {
+    ms = LE_VOLTAGE_REPORT_TIMESTAMP_MAX_DELTA_MS;
+  }
+  return (uint32_t)ms;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Size of a timestamp delta varint.
+ ******************************************************************************/
+static size_t varint_size(uint32_t value)
+{
+  if(value < 0x80) {
+    return 1;
+  }
+  if(value < 0x4000) {
+    return 2;
+  }
+  return 3;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Append a timestamp delta varint.
+ ******************************************************************************/
+static uint8_t *put_varint(uint8_t *p, uint32_t value)
+{
+  while(value >= 0x80) {
+    *p++ = (uint8_t)((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  *p++ = (uint8_t)value;
+  return p;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Summary of a run, counted from the oldest one.
+ ******************************************************************************/
+static const le_voltage_monitor_summary_t *run_entry(const le_voltage_report_run_t *run,
+                                                     uint16_t index)
+{
+  return &run->entries[(run->start + index) % run->size];
+}
+
+
+#if LE_VOLTAGE_REPORT_SEQUENCE_ENABLE
+/***************************************************************************//**
+ * @brief
+ *    Number of summaries at the start of a run numbered without a gap, the
+ *    receiver numbers the windows of a payload from the first one.
+ ******************************************************************************/
+static uint16_t consecutive(const le_voltage_report_run_t *run, uint16_t count)
+{
+  uint16_t n = 1;
+
+  while((n < count)
+        && (run_entry(run, n)->sequence == (run_entry(run, n - 1)->sequence + 1))) {
+    n++;
+  }
+  return n;
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Drop summaries that have been encoded.
+ ******************************************************************************/
+static void ring_consume(uint16_t entries)
+{
+  ringTail = (ringTail + entries) % RING_SIZE;
+  ringCount -= entries;
+}
+
+
+#if !COMPRESSED
+/***************************************************************************//**
+ * @brief
+ *    Raw encoder: big-endian 16-bit entries behind the optional timestamp
+ *    block.
+ ******************************************************************************/
+static size_t encode_raw(const le_voltage_report_run_t *run, uint16_t entries,
+                         const le_voltage_report_clock_t *clock,
+                         uint8_t *buf, size_t limit, uint16_t *encoded)
+{
+  uint8_t *p = buf;
+
+  *encoded = 0;
+
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  {
+    uint32_t now = (uint32_t)clock->now;
+    size_t stamps = 5;
+    uint16_t fitting = 0;
+
+    // The block grows with every entry, take the entries as long as both fit
+    for(uint16_t n = 1; n <= entries; n++) {
+      batchTicks[n - 1] = run_entry(run, n - 1)->tick;
+      if(n > 1) {
+        stamps += varint_size(ticks_to_delta_ms(batchTicks[n - 1] - batchTicks[n - 2],
+                                                clock->freq_hz));
+      }
+      if((stamps + varint_size(ticks_to_delta_ms(now - batchTicks[n - 1], clock->freq_hz))
+          + (n * LE_VOLTAGE_REPORT_ENTRY_SIZE)) > limit) {
+        break;
+      }
+      fitting = n;
+    }
+
+    entries = fitting;
+    if(entries == 0) {
+      return 0;
+    }
+    p += le_voltage_report_encode_timestamps(batchTicks, entries, clock, p);
+  }
+#else
+  (void)clock;
+  if(entries > limit / LE_VOLTAGE_REPORT_ENTRY_SIZE) {
+    entries = limit / LE_VOLTAGE_REPORT_ENTRY_SIZE;
+  }
+#endif
+
+  for(uint16_t i = 0; i < entries; i++) {
+    const le_voltage_monitor_summary_t *summary = run_entry(run, i);
+
+    p = le_byte_order_put_u16(p, summary->avg_mv);
+#if LE_VOLTAGE_REPORT_MIN_MAX_ENABLE
+    p = le_byte_order_put_u16(p, summary->min_mv);
+    p = le_byte_order_put_u16(p, summary->max_mv);
+#endif
+#if LE_VOLTAGE_MONITOR_SCAN_ENABLE
+    for(uint32_t ch = 1; ch < LE_VOLTAGE_MONITOR_NUM_CHANNELS; ch++) {
+      p = le_byte_order_put_u16(p, summary->channel_mv[ch]);
+    }
+#endif
+  }
+
+  *encoded = entries;
+  return (size_t)(p - buf);
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Payload size of count samples in a compressed encoding.
+ ******************************************************************************/
+static size_t compressed_size(uint8_t encoding, uint16_t count)
+{
+  switch(encoding) {
+    case LE_VOLTAGE_REPORT_HDR_DELTA4:
+      return 3 + (count / 2);
+    case LE_VOLTAGE_REPORT_HDR_DELTA8:
+      return 2 + count;
+    default:
+      return 1 + (2 * count);
+  }
+}
+
+
+#if COMPRESSED
+/***************************************************************************//**
+ * @brief
+ *    Compressed encoder for the queued summaries.
+ ******************************************************************************/
+static size_t encode_compressed(const le_voltage_report_run_t *run, uint16_t available,
+                                const le_voltage_report_clock_t *clock,
+                                uint8_t *buf, size_t limit, uint16_t *encoded)
+{
+  uint16_t avg_mv[LE_VOLTAGE_REPORT_HDR_MAX_COUNT];
+  uint16_t entries;
+  size_t len;
+
+  *encoded = 0;
+
+  if(available > LE_VOLTAGE_REPORT_HDR_MAX_COUNT) {
+    available = LE_VOLTAGE_REPORT_HDR_MAX_COUNT;
+  }
+  for(uint16_t i = 0; i < available; i++) {
+    avg_mv[i] = run_entry(run, i)->avg_mv;
+  }
+
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  if(available == 0) {
+    return 0;
+  }
+
+  {
+    uint32_t now = (uint32_t)clock->now;
+    size_t reserved = 5;
+    size_t stamps;
+    uint16_t candidates = 0;
+
+    // Candidates are the entries whose block leaves room for their samples
+    // in the best case, 4-bit deltas
+    for(uint16_t n = 1; n <= available; n++) {
+      batchTicks[n - 1] = run_entry(run, n - 1)->tick;
+      if(n > 1) {
+        reserved += varint_size(ticks_to_delta_ms(batchTicks[n - 1] - batchTicks[n - 2],
+                                                  clock->freq_hz));
+      }
+      if((reserved + varint_size(ticks_to_delta_ms(now - batchTicks[n - 1], clock->freq_hz))
+          + compressed_size(LE_VOLTAGE_REPORT_HDR_DELTA4, n)) > limit) {
+        break;
+      }
+      candidates = n;
+    }
+    if(candidates == 0) {
+      return 0;
+    }
+
+    // A shorter run never has a longer timestamp block, so the samples are
+    // encoded behind the block of all candidates and moved up afterwards
+    reserved = le_voltage_report_timestamps_size(batchTicks, candidates, clock);
+    available = candidates;
+    len = le_voltage_report_encode(avg_mv, available, buf + reserved,
+                                   limit - reserved, &entries);
+    if(entries == 0) {
+      return 0;
+    }
+
+    stamps = le_voltage_report_encode_timestamps(batchTicks, entries, clock, buf);
+    memmove(buf + stamps, buf + reserved, len);
+    len += stamps;
+  }
+#else
+  (void)clock;
+  len = le_voltage_report_encode(avg_mv, available, buf, limit, &entries);
+#endif
+
+  *encoded = entries;
+  return len;
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard all queued window summaries and fall back to the default MTU.
+ ******************************************************************************/
+void le_voltage_report_reset(void)
+{
+  ringTail = 0;
+  ringCount = 0;
+  le_voltage_report_set_mtu(LE_VOLTAGE_REPORT_DEFAULT_MTU);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the ATT MTU of the connection.
+ ******************************************************************************/
+void le_voltage_report_set_mtu(uint16_t mtu)
+{
+  uint16_t depth;
+  uint16_t limit;
+
+  payloadLimit = LE_VOLTAGE_REPORT_MAX_PAYLOAD;
+  if((mtu > ATT_NOTIFICATION_HEADER_SIZE)
+     && ((mtu - ATT_NOTIFICATION_HEADER_SIZE) < payloadLimit)) {
+    payloadLimit = mtu - ATT_NOTIFICATION_HEADER_SIZE;
+  }
+
+  // Room for the windows behind the sequence number
+  limit = payloadLimit - LE_VOLTAGE_REPORT_SEQUENCE_SIZE;
+
+#if COMPRESSED && LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  // Assume the best case, 4-bit deltas, and typical timestamp deltas. Noisier
+  // data simply leaves the entries that did not fit queued for the next
+  // notification.
+  depth = (2 * (limit - 8)) / (1 + (2 * TIMESTAMP_TYPICAL_DELTA_SIZE)) + 1;
+#elif COMPRESSED
+  // Assume the best case, 4-bit deltas. Noisier data simply leaves the
+  // entries that did not fit queued for the next notification.
+  depth = 2 * (limit - 3) + 1;
+#elif LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+  depth = (limit - 5) / (LE_VOLTAGE_REPORT_ENTRY_SIZE + TIMESTAMP_TYPICAL_DELTA_SIZE);
+#else
+  depth = limit / LE_VOLTAGE_REPORT_ENTRY_SIZE;
+#endif
+
+  if(depth > RING_SIZE) {
+    depth = RING_SIZE;
+  }
+  if(depth == 0) {
+    depth = 1;
+  }
+  batchDepth = depth;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Queue the summary of a completed window.
+ ******************************************************************************/
+bool le_voltage_report_push(const le_voltage_monitor_summary_t *summary)
+{
+  if(ringCount == RING_SIZE) {
+    // Drop the oldest summary
+    ringTail = (ringTail + 1) % RING_SIZE;
+    ringCount--;
+  }
+
+  ring[(ringTail + ringCount) % RING_SIZE] = *summary;
+  ringCount++;
+
+  return ringCount >= batchDepth;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of queued summaries.
+ ******************************************************************************/
+uint16_t le_voltage_report_get_pending(void)
+{
+  return ringCount;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a full batch is queued.
+ ******************************************************************************/
+bool le_voltage_report_ready(void)
+{
+  return ringCount >= batchDepth;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Move up to one batch of queued summaries into a notification payload.
+ ******************************************************************************/
+size_t le_voltage_report_build(uint8_t *buf, size_t size,
+                               const le_voltage_report_clock_t *clock)
+{
+  le_voltage_report_run_t run = {
+    .entries = ring,
+    .size = RING_SIZE,
+    .start = ringTail,
+    .count = (ringCount > batchDepth) ? batchDepth : ringCount,
+  };
+  uint16_t encoded;
+  size_t len;
+
+  if(size > payloadLimit) {
+    size = payloadLimit;
+  }
+
+  len = le_voltage_report_build_run(&run, clock, buf, size, &encoded);
+  ring_consume(encoded);
+  return len;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the oldest summaries of a run into a notification payload.
+ ******************************************************************************/
+size_t le_voltage_report_build_run(const le_voltage_report_run_t *run,
+                                   const le_voltage_report_clock_t *clock,
+                                   uint8_t *buf, size_t size, uint16_t *encoded)
+{
+  uint16_t count = run->count;
+  uint8_t *p = buf;
+  size_t len;
+
+  *encoded = 0;
+  if((count == 0) || (size <= LE_VOLTAGE_REPORT_SEQUENCE_SIZE)) {
+    return 0;
+  }
+
+  // The timestamps of at most one ring of windows are staged
+  if(count > RING_SIZE) {
+    count = RING_SIZE;
+  }
+
+#if LE_VOLTAGE_REPORT_SEQUENCE_ENABLE
+  count = consecutive(run, count);
+  p = le_byte_order_put_u32(p, run_entry(run, 0)->sequence);
+#endif
+
+#if COMPRESSED
+  len = encode_compressed(run, count, clock, p, size - (size_t)(p - buf), encoded);
+#else
+  len = encode_raw(run, count, clock, p, size - (size_t)(p - buf), encoded);
+#endif
+  if(len == 0) {
+    return 0;
+  }
+  return (size_t)(p - buf) + len;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Compressed encoder. Takes the longest run of averages that fits into the
+ *    payload, using the densest encoding its deltas allow.
+ ******************************************************************************/
+size_t le_voltage_report_encode(const uint16_t *avg_mv, uint16_t count,
+                                uint8_t *buf, size_t limit, uint16_t *encoded)
+{
+  uint8_t *p = buf;
+  uint8_t encoding = LE_VOLTAGE_REPORT_HDR_ABS16;
+  uint16_t entries = 0;
+  int32_t lowest = 0;
+  int32_t highest = 0;
+
+  if(count > LE_VOLTAGE_REPORT_HDR_MAX_COUNT) {
+    count = LE_VOLTAGE_REPORT_HDR_MAX_COUNT;
+  }
+
+  // Widening the run can only coarsen the encoding, so stop at the first run
+  // that does not fit.
+  for(uint16_t n = 1; n <= count; n++) {
+    uint8_t needed;
+
+    if(n > 1) {
+      int32_t delta = (int32_t)avg_mv[n - 1] - (int32_t)avg_mv[n - 2];
+      if(delta < lowest) {
+        lowest = delta;
+      }
+      if(delta > highest) {
+        highest = delta;
+      }
+    }
+
+    if((lowest >= -8) && (highest <= 7)) {
+      needed = LE_VOLTAGE_REPORT_HDR_DELTA4;
+    } else if((lowest >= -128) && (highest <= 127)) {
+      needed = LE_VOLTAGE_REPORT_HDR_DELTA8;
+    } else {
+      needed = LE_VOLTAGE_REPORT_HDR_ABS16;
+    }
+
+    if(compressed_size(needed, n) > limit) {
+      break;
+    }
+    encoding = needed;
+    entries = n;
+  }
+
+  *encoded = entries;
+  if(entries == 0) {
+    return 0;
+  }
+
+  *p++ = encoding | (uint8_t)(entries - 1);
+  p = le_byte_order_put_u16(p, avg_mv[0]);
+
+  for(uint16_t i = 1; i < entries; i++) {
+    int32_t delta = (int32_t)avg_mv[i] - (int32_t)avg_mv[i - 1];
+
+    if(encoding == LE_VOLTAGE_REPORT_HDR_ABS16) {
+      p = le_byte_order_put_u16(p, avg_mv[i]);
+    } else if(encoding == LE_VOLTAGE_REPORT_HDR_DELTA8) {
+      *p++ = (uint8_t)(int8_t)delta;
+    } else if(i & 1) {
+      // First delta of a byte goes into the high nibble
+      *p = (uint8_t)((delta & 0x0F) << 4);
+    } else {
+      *p++ |= (uint8_t)(delta & 0x0F);
+    }
+  }
+
+  // Odd number of deltas, the low nibble of the last byte stays zero
+  if((encoding == LE_VOLTAGE_REPORT_HDR_DELTA4) && ((entries - 1) & 1)) {
+    p++;
+  }
+
+  return (size_t)(p - buf);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the size of the timestamp block of a run of windows.
+ ******************************************************************************/
+size_t le_voltage_report_timestamps_size(const uint32_t *tick, uint16_t count,
+                                         const le_voltage_report_clock_t *clock)
+{
+  size_t size = 5;
+
+  for(uint16_t i = 1; i < count; i++) {
+    size += varint_size(ticks_to_delta_ms(tick[i] - tick[i - 1], clock->freq_hz));
+  }
+  return size + varint_size(ticks_to_delta_ms((uint32_t)clock->now - tick[count - 1],
+                                              clock->freq_hz));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the timestamp block of a run of windows.
+ ******************************************************************************/
+size_t le_voltage_report_encode_timestamps(const uint32_t *tick, uint16_t count,
+                                           const le_voltage_report_clock_t *clock,
+                                           uint8_t *buf)
+{
+  uint8_t *p = buf;
+  uint64_t first = clock->now - (uint32_t)((uint32_t)clock->now - tick[0]);
+
+  // The 32-bit ticks of the windows are recent, the 64-bit count of the
+  // first one follows from the current one
+  *p++ = (uint8_t)count;
+  p = le_byte_order_put_u32(p, (uint32_t)((first * 1000) / clock->freq_hz));
+
+  for(uint16_t i = 1; i < count; i++) {
+    p = put_varint(p, ticks_to_delta_ms(tick[i] - tick[i - 1], clock->freq_hz));
+  }
+  p = put_varint(p, ticks_to_delta_ms((uint32_t)clock->now - tick[count - 1],
+                                      clock->freq_hz));
+
+  return (size_t)(p - buf);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the extended statistics of a window.
+ ******************************************************************************/
+size_t le_voltage_report_build_extended(const le_voltage_monitor_summary_t *summary,
+                                        uint8_t *buf)
+{
+  uint8_t *p = buf;
+
+  p = le_byte_order_put_u16(p, summary->avg_mv);
+  p = le_byte_order_put_u16(p, summary->min_mv);
+  p = le_byte_order_put_u16(p, summary->max_mv);
+  p = le_byte_order_put_u16(p, summary->rms_mv);
+  p = le_byte_order_put_u32(p, summary->stddev_uv);
+  p = le_byte_order_put_u16(p, summary->running_mv);
+#if LE_VOLTAGE_REPORT_SEQUENCE_ENABLE
+  p = le_byte_order_put_u32(p, summary->sequence);
+#endif
+
+  return (size_t)(p - buf);
+}
@@ -0,0 +1,369 @@
+/***************************************************************************//**
+ * @file le_voltage_report.h
+ * @brief Voltage report batching interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+#ifndef LE_VOLTAGE_REPORT_H_
+#define LE_VOLTAGE_REPORT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "le_voltage_monitor.h"
+#include "le_voltage_report_config.h"
+
+/***************************************************************************//**
+ * @brief
+ *    Default ATT MTU, used until an MTU exchange completes.
+ ******************************************************************************/
+#define LE_VOLTAGE_REPORT_DEFAULT_MTU   23
+
+/***************************************************************************//**
+ * @brief
+ *    Size of one uncompressed batch entry on air in bytes: the average, the
+ *    optional minimum and maximum, then the averages of the other scan
+ *    channels.
+ ******************************************************************************/
+#if LE_VOLTAGE_REPORT_MIN_MAX_ENABLE
+#define LE_VOLTAGE_REPORT_ENTRY_SIZE    (4 + (2 * LE_VOLTAGE_MONITOR_NUM_CHANNELS))
+#else
+#define LE_VOLTAGE_REPORT_ENTRY_SIZE    (2 * LE_VOLTAGE_MONITOR_NUM_CHANNELS)
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Size of the window sequence number at the start of every payload with
+ *    LE_VOLTAGE_REPORT_SEQUENCE_ENABLE: big-endian uint32 sequence number of
+ *    its first window. The windows of a payload are numbered without a gap.
+ ******************************************************************************/
+#if LE_VOLTAGE_REPORT_SEQUENCE_ENABLE
+#define LE_VOLTAGE_REPORT_SEQUENCE_SIZE 4
+#else
+#define LE_VOLTAGE_REPORT_SEQUENCE_SIZE 0
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Size of the extended window statistics: average, minimum, maximum and
+ *    RMS in mV as big-endian uint16, the standard deviation in uV as
+ *    big-endian uint32, then the running estimate in mV as big-endian uint16
+ *    and the optional big-endian uint32 sequence number of the window.
+ ******************************************************************************/
+#define LE_VOLTAGE_REPORT_EXTENDED_SIZE (14 + LE_VOLTAGE_REPORT_SEQUENCE_SIZE)
+
+/***************************************************************************//**
+ * @brief
+ *    Compressed payload header byte. Bits 7:6 select the encoding of the
+ *    samples that follow, bits 5:0 hold the sample count minus one.
+ *
+ *    - ABS16:  count big-endian 16-bit averages
+ *    - DELTA8: big-endian 16-bit first average, then count - 1 signed 8-bit
+ *              differences to the previous average
+ *    - DELTA4: as DELTA8 with signed 4-bit differences, two per byte, high
+ *              nibble first
+ *
+ *    Encoding 3 is reserved for future format versions.
+ ******************************************************************************/
+#define LE_VOLTAGE_REPORT_HDR_ABS16          0x00
+#define LE_VOLTAGE_REPORT_HDR_DELTA8         0x40
+#define LE_VOLTAGE_REPORT_HDR_DELTA4         0x80
+#define LE_VOLTAGE_REPORT_HDR_ENCODING_MASK  0xC0
+#define LE_VOLTAGE_REPORT_HDR_COUNT_MASK     0x3F
+
+/***************************************************************************//**
+ * @brief
+ *    Largest number of samples a compressed payload can carry.
+ ******************************************************************************/
+#define LE_VOLTAGE_REPORT_HDR_MAX_COUNT      (LE_VOLTAGE_REPORT_HDR_COUNT_MASK + 1)
+
+/***************************************************************************//**
+ * @brief
+ *    Timestamp block, at the start of every payload with
+ *    LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE:
+ *
+ *    - number of windows N, one byte
+ *    - completion time of the first window in milliseconds since boot,
+ *      big-endian uint32
+ *    - N - 1 times the milliseconds between a window and the previous one
+ *    - milliseconds between the newest window and building the payload
+ *
+ *    Times after the first are unsigned varints: 7 bits per byte, least
+ *    significant first, bit 7 set if another byte follows. They are at most
+ *    3 bytes long and saturate at LE_VOLTAGE_REPORT_TIMESTAMP_MAX_DELTA_MS.
+ ******************************************************************************/
+#define LE_VOLTAGE_REPORT_TIMESTAMP_MAX_DELTA_MS   0x1FFFFF
+#define LE_VOLTAGE_REPORT_TIMESTAMP_MAX_SIZE(count) (5 + (3 * (count)))
+
+/***************************************************************************//**
+ * @brief
+ *    Largest payload built by le_voltage_report_build().
+ ******************************************************************************/
+#if !LE_VOLTAGE_REPORT_BATCHING_ENABLE
+#define LE_VOLTAGE_REPORT_MAX_ENTRIES   1
+#define LE_VOLTAGE_REPORT_SAMPLES_SIZE  LE_VOLTAGE_REPORT_ENTRY_SIZE
+#elif (LE_VOLTAGE_REPORT_FORMAT == LE_VOLTAGE_REPORT_FORMAT_COMPRESSED)
+#define LE_VOLTAGE_REPORT_MAX_ENTRIES   LE_VOLTAGE_REPORT_MAX_BATCH
+#define LE_VOLTAGE_REPORT_SAMPLES_SIZE  (1 + (LE_VOLTAGE_REPORT_MAX_BATCH * 2))
+#else
+#define LE_VOLTAGE_REPORT_MAX_ENTRIES   LE_VOLTAGE_REPORT_MAX_BATCH
+#define LE_VOLTAGE_REPORT_SAMPLES_SIZE  (LE_VOLTAGE_REPORT_MAX_BATCH * LE_VOLTAGE_REPORT_ENTRY_SIZE)
+#endif
+
+#if LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE
+#define LE_VOLTAGE_REPORT_MAX_PAYLOAD \
+  (LE_VOLTAGE_REPORT_SEQUENCE_SIZE                                         \
+   + LE_VOLTAGE_REPORT_TIMESTAMP_MAX_SIZE(LE_VOLTAGE_REPORT_MAX_ENTRIES) \
+   + LE_VOLTAGE_REPORT_SAMPLES_SIZE)
+#else
+#define LE_VOLTAGE_REPORT_MAX_PAYLOAD \
+  (LE_VOLTAGE_REPORT_SEQUENCE_SIZE + LE_VOLTAGE_REPORT_SAMPLES_SIZE)
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Time a payload is built at. Passed in by the caller, so the encoders do
+ *    not depend on the sleeptimer and can be built on a host.
+ ******************************************************************************/
+typedef struct {
+  uint64_t now;      ///< 64-bit sleeptimer tick count
+  uint32_t freq_hz;  ///< Sleeptimer tick frequency
+} le_voltage_report_clock_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Run of window summaries held in a ring buffer, oldest first.
+ ******************************************************************************/
+typedef struct {
+  const le_voltage_monitor_summary_t *entries;  ///< Ring buffer
+  uint16_t size;   ///< Entries of the ring buffer
+  uint16_t start;  ///< Index of the oldest summary of the run
+  uint16_t count;  ///< Summaries in the run
+} le_voltage_report_run_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Discard all queued window summaries and fall back to the default MTU.
+ ******************************************************************************/
+void le_voltage_report_reset(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Set the ATT MTU of the connection. The batch depth follows the largest
+ *    number of entries fitting into one notification.
+ *
+ * @param[in] mtu
+ *    Negotiated ATT MTU.
+ ******************************************************************************/
+void le_voltage_report_set_mtu(uint16_t mtu);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Queue the summary of a completed window. If the queue is full the oldest
+ *    summary is dropped.
+ *
+ * @param[in] summary
+ *    Window summary.
+ *
+ * @return
+ *    True if a full batch is ready to be built and sent.
+ ******************************************************************************/
+bool le_voltage_report_push(const le_voltage_monitor_summary_t *summary);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the number of queued summaries.
+ ******************************************************************************/
+uint16_t le_voltage_report_get_pending(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Check whether a full batch is queued, e.g. after holding windows back.
+ *
+ * @return
+ *    True if a full batch is ready to be built and sent.
+ ******************************************************************************/
+bool le_voltage_report_ready(void);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Move up to one batch of queued summaries into a notification payload.
+ *
+ * @param[out] buf
+ *    Payload buffer.
+ *
+ * @param[in] size
+ *    Size of the payload buffer.
+ *
+ * @param[in] clock
+ *    Current time, only used with LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE.
+ *
+ * @return
+ *    Length of the payload, 0 if nothing was queued.
+ ******************************************************************************/
+size_t le_voltage_report_build(uint8_t *buf, size_t size,
+                               const le_voltage_report_clock_t *clock);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the oldest summaries of a run in the notification payload
+ *    format, independent of the notification queue, e.g. to send windows
+ *    again.
+ *
+ * @details
+ *    The payload ends before the first gap in the sequence numbers.
+ *
+ * @param[in] run
+ *    Summaries to encode.
+ *
+ * @param[in] clock
+ *    Current time, only used with LE_VOLTAGE_REPORT_TIMESTAMP_ENABLE.
+ *
+ * @param[out] buf
+ *    Payload buffer.
+ *
+ * @param[in] size
+ *    Size of the payload buffer.
+ *
+ * @param[out] encoded
+ *    Number of summaries taken from the start of the run.
+ *
+ * @return
+ *    Length of the payload, 0 if not even one summary fits.
+ ******************************************************************************/
+size_t le_voltage_report_build_run(const le_voltage_report_run_t *run,
+                                   const le_voltage_report_clock_t *clock,
+                                   uint8_t *buf, size_t size, uint16_t *encoded);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode a run of averages in the compressed payload format, independent
+ *    of the notification queue.
+ *
+ * @param[in] avg_mv
+ *    Averages in millivolts, oldest first.
+ *
+ * @param[in] count
+ *    Number of averages, at most LE_VOLTAGE_REPORT_HDR_MAX_COUNT are used.
+ *
+ * @param[out] buf
+ *    Payload buffer.
+ *
+ * @param[in] limit
+ *    Size of the payload buffer.
+ *
+ * @param[out] encoded
+ *    Number of averages that fit into the payload.
+ *
+ * @return
+ *    Length of the payload, 0 if not even one average fits.
+ ******************************************************************************/
+size_t le_voltage_report_encode(const uint16_t *avg_mv, uint16_t count,
+                                uint8_t *buf, size_t limit, uint16_t *encoded);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Get the size of the timestamp block of a run of windows.
+ *
+ * @param[in] tick
+ *    Sleeptimer ticks of the window completions, oldest first.
+ *
+ * @param[in] count
+ *    Number of windows, 1 to 255.
+ *
+ * @param[in] clock
+ *    Time the block is built at.
+ *
+ * @return
+ *    Size of the block in bytes.
+ ******************************************************************************/
+size_t le_voltage_report_timestamps_size(const uint32_t *tick, uint16_t count,
+                                         const le_voltage_report_clock_t *clock);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the timestamp block of a run of windows.
+ *
+ * @param[in] tick
+ *    Sleeptimer ticks of the window completions, oldest first.
+ *
+ * @param[in] count
+ *    Number of windows, 1 to 255.
+ *
+ * @param[in] clock
+ *    Time the block is built at, the same one passed to
+ *    le_voltage_report_timestamps_size().
+ *
+ * @param[out] buf
+ *    Payload buffer, at least LE_VOLTAGE_REPORT_TIMESTAMP_MAX_SIZE(count)
+ *    bytes.
+ *
+ * @return
+ *    Length of the block.
+ ******************************************************************************/
+size_t le_voltage_report_encode_timestamps(const uint32_t *tick, uint16_t count,
+                                           const le_voltage_report_clock_t *clock,
+                                           uint8_t *buf);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Encode the extended statistics of a window.
+ *
+ * @param[in] summary
+ *    Window summary.
+ *
+ * @param[out] buf
+ *    LE_VOLTAGE_REPORT_EXTENDED_SIZE bytes.
+ *
+ * @return
+ *    Length of the payload.
+ ******************************************************************************/
+size_t le_voltage_report_build_extended(const le_voltage_monitor_summary_t *summary,
+                                        uint8_t *buf);
+
+#endif /* LE_VOLTAGE_REPORT_H_ */
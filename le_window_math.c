@@ -0,0 +1,288 @@
+/***************************************************************************//**
+* @file le_window_math.c
+* @brief Hardware independent window arithmetic definitions
+* @version 1.0
+*******************************************************************************
+* # License
+* <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+*******************************************************************************
+*
+* SPDX-License-Identifier: Zlib
+*
+* The licensor of this software is Silicon Laboratories Inc.
+*
+* This software is provided \'as-is\', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+*
+* 1. The origin of this software must not be misrepresented; you must not
+*    claim that you wrote the original software. If you use this software
+*    in a product, an acknowledgment in the product documentation would be
+*    appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+*    misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*
+*******************************************************************************
+* # Experimental Quality
+* This code has not been formally tested and is provided as-is. It is not
+* suitable for production environments. In addition, this code will not be
+* maintained and there may be no bug maintenance planned for these resources.
+* Silicon Labs may update projects from time to time.
+******************************************************************************/
+
+#include "le_window_math.h"
+#include <stdint.h>
+#include <stdbool.h>
+#if LE_WINDOW_MATH_PACKED_AVAILABLE
+#include "cmsis_compiler.h"
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Calculate the factor turning a code, or the sum of count codes, into
+ *    millivolts.
+ ******************************************************************************/
+uint32_t le_window_math_scale_factor(uint32_t range_mv, uint32_t full_scale,
+                                     uint32_t count)
+{
+  uint64_t divisor = (uint64_t)full_scale * count;
+
+  return (uint32_t)((((uint64_t)range_mv << LE_WINDOW_MATH_SCALE_SHIFT)
+                     + (divisor / 2)) / divisor);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Apply a scale factor, rounded to nearest.
+ ******************************************************************************/
+uint16_t le_window_math_scale(uint32_t value, uint32_t factor)
+{
+  return (uint16_t)(((uint64_t)value * factor
+                     + (1UL << (LE_WINDOW_MATH_SCALE_SHIFT - 1))) >> LE_WINDOW_MATH_SCALE_SHIFT);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Integer square root, rounded down.
+ ******************************************************************************/
+uint32_t le_window_math_isqrt64(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+
+  while(bit > value) {
+    bit >>= 2;
+  }
+  while(bit != 0) {
+    if(value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Sum, sum of squares, minimum and maximum of every stride-th sample.
+ ******************************************************************************/
+void le_window_math_reduce(const uint16_t *samples, uint32_t count,
+                           uint32_t stride, le_window_stats_t *stats)
+{
+  uint32_t sum = 0;
+  uint64_t sum_sq = 0;
+  uint32_t min = UINT32_MAX;
+  uint32_t max = 0;
+
+  for(uint32_t i = 0; i < count; i++) {
+    uint32_t sample = samples[i * stride];
+
+    // A single multiply-accumulate long per sample on top of the average
+    sum += sample;
+    sum_sq += (uint64_t)sample * sample;
+    if(sample < min) {
+      min = sample;
+    }
+    if(sample > max) {
+      max = sample;
+    }
+  }
+
+  stats->count = count;
+  stats->sum = sum;
+  stats->sum_sq = sum_sq;
+  stats->min = min;
+  stats->max = max;
+}
+
+
+#if LE_WINDOW_MATH_PACKED_AVAILABLE
+/***************************************************************************//**
+ * @brief
+ *    Same as le_window_math_reduce() for adjacent samples, two per load.
+ ******************************************************************************/
+void le_window_math_reduce_packed(const uint16_t *samples, uint32_t count,
+                                  le_window_stats_t *stats)
+{
+  const uint32_t *pairs = (const uint32_t *)samples;
+  uint32_t sum = 0;
+  uint64_t sum_sq = 0;
+  uint32_t pair_min = UINT32_MAX;
+  uint32_t pair_max = 0;
+  uint32_t min;
+  uint32_t max;
+
+  // Two samples per load, low halfword first. USUB16 sets the GE flags of
+  // the halfwords at or above the running extremes, SEL picks per halfword.
+  for(uint32_t i = 0; i < (count / 2); i++) {
+    uint32_t pair = pairs[i];
+
+    sum = __SMLAD(pair, 0x00010001, sum);
+    sum_sq = __SMLALD(pair, pair, sum_sq);
+    (void)__USUB16(pair, pair_min);
+    pair_min = __SEL(pair_min, pair);
+    (void)__USUB16(pair, pair_max);
+    pair_max = __SEL(pair, pair_max);
+  }
+
+  min = pair_min & 0xFFFF;
+  if((pair_min >> 16) < min) {
+    min = pair_min >> 16;
+  }
+  max = pair_max & 0xFFFF;
+  if((pair_max >> 16) > max) {
+    max = pair_max >> 16;
+  }
+
+  // An odd sample is left over
+  if(count & 1) {
+    uint32_t sample = samples[count - 1];
+
+    sum += sample;
+    sum_sq += (uint64_t)sample * sample;
+    if(sample < min) {
+      min = sample;
+    }
+    if(sample > max) {
+      max = sample;
+    }
+  }
+
+  stats->count = count;
+  stats->sum = sum;
+  stats->sum_sq = sum_sq;
+  stats->min = min;
+  stats->max = max;
+}
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Shift the window statistics by an offset.
+ ******************************************************************************/
+void le_window_math_remove_offset(le_window_stats_t *stats, uint32_t offset)
+{
+  uint64_t n_offset = (uint64_t)stats->count * offset;
+
+  // Sum of (x - offset)^2, the unsigned terms wrap back to the positive result
+  stats->sum_sq = stats->sum_sq + (n_offset * offset) - (2 * (uint64_t)offset * stats->sum);
+  stats->sum = (stats->sum > n_offset) ? (uint32_t)(stats->sum - n_offset) : 0;
+  stats->min = (stats->min > offset) ? stats->min - offset : 0;
+  stats->max = (stats->max > offset) ? stats->max - offset : 0;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Root mean square of a window in millivolts.
+ ******************************************************************************/
+uint16_t le_window_math_rms_mv(const le_window_stats_t *stats,
+                               uint32_t range_mv, uint32_t full_scale)
+{
+  uint64_t n = stats->count;
+  uint64_t scale = n * full_scale;
+
+  // RMS = sqrt(sum_sq / n) in codes. The square root is taken before the
+  // division by n to keep the fraction of a code.
+  return (uint16_t)(((uint64_t)le_window_math_isqrt64(n * stats->sum_sq) * range_mv
+                     + (scale / 2)) / scale);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Standard deviation of a window in microvolts.
+ ******************************************************************************/
+uint32_t le_window_math_stddev_uv(const le_window_stats_t *stats,
+                                  uint32_t range_mv, uint32_t full_scale)
+{
+  uint64_t n = stats->count;
+  uint64_t scale = n * full_scale;
+  uint64_t variance_n2 = (n * stats->sum_sq) - ((uint64_t)stats->sum * stats->sum);
+
+  // Deviation = sqrt(n * sum_sq - sum^2) / n in codes
+  return (uint32_t)(((uint64_t)le_window_math_isqrt64(variance_n2) * range_mv * 1000
+                     + (scale / 2)) / scale);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Low-pass filter and decimate every stride-th sample in place.
+ ******************************************************************************/
+uint32_t le_window_math_fir_decimate(uint16_t *samples, uint32_t count,
+                                     uint32_t stride, const uint16_t *taps,
+                                     uint32_t num_taps, uint32_t gain,
+                                     uint32_t decimation, uint32_t fraction_bits,
+                                     uint32_t *sum)
+{
+  uint32_t outputs = 0;
+
+  *sum = 0;
+  for(uint32_t start = 0; (start + num_taps) <= count; start += decimation) {
+    uint32_t acc = 0;
+
+    for(uint32_t k = 0; k < num_taps; k++) {
+      acc += (uint32_t)taps[k] * samples[(start + k) * stride];
+    }
+    acc = ((acc << fraction_bits) + (gain / 2)) / gain;
+
+    samples[outputs * stride] = (uint16_t)acc;
+    *sum += acc;
+    outputs++;
+  }
+  return outputs;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *    Feed a value to a single-pole IIR low-pass.
+ ******************************************************************************/
+uint16_t le_window_math_iir_update(le_window_iir_t *iir, uint16_t value,
+                                   uint32_t shift)
+{
+  int32_t target = (int32_t)value << LE_WINDOW_MATH_IIR_FRACTION_BITS;
+
+  if(!iir->valid) {
+    iir->value = target;
+    iir->valid = true;
+  } else {
+    iir->value += (target - iir->value) >> shift;
+  }
+  return (uint16_t)((iir->value + (1 << (LE_WINDOW_MATH_IIR_FRACTION_BITS - 1)))
+                    >> LE_WINDOW_MATH_IIR_FRACTION_BITS);
+}
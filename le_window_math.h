@@ -0,0 +1,285 @@
+/***************************************************************************//**
+ * @file le_window_math.h
+ * @brief Hardware independent window arithmetic interface
+ * @version 1.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2020 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided \'as-is\', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ *******************************************************************************
+ * # Experimental Quality
+ * This code has not been formally tested and is provided as-is. It is not
+ * suitable for production environments. In addition, this code will not be
+ * maintained and there may be no bug maintenance planned for these resources.
+ * Silicon Labs may update projects from time to time.
+ ******************************************************************************/
+
+
+
+#ifndef LE_WINDOW_MATH_H_
+#define LE_WINDOW_MATH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/***************************************************************************//**
+ * @brief
+ *    Fraction bits of the fixed-point factors turning raw ADC codes or code
+ *    sums into millivolts.
+ ******************************************************************************/
+#define LE_WINDOW_MATH_SCALE_SHIFT      24
+
+/***************************************************************************//**
+ * @brief
+ *    Fraction bits of the single-pole IIR state.
+ ******************************************************************************/
+#define LE_WINDOW_MATH_IIR_FRACTION_BITS  8
+
+/***************************************************************************//**
+ * @brief
+ *    The packed reduction needs the DSP extension of the Cortex-M33.
+ ******************************************************************************/
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define LE_WINDOW_MATH_PACKED_AVAILABLE   1
+#else
+#define LE_WINDOW_MATH_PACKED_AVAILABLE   0
+#endif
+
+/***************************************************************************//**
+ * @brief
+ *    Sums and extremes of the raw codes of one window.
+ ******************************************************************************/
+typedef struct {
+  uint32_t count;   ///< Number of samples
+  uint32_t sum;     ///< Sum of the codes
+  uint64_t sum_sq;  ///< Sum of the squared codes
+  uint32_t min;     ///< Lowest code
+  uint32_t max;     ///< Highest code
+} le_window_stats_t;
+
+/***************************************************************************//**
+ * @brief
+ *    Single-pole IIR low-pass state.
+ ******************************************************************************/
+typedef struct {
+  int32_t value;  ///< Output in LE_WINDOW_MATH_IIR_FRACTION_BITS fixed point
+  bool valid;     ///< Set by the first input
+} le_window_iir_t;
+
+
+/***************************************************************************//**
+ * @brief
+ *    Calculate the factor turning a code, or the sum of count codes, into
+ *    millivolts, range_mv / (full_scale * count) in
+ *    LE_WINDOW_MATH_SCALE_SHIFT fixed point, rounded to nearest.
+ *
+ * @param[in] range_mv
+ *    Input voltage at full scale.
+ *
+ * @param[in] full_scale
+ *    Highest code.
+ *
+ * @param[in] count
+ *    Number of codes summed up, 1 for a single code.
+ *
+ * @return
+ *    Scale factor.
+ ******************************************************************************/
+uint32_t le_window_math_scale_factor(uint32_t range_mv, uint32_t full_scale,
+                                     uint32_t count);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Apply a scale factor of le_window_math_scale_factor(), rounded to
+ *    nearest.
+ ******************************************************************************/
+uint16_t le_window_math_scale(uint32_t value, uint32_t factor);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Integer square root, rounded down.
+ ******************************************************************************/
+uint32_t le_window_math_isqrt64(uint64_t value);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Sum, sum of squares, minimum and maximum of every stride-th sample in a
+ *    single pass.
+ *
+ * @param[in] samples
+ *    First sample.
+ *
+ * @param[in] count
+ *    Number of samples, at least 1.
+ *
+ * @param[in] stride
+ *    Distance between two samples, the number of interleaved channels.
+ *
+ * @param[out] stats
+ *    Window sums and extremes.
+ ******************************************************************************/
+void le_window_math_reduce(const uint16_t *samples, uint32_t count,
+                           uint32_t stride, le_window_stats_t *stats);
+
+
+#if LE_WINDOW_MATH_PACKED_AVAILABLE
+/***************************************************************************//**
+ * @brief
+ *    Same as le_window_math_reduce() for adjacent samples, two per 32-bit
+ *    load with the dual 16-bit DSP instructions.
+ *
+ * @note
+ *    The samples must be word aligned and below 0x8000, the dual
+ *    multiply-accumulates are signed.
+ ******************************************************************************/
+void le_window_math_reduce_packed(const uint16_t *samples, uint32_t count,
+                                  le_window_stats_t *stats);
+#endif
+
+
+/***************************************************************************//**
+ * @brief
+ *    Shift the sums and extremes of a window as if an offset had been
+ *    subtracted from every code.
+ *
+ * @note
+ *    The sum of squares stays exact, the sum and the extremes saturate at 0
+ *    for codes below the offset.
+ *
+ * @param[in,out] stats
+ *    Window sums of le_window_math_reduce().
+ *
+ * @param[in] offset
+ *    Code subtracted from every sample.
+ ******************************************************************************/
+void le_window_math_remove_offset(le_window_stats_t *stats, uint32_t offset);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Root mean square of a window in millivolts, rounded to nearest.
+ *
+ * @param[in] stats
+ *    Window sums of le_window_math_reduce().
+ *
+ * @param[in] range_mv
+ *    Input voltage at full scale.
+ *
+ * @param[in] full_scale
+ *    Highest code.
+ ******************************************************************************/
+uint16_t le_window_math_rms_mv(const le_window_stats_t *stats,
+                               uint32_t range_mv, uint32_t full_scale);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Standard deviation of a window in microvolts, rounded to nearest.
+ *
+ * @param[in] stats
+ *    Window sums of le_window_math_reduce().
+ *
+ * @param[in] range_mv
+ *    Input voltage at full scale.
+ *
+ * @param[in] full_scale
+ *    Highest code.
+ ******************************************************************************/
+uint32_t le_window_math_stddev_uv(const le_window_stats_t *stats,
+                                  uint32_t range_mv, uint32_t full_scale);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Low-pass filter and decimate every stride-th sample in place with an
+ *    integer FIR kernel.
+ *
+ * @details
+ *    Every output covers num_taps consecutive samples and the kernels start
+ *    decimation samples apart. Output j is written to sample j, which no
+ *    later kernel reads any more. The outputs are normalized by gain and keep
+ *    fraction_bits bits of fraction.
+ *
+ * @param[in,out] samples
+ *    First sample.
+ *
+ * @param[in] count
+ *    Number of samples.
+ *
+ * @param[in] stride
+ *    Distance between two samples.
+ *
+ * @param[in] taps
+ *    Kernel.
+ *
+ * @param[in] num_taps
+ *    Length of the kernel.
+ *
+ * @param[in] gain
+ *    Sum of the taps.
+ *
+ * @param[in] decimation
+ *    Samples per output, at least 1.
+ *
+ * @param[in] fraction_bits
+ *    Fraction bits of the outputs. They have to fit into 16 bits, and the
+ *    accumulator of gain times the highest code into 32 bits.
+ *
+ * @param[out] sum
+ *    Sum of the outputs.
+ *
+ * @return
+ *    Number of outputs, 0 if there are fewer samples than taps.
+ ******************************************************************************/
+uint32_t le_window_math_fir_decimate(uint16_t *samples, uint32_t count,
+                                     uint32_t stride, const uint16_t *taps,
+                                     uint32_t num_taps, uint32_t gain,
+                                     uint32_t decimation, uint32_t fraction_bits,
+                                     uint32_t *sum);
+
+
+/***************************************************************************//**
+ * @brief
+ *    Feed a value to a single-pole IIR low-pass, y += (x - y) * 2^-shift.
+ *    The first value sets the output.
+ *
+ * @param[in,out] iir
+ *    Filter state.
+ *
+ * @param[in] value
+ *    Input.
+ *
+ * @param[in] shift
+ *    Smoothing, 0 passes the input through.
+ *
+ * @return
+ *    Output, rounded to nearest.
+ ******************************************************************************/
+uint16_t le_window_math_iir_update(le_window_iir_t *iir, uint16_t value,
+                                   uint32_t shift);
+
+#endif /* LE_WINDOW_MATH_H_ */